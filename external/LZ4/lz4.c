@@ -0,0 +1,210 @@
+
+/**
+ * `lz4.c' - minimal LZ4 block codec
+ *
+ * A block is a series of sequences. Each sequence starts with a token whose
+ * high nibble is the literal length and low nibble the match length minus 4,
+ * followed by extra length bytes (when a nibble is 15), the literals, a two
+ * byte little endian match offset and extra match length bytes. The last
+ * sequence only contains literals.
+ */
+
+#include <string.h>
+#include "lz4.h"
+
+#define LZ4_MINMATCH 4
+#define LZ4_LASTLITERALS 5
+#define LZ4_MFLIMIT 12
+#define LZ4_MAX_DISTANCE 65535
+#define LZ4_HASH_LOG 12
+#define LZ4_SKIP_TRIGGER 6
+
+static unsigned int
+lz4_read32 (const unsigned char *p) {
+  unsigned int v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static unsigned int
+lz4_hash (unsigned int v) {
+  return (v * 2654435761U) >> (32 - LZ4_HASH_LOG);
+}
+
+static unsigned char *
+lz4_write_length (unsigned char *op, size_t len) {
+  while (len >= 255) {
+    *op++ = 255;
+    len -= 255;
+  }
+  *op++ = (unsigned char) len;
+  return op;
+}
+
+static unsigned char *
+lz4_write_literals (unsigned char *op, const unsigned char *lit, size_t len) {
+  unsigned char *token = op++;
+  // literal length goes in the high nibble
+  if (len >= 15) {
+    *token = 15 << 4;
+    op = lz4_write_length(op, len - 15);
+  } else {
+    *token = (unsigned char) (len << 4);
+  }
+  memcpy(op, lit, len);
+  return op + len;
+}
+
+int
+lz4_compress_bound (int size) {
+  if (size < 0 || size > LZ4_MAX_INPUT_SIZE) { return 0; }
+  return size + (size / 255) + 16;
+}
+
+int
+lz4_compress (const char *src, char *dst, int src_size, int dst_capacity) {
+  const unsigned char *base = (const unsigned char *) src;
+  const unsigned char *ip = base;
+  const unsigned char *anchor = base;
+  const unsigned char *iend = base + src_size;
+  unsigned char *op = (unsigned char *) dst;
+  unsigned int table[1 << LZ4_HASH_LOG];
+  unsigned int misses = 0;
+
+  // the destination must be able to hold the worst case
+  if (NULL == src || NULL == dst) { return 0; }
+  if (dst_capacity < lz4_compress_bound(src_size) || 0 == lz4_compress_bound(src_size)) { return 0; }
+
+  // inputs too small to contain a match are stored as literals
+  if (src_size > LZ4_MFLIMIT) {
+    const unsigned char *mflimit = iend - LZ4_MFLIMIT;
+    const unsigned char *matchlimit = iend - LZ4_LASTLITERALS;
+
+    memset(table, 0, sizeof(table));
+
+    while (ip < mflimit) {
+      const unsigned int seq = lz4_read32(ip);
+      const unsigned int h = lz4_hash(seq);
+      const unsigned char *ref = base + table[h];
+      table[h] = (unsigned int) (ip - base);
+
+      // no usable match at this position
+      if (ref >= ip || (ip - ref) > LZ4_MAX_DISTANCE || lz4_read32(ref) != seq) {
+        // skip faster through data that does not compress
+        ip += 1 + (misses++ >> LZ4_SKIP_TRIGGER);
+        continue;
+      }
+      misses = 0;
+
+      // extend the match backwards over pending literals
+      while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+        --ip;
+        --ref;
+      }
+
+      // extend the match forwards
+      const unsigned char *mp = ip + LZ4_MINMATCH;
+      const unsigned char *rp = ref + LZ4_MINMATCH;
+      while (mp < matchlimit && *mp == *rp) {
+        ++mp;
+        ++rp;
+      }
+
+      // emit the pending literals followed by the match
+      unsigned char *token = op;
+      op = lz4_write_literals(op, anchor, (size_t) (ip - anchor));
+
+      const size_t offset = (size_t) (ip - ref);
+      *op++ = (unsigned char) (offset & 0xFF);
+      *op++ = (unsigned char) (offset >> 8);
+
+      const size_t mlen = (size_t) (mp - ip) - LZ4_MINMATCH;
+      if (mlen >= 15) {
+        *token |= 15;
+        op = lz4_write_length(op, mlen - 15);
+      } else {
+        *token |= (unsigned char) mlen;
+      }
+
+      ip = mp;
+      anchor = ip;
+
+      // remember a position inside the match to improve the next search
+      if (ip < mflimit) {
+        table[lz4_hash(lz4_read32(ip - 2))] = (unsigned int) (ip - 2 - base);
+      }
+    }
+  }
+
+  // the last sequence holds the remaining literals
+  op = lz4_write_literals(op, anchor, (size_t) (iend - anchor));
+
+  return (int) (op - (unsigned char *) dst);
+}
+
+int
+lz4_decompress (const char *src, char *dst, int src_size, int dst_capacity) {
+  const unsigned char *ip = (const unsigned char *) src;
+  const unsigned char *iend = ip + src_size;
+  unsigned char *op = (unsigned char *) dst;
+  unsigned char *oend = op + dst_capacity;
+
+  if (NULL == src || src_size <= 0 || dst_capacity < 0) { return -1; }
+  if (NULL == dst && dst_capacity > 0) { return -1; }
+
+  for (;;) {
+    // a stream that ends on a match is truncated
+    if (ip >= iend) { return -1; }
+    const unsigned int token = *ip++;
+    size_t len = token >> 4;
+    unsigned int s;
+
+    // literal length
+    if (15 == len) {
+      do {
+        if (ip >= iend) { return -1; }
+        s = *ip++;
+        len += s;
+      } while (255 == s);
+    }
+    if (len > (size_t) (iend - ip) || len > (size_t) (oend - op)) { return -1; }
+
+    memcpy(op, ip, len);
+    op += len;
+    ip += len;
+
+    // the last sequence has no match
+    if (ip == iend) { break; }
+
+    // match offset
+    if (iend - ip < 2) { return -1; }
+    const size_t offset = (size_t) ip[0] | ((size_t) ip[1] << 8);
+    ip += 2;
+    if (0 == offset || offset > (size_t) (op - (unsigned char *) dst)) { return -1; }
+
+    // match length
+    len = token & 15;
+    if (15 == len) {
+      do {
+        if (ip >= iend) { return -1; }
+        s = *ip++;
+        len += s;
+      } while (255 == s);
+    }
+    len += LZ4_MINMATCH;
+    if (len > (size_t) (oend - op)) { return -1; }
+
+    // the match may overlap the output so copy it byte by byte when needed
+    const unsigned char *match = op - offset;
+    if (offset >= len) {
+      memcpy(op, match, len);
+      op += len;
+    } else {
+      while (len--) {
+        *op++ = *match++;
+      }
+    }
+  }
+
+  return (int) (op - (unsigned char *) dst);
+}
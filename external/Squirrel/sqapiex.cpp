@@ -66,3 +66,13 @@ SQRESULT sq_getnativeclosurepointer(HSQUIRRELVM v,SQInteger idx,SQFUNCTION *f)
     }
     return sq_throwerror(v,_SC("the object is not a native closure"));
 }
+
+SQDEBUGHOOK sq_getnativedebughook(HSQUIRRELVM v)
+{
+    return v->_debughook_native;
+}
+
+void sq_getdebughook(HSQUIRRELVM v)
+{
+    v->Push(v->_debughook_closure);
+}
@@ -3,9 +3,364 @@
 */
 #include "sqpcheader.h"
 #ifndef SQ_EXCLUDE_DEFAULT_MEMFUNCTIONS
-void *sq_vm_malloc(SQUnsignedInteger size){ return malloc(size); }
+#include <squirrelex.h>
+#include <atomic>
+#include <mutex>
 
-void *sq_vm_realloc(void *p, SQUnsignedInteger SQ_UNUSED_ARG(oldsize), SQUnsignedInteger size){ return realloc(p, size); }
+/*
+    Optional pooled allocator. Blocks up to SQ_POOL_MAXSIZE bytes are grouped in classes of
+    SQ_POOL_GRANULARITY bytes and served from free lists owned by each thread, which are refilled
+    from chunks of SQ_POOL_CHUNKSIZE bytes. The class of a block is found from the size that the
+    virtual machine passes when it's reallocated or released, so no header is stored with it.
+    Chunks are kept until the process ends. The free lists of a thread that ends are moved to a
+    shared depot so other threads can use them.
+
+    Statistics are kept either way, in counters owned by each thread. Only the owner changes them,
+    with plain loads and stores, so counting an allocation costs no more than a few additions. They
+    are summed when read. A block released by another thread than the one which allocated it makes
+    the counters of each thread inaccurate, but not their sum.
+*/
+#define SQ_POOL_GRANULARITY 16
+#define SQ_POOL_MAXSIZE 256
+#define SQ_POOL_CLASSES (SQ_POOL_MAXSIZE / SQ_POOL_GRANULARITY)
+#define SQ_POOL_CHUNKSIZE 65536
+#define SQ_POOL_LARGE SQ_POOL_CLASSES
+#define SQ_POOL_TOTAL (SQ_POOL_CLASSES + 1)
+#define SQ_POOL_COUNTERS (SQ_POOL_CLASSES + 2)
+
+struct SQPoolBlock { SQPoolBlock *_next; };
+
+struct SQPoolCounters
+{
+    std::atomic<SQInteger> _blocks;
+    std::atomic<SQInteger> _bytes;
+    std::atomic<SQInteger> _peak;
+    std::atomic<SQUnsignedInteger> _allocs;
+    std::atomic<SQUnsignedInteger> _allocated;
+};
+
+struct SQPoolSum
+{
+    SQInteger _blocks;
+    SQInteger _bytes;
+    SQInteger _peak;
+    SQUnsignedInteger _allocs;
+    SQUnsignedInteger _allocated;
+};
+
+struct SQPoolCache
+{
+    SQPoolBlock *_free[SQ_POOL_CLASSES];
+    SQPoolCounters _counters[SQ_POOL_COUNTERS];
+    SQPoolCache *_prev;
+    SQPoolCache *_next;
+    bool _counting;
+    bool _flushed;
+};
+
+struct SQPoolDepot
+{
+    std::mutex _mutex;
+    SQPoolBlock *_free[SQ_POOL_CLASSES];
+    SQPoolSum _ended[SQ_POOL_COUNTERS]; // Counters of the threads that ended
+    SQPoolCache *_threads; // Threads whose counters are still owned by them
+    bool _started; // Whether the virtual machine allocated anything yet
+};
+
+struct SQPoolGuard
+{
+    ~SQPoolGuard();
+};
+
+static bool g_PoolEnabled = false;
+static std::atomic<SQUnsignedInteger> g_PoolReserved[SQ_POOL_COUNTERS];
+static SQPoolDepot g_PoolDepot;
+static thread_local SQPoolCache g_PoolCache; // Trivially destructible so it's usable while the thread ends
+static thread_local SQPoolGuard g_PoolGuard;
+
+static inline SQUnsignedInteger sq_pool_class(SQUnsignedInteger size)
+{
+    return size > SQ_POOL_MAXSIZE ? SQ_POOL_LARGE : (size ? (size - 1) / SQ_POOL_GRANULARITY : 0);
+}
+
+template <typename T> static inline void sq_pool_add(std::atomic<T> &c, T value)
+{
+    // Only the owner thread changes the counter, so it doesn't need to be atomic
+    c.store(c.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+static inline void sq_pool_raise(SQPoolCounters &c, SQInteger size)
+{
+    const SQInteger bytes = c._bytes.load(std::memory_order_relaxed) + size;
+    c._bytes.store(bytes, std::memory_order_relaxed);
+    if(bytes > c._peak.load(std::memory_order_relaxed)) c._peak.store(bytes, std::memory_order_relaxed);
+}
+
+static inline void sq_pool_count(SQPoolCounters &c, SQUnsignedInteger size)
+{
+    sq_pool_raise(c, (SQInteger)size);
+    sq_pool_add<SQInteger>(c._blocks, 1);
+    sq_pool_add<SQUnsignedInteger>(c._allocs, 1);
+    sq_pool_add<SQUnsignedInteger>(c._allocated, size);
+}
+
+static inline void sq_pool_uncount(SQPoolCounters &c, SQUnsignedInteger size)
+{
+    sq_pool_add<SQInteger>(c._blocks, -1);
+    sq_pool_add<SQInteger>(c._bytes, -(SQInteger)size);
+}
+
+static void sq_pool_fold(SQPoolSum &sum, const SQPoolCounters &c)
+{
+    sum._blocks += c._blocks.load(std::memory_order_relaxed);
+    sum._bytes += c._bytes.load(std::memory_order_relaxed);
+    sum._allocs += c._allocs.load(std::memory_order_relaxed);
+    sum._allocated += c._allocated.load(std::memory_order_relaxed);
+    const SQInteger peak = c._peak.load(std::memory_order_relaxed);
+    if(peak > sum._peak) sum._peak = peak;
+}
+
+static inline SQPoolCache &sq_pool_cache()
+{
+    // Look up the storage of the thread only once per call since it's costly in a shared library
+    SQPoolCache *pcache = &g_PoolCache;
+#if defined(__GNUC__)
+    // Otherwise the compiler looks it up again wherever it's used
+    __asm__("" : "+r"(pcache));
+#endif
+    SQPoolCache &cache = *pcache;
+    if(!cache._counting) {
+        std::lock_guard<std::mutex> lock(g_PoolDepot._mutex);
+        cache._next = g_PoolDepot._threads;
+        if(cache._next) cache._next->_prev = &cache;
+        g_PoolDepot._threads = &cache;
+        g_PoolDepot._started = true;
+        cache._counting = true;
+        // Make sure the thread hands over its counters when it ends
+        (void)&g_PoolGuard;
+    }
+    return cache;
+}
+
+static void sq_pool_countended(SQUnsignedInteger size, bool alloc)
+{
+    SQPoolCounters c = {}, t = {};
+    if(alloc) {
+        sq_pool_count(c, size);
+        sq_pool_raise(t, (SQInteger)size);
+    }
+    else {
+        sq_pool_uncount(c, size);
+        sq_pool_add<SQInteger>(t._bytes, -(SQInteger)size);
+    }
+    std::lock_guard<std::mutex> lock(g_PoolDepot._mutex);
+    sq_pool_fold(g_PoolDepot._ended[sq_pool_class(size)], c);
+    sq_pool_fold(g_PoolDepot._ended[SQ_POOL_TOTAL], t);
+}
+
+static inline void sq_pool_onalloc(SQPoolCache &cache, SQUnsignedInteger size)
+{
+    // Were the counters of this thread already handed over?
+    if(cache._flushed) {
+        sq_pool_countended(size, true);
+        return;
+    }
+    sq_pool_count(cache._counters[sq_pool_class(size)], size);
+    // The other totals are summed from the classes when read
+    sq_pool_raise(cache._counters[SQ_POOL_TOTAL], (SQInteger)size);
+}
+
+static inline void sq_pool_onfree(SQPoolCache &cache, SQUnsignedInteger size)
+{
+    if(cache._flushed) {
+        sq_pool_countended(size, false);
+        return;
+    }
+    sq_pool_uncount(cache._counters[sq_pool_class(size)], size);
+    sq_pool_add<SQInteger>(cache._counters[SQ_POOL_TOTAL]._bytes, -(SQInteger)size);
+}
+
+static SQPoolBlock *sq_pool_refill(SQUnsignedInteger cls)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_PoolDepot._mutex);
+        SQPoolBlock *list = g_PoolDepot._free[cls];
+        if(list) {
+            g_PoolDepot._free[cls] = NULL;
+            return list;
+        }
+    }
+    char *chunk = (char *)malloc(SQ_POOL_CHUNKSIZE);
+    if(!chunk) return NULL;
+    const SQUnsignedInteger bsize = (cls + 1) * SQ_POOL_GRANULARITY;
+    const SQUnsignedInteger count = SQ_POOL_CHUNKSIZE / bsize;
+    for(SQUnsignedInteger i = 0; i < count - 1; ++i) {
+        ((SQPoolBlock *)(chunk + i * bsize))->_next = (SQPoolBlock *)(chunk + (i + 1) * bsize);
+    }
+    ((SQPoolBlock *)(chunk + (count - 1) * bsize))->_next = NULL;
+    g_PoolReserved[cls].fetch_add(SQ_POOL_CHUNKSIZE, std::memory_order_relaxed);
+    g_PoolReserved[SQ_POOL_TOTAL].fetch_add(SQ_POOL_CHUNKSIZE, std::memory_order_relaxed);
+    return (SQPoolBlock *)chunk;
+}
+
+static void sq_pool_release(SQUnsignedInteger cls, SQPoolBlock *head)
+{
+    SQPoolBlock *tail = head;
+    while(tail->_next) tail = tail->_next;
+    std::lock_guard<std::mutex> lock(g_PoolDepot._mutex);
+    tail->_next = g_PoolDepot._free[cls];
+    g_PoolDepot._free[cls] = head;
+}
+
+SQPoolGuard::~SQPoolGuard()
+{
+    SQPoolCache &cache = g_PoolCache;
+    for(SQUnsignedInteger cls = 0; cls < SQ_POOL_CLASSES; ++cls) {
+        if(!cache._free[cls]) continue;
+        sq_pool_release(cls, cache._free[cls]);
+        cache._free[cls] = NULL;
+    }
+    // Hand over the counters to the depot
+    if(cache._counting) {
+        std::lock_guard<std::mutex> lock(g_PoolDepot._mutex);
+        for(SQUnsignedInteger idx = 0; idx < SQ_POOL_COUNTERS; ++idx) {
+            sq_pool_fold(g_PoolDepot._ended[idx], cache._counters[idx]);
+        }
+        if(cache._prev) cache._prev->_next = cache._next;
+        else g_PoolDepot._threads = cache._next;
+        if(cache._next) cache._next->_prev = cache._prev;
+    }
+    // Blocks released from now on go straight to the depot
+    cache._flushed = true;
+}
+
+static inline void *sq_pool_alloc(SQPoolCache &cache, SQUnsignedInteger cls)
+{
+    SQPoolBlock *block = cache._free[cls];
+    if(!block) {
+        block = sq_pool_refill(cls);
+        if(!block) return NULL;
+    }
+    cache._free[cls] = block->_next;
+    if(cache._flushed && cache._free[cls]) {
+        sq_pool_release(cls, cache._free[cls]);
+        cache._free[cls] = NULL;
+    }
+    return block;
+}
+
+static inline void sq_pool_free(SQPoolCache &cache, void *p, SQUnsignedInteger cls)
+{
+    SQPoolBlock *block = (SQPoolBlock *)p;
+    if(cache._flushed) {
+        block->_next = NULL;
+        sq_pool_release(cls, block);
+        return;
+    }
+    block->_next = cache._free[cls];
+    cache._free[cls] = block;
+}
+
+void *sq_vm_malloc(SQUnsignedInteger size)
+{
+    SQPoolCache &cache = sq_pool_cache();
+    sq_pool_onalloc(cache, size);
+    if(!g_PoolEnabled) return malloc(size);
+    const SQUnsignedInteger cls = sq_pool_class(size);
+    return cls == SQ_POOL_LARGE ? malloc(size) : sq_pool_alloc(cache, cls);
+}
+
+void *sq_vm_realloc(void *p, SQUnsignedInteger oldsize, SQUnsignedInteger size)
+{
+    if(!p) return sq_vm_malloc(size);
+    SQPoolCache &cache = sq_pool_cache();
+    sq_pool_onfree(cache, oldsize);
+    sq_pool_onalloc(cache, size);
+    if(!g_PoolEnabled) return realloc(p, size);
+    const SQUnsignedInteger oldcls = sq_pool_class(oldsize), cls = sq_pool_class(size);
+    if(oldcls == cls) {
+        return cls == SQ_POOL_LARGE ? realloc(p, size) : p;
+    }
+    void *np = cls == SQ_POOL_LARGE ? malloc(size) : sq_pool_alloc(cache, cls);
+    if(!np) return NULL;
+    memcpy(np, p, oldsize < size ? oldsize : size);
+    if(oldcls == SQ_POOL_LARGE) free(p);
+    else sq_pool_free(cache, p, oldcls);
+    return np;
+}
+
+void sq_vm_free(void *p, SQUnsignedInteger size)
+{
+    if(!p) return;
+    SQPoolCache &cache = sq_pool_cache();
+    sq_pool_onfree(cache, size);
+    if(!g_PoolEnabled) { free(p); return; }
+    const SQUnsignedInteger cls = sq_pool_class(size);
+    if(cls == SQ_POOL_LARGE) free(p);
+    else sq_pool_free(cache, p, cls);
+}
+
+SQBool sq_vm_usepool(SQBool enable)
+{
+    std::lock_guard<std::mutex> lock(g_PoolDepot._mutex);
+    // Blocks can't change owner once the virtual machine allocated any
+    if(!g_PoolDepot._started) {
+        g_PoolEnabled = enable ? true : false;
+    }
+    return g_PoolEnabled ? SQTrue : SQFalse;
+}
+
+SQBool sq_vm_poolinuse()
+{
+    return g_PoolEnabled ? SQTrue : SQFalse;
+}
+
+SQInteger sq_vm_memclasses()
+{
+    return SQ_POOL_CLASSES + 1;
+}
+
+static void sq_vm_readcounters(SQUnsignedInteger idx, SQMemInfo *info)
+{
+    std::lock_guard<std::mutex> lock(g_PoolDepot._mutex);
+    SQPoolSum sum = g_PoolDepot._ended[idx];
+    for(const SQPoolCache *cache = g_PoolDepot._threads; cache; cache = cache->_next) {
+        sq_pool_fold(sum, cache->_counters[idx]);
+    }
+    // Only the bytes in use are counted for the total, the rest is summed from the classes
+    if(idx == SQ_POOL_TOTAL) {
+        for(SQUnsignedInteger cls = 0; cls < SQ_POOL_TOTAL; ++cls) {
+            SQPoolSum csum = g_PoolDepot._ended[cls];
+            for(const SQPoolCache *cache = g_PoolDepot._threads; cache; cache = cache->_next) {
+                sq_pool_fold(csum, cache->_counters[cls]);
+            }
+            sum._blocks += csum._blocks;
+            sum._allocs += csum._allocs;
+            sum._allocated += csum._allocated;
+        }
+    }
+    // The peak of each thread is a lower bound of the peak of all of them, and so is the current sum
+    if(sum._bytes > sum._peak) sum._peak = sum._bytes;
+    g_PoolDepot._ended[idx]._peak = sum._peak;
+    info->blocks = (SQUnsignedInteger)sum._blocks;
+    info->bytes = (SQUnsignedInteger)sum._bytes;
+    info->peak = (SQUnsignedInteger)sum._peak;
+    info->allocs = sum._allocs;
+    info->allocated = sum._allocated;
+    info->reserved = g_PoolReserved[idx].load(std::memory_order_relaxed);
+}
+
+SQBool sq_vm_memclassinfo(SQInteger idx, SQMemInfo *info)
+{
+    if(idx < 0 || idx > SQ_POOL_CLASSES || !info) return SQFalse;
+    sq_vm_readcounters((SQUnsignedInteger)idx, info);
+    info->size = idx == SQ_POOL_LARGE ? 0 : (idx + 1) * SQ_POOL_GRANULARITY;
+    return SQTrue;
+}
 
-void sq_vm_free(void *p, SQUnsignedInteger SQ_UNUSED_ARG(size)){ free(p); }
+void sq_vm_meminfo(SQMemInfo *info)
+{
+    sq_vm_readcounters(SQ_POOL_TOTAL, info);
+    info->size = 0;
+}
 #endif
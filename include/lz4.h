@@ -0,0 +1,56 @@
+
+/**
+ * `lz4.h' - minimal LZ4 block codec
+ *
+ * Self contained implementation of the LZ4 block format (no frame format,
+ * no dictionaries, no streaming) meant for small in-memory payloads.
+ */
+
+#ifndef LZ4_H
+#define LZ4_H 1
+
+#include <stddef.h>
+
+/**
+ * Largest input size accepted by the compressor.
+ */
+
+#define LZ4_MAX_INPUT_SIZE 0x7E000000
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Returns the maximum size of the compressed output for an input of
+ * `int' size, or 0 if the size is negative or too large.
+ */
+
+int
+lz4_compress_bound (int);
+
+/**
+ * Compress `int' bytes from `const char *' source into `char *' destination
+ * which can hold `int' bytes. The destination must hold at least
+ * `lz4_compress_bound()' bytes. Returns the size of the compressed data
+ * or 0 on failure.
+ */
+
+int
+lz4_compress (const char *, char *, int, int);
+
+/**
+ * Decompress `int' bytes from `const char *' source into `char *' destination
+ * which can hold `int' bytes. Never reads or writes outside of the given
+ * ranges. Returns the size of the decompressed data or a negative value
+ * if the input is malformed or the destination is too small.
+ */
+
+int
+lz4_decompress (const char *, char *, int, int);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
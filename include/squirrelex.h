@@ -16,6 +16,27 @@ SQUIRREL_API SQRESULT sq_throwerrorf(HSQUIRRELVM v,const SQChar *err,...);
 SQUIRREL_API void sq_pushstringf(HSQUIRRELVM v,const SQChar *s,...);
 SQUIRREL_API SQRESULT sq_getnativeclosurepointer(HSQUIRRELVM v,SQInteger idx,SQFUNCTION *f);
 
+/*debug*/
+SQUIRREL_API SQDEBUGHOOK sq_getnativedebughook(HSQUIRRELVM v);
+SQUIRREL_API void sq_getdebughook(HSQUIRRELVM v); /* pushes the script hook or null */
+
+typedef struct tagSQMemInfo {
+    SQUnsignedInteger size; /* largest block in the class or 0 if not a class */
+    SQUnsignedInteger blocks; /* blocks currently in use */
+    SQUnsignedInteger bytes; /* bytes currently in use */
+    SQUnsignedInteger peak; /* most bytes that were in use at once, as seen by a single thread or when read */
+    SQUnsignedInteger allocs; /* blocks allocated so far */
+    SQUnsignedInteger allocated; /* bytes allocated so far */
+    SQUnsignedInteger reserved; /* bytes reserved by the pool */
+} SQMemInfo;
+
+/*vm allocator*/
+SQUIRREL_API SQBool sq_vm_usepool(SQBool enable); /* only before the first allocation */
+SQUIRREL_API SQBool sq_vm_poolinuse();
+SQUIRREL_API SQInteger sq_vm_memclasses();
+SQUIRREL_API SQBool sq_vm_memclassinfo(SQInteger idx,SQMemInfo *info);
+SQUIRREL_API void sq_vm_meminfo(SQMemInfo *info);
+
 #endif // SQMOD_PLUGIN_API
 
 #ifdef __cplusplus
@@ -7,6 +7,7 @@
 #include <cstring>
 #include <exception>
 #include <stdexcept>
+#include <mutex>
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
@@ -64,65 +65,64 @@ static Buffer::Pointer AllocMem(Buffer::SzType size)
 }
 
 /* ------------------------------------------------------------------------------------------------
- * ...
+ * Compute the base two logarithm of the specified number, rounded down.
 */
-class MemCat
+inline unsigned int Log2(unsigned int num)
 {
-    // --------------------------------------------------------------------------------------------
-    friend class Memory;
-    friend class Buffer;
-
-public:
+    unsigned int n = 0;
+    while (num >>= 1)
+    {
+        ++n;
+    }
+    return n;
+}
 
+/* ------------------------------------------------------------------------------------------------
+ * Lightweight memory allocator to reduce the overhead of frequent allocations. Memory is handed
+ * out in power of two size classes and released blocks are kept in a free list for each class.
+*/
+class Memory
+{
     // --------------------------------------------------------------------------------------------
-    typedef Buffer::Value       Value; // The type of value used to represent a byte.
+    friend class Buffer; // Allow the buffer type to access the size classes.
+    friend class MemRef; // Allow the memory manager reference to create new instances.
 
-    // --------------------------------------------------------------------------------------------
-    typedef Buffer::Reference   Reference; // A reference to the stored value type.
-    typedef Buffer::ConstRef    ConstRef; // A const reference to the stored value type.
+public:
 
     // --------------------------------------------------------------------------------------------
     typedef Buffer::Pointer     Pointer; // A pointer to the stored value type.
-    typedef Buffer::ConstPtr    ConstPtr; // A const pointer to the stored value type.
+    typedef Buffer::SzType      SzType; // The type used to represent size in general.
 
     // --------------------------------------------------------------------------------------------
-    typedef Buffer::SzType      SzType; // The type used to represent size in general.
+    enum
+    {
+        MinClass = 3, // The smallest size class that is pooled. (8 bytes)
+        MaxClass = 20, // The largest size class that is pooled. (1 MiB)
+        ClassCount = MaxClass - MinClass + 1 // The number of pooled size classes.
+    };
 
 private:
 
     /* --------------------------------------------------------------------------------------------
-     * Structure used to store a memory chunk in the linked list.
+     * Free list of memory blocks with the same size.
     */
-    struct Node
-    {
-        // ----------------------------------------------------------------------------------------
-        SzType      mCap; // The size of the memory chunk.
-        Pointer     mPtr; // Pointer to the memory chunk.
-        Node*       mNext; // The next node in the list.
-
-        /* ----------------------------------------------------------------------------------------
-         * Base constructor.
-        */
-        Node(Node * next)
-            : mCap(0)
-            , mPtr(nullptr)
-            , mNext(next)
-        {
-            /* ... */
-        }
+    struct SizeClass
+    {
+        Pointer     mHead; // The most recently released block. (next one is stored inside)
+        SzType      mCount; // The number of blocks in the list.
     };
 
-    // --------------------------------------------------------------------------------------------
-    static Node *   s_Nodes; /* List of unused node instances. */
-
-    // --------------------------------------------------------------------------------------------
-    Node*   m_Head; /* The head memory node. */
-
     /* --------------------------------------------------------------------------------------------
      * Default constructor.
     */
-    MemCat()
-        : m_Head(nullptr)
+    Memory()
+        : m_Classes()
+        , m_BlockLimit(128)
+        , m_ByteLimit(4 * 1024 * 1024)
+        , m_ThreadSafe(false)
+        , m_ThreadMode(false)
+        , m_Mutex()
+        , m_Stats()
     {
         /* ... */
     }
@@ -130,43 +130,63 @@ private:
     /* --------------------------------------------------------------------------------------------
      * Destructor.
     */
-    ~MemCat()
+    ~Memory()
     {
-        for (Node * node = m_Head, * next = nullptr; node; node = next)
+        Clear();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Release all memory blocks from the pool.
+    */
+    void Clear()
+    {
+        std::unique_lock< std::mutex > lock(m_Mutex, std::defer_lock);
+        // Is synchronization required?
+        if (m_ThreadSafe)
+        {
+            lock.lock();
+        }
+        // Go through each size class
+        for (SizeClass & sc : m_Classes)
         {
-            // Free the memory (if any)
-            if (node->mPtr)
+            while (sc.mHead)
             {
-                std::free(node->mPtr);
+                Pointer ptr = sc.mHead;
+                // The next block is stored inside the released block
+                std::memcpy(&sc.mHead, ptr, sizeof(Pointer));
+                // Free the memory
+                std::free(ptr);
             }
-            // Save the next node
-            next = node->mNext;
-            // Release the node instance
-            delete node;
+            // The list is empty now
+            sc.mCount = 0;
         }
-        // Explicitly set the head node to null
-        m_Head = nullptr;
+        // Nothing remains in the pool
+        m_Stats.mPooledBlocks = 0;
+        m_Stats.mPooledBytes = 0;
     }
 
     /* --------------------------------------------------------------------------------------------
-     * Clear all memory buffers from the pool.
+     * Release the blocks that exceed the limits of the pool. The caller must hold the lock.
     */
-    void Clear()
+    void Trim()
     {
-        for (Node * node = m_Head, * next = nullptr; node; node = next)
+        // Release blocks from the largest size class first since they free the most bytes
+        for (unsigned int cls = MaxClass; cls >= MinClass; --cls)
         {
-            // Free the memory (if any)
-            if (node->mPtr)
+            SizeClass & sc = m_Classes[cls - MinClass];
+            while (sc.mHead && (sc.mCount > m_BlockLimit || m_Stats.mPooledBytes > m_ByteLimit))
             {
-                free(node->mPtr);
+                Pointer ptr = sc.mHead;
+                // The next block is stored inside the released block
+                std::memcpy(&sc.mHead, ptr, sizeof(Pointer));
+                --sc.mCount;
+                // Update the statistics
+                --m_Stats.mPooledBlocks;
+                m_Stats.mPooledBytes -= (1u << cls);
+                // Free the memory
+                std::free(ptr);
             }
-            // Save the next node
-            next = node->mNext;
-            // Release the node instance
-            Push(node);
         }
-        // Explicitly set the head node to null
-        m_Head = nullptr;
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -174,46 +194,42 @@ private:
     */
     void Grab(Pointer & ptr, SzType & size)
     {
-        // NOTE: Function assumes (size > 0)
-        // Find a buffer large enough to satisfy the requested size
-        for (Node * node = m_Head, * prev = nullptr; node; prev = node, node = node->mNext)
+        // Round up the size to a power of two number
+        size = (size & (size - 1)) ? NextPow2(size) : size;
+        // Make sure there's room to store the link to the next block once released
+        size = (size < (1u << MinClass)) ? (1u << MinClass) : size;
+        // Identify the size class
+        const unsigned int cls = Log2(size);
+        // Acquire exclusive access if necessary
         {
-            // Is this buffer large enough?
-            if (node->mCap >= size)
+            std::unique_lock< std::mutex > lock(m_Mutex, std::defer_lock);
+            // Is synchronization required?
+            if (m_ThreadSafe)
             {
-                // Was there a previous node?
-                if (prev)
-                {
-                    prev->mNext = node->mNext;
-                }
-                // Probably this was the head
-                else
-                {
-                    m_Head = node->mNext;
-                }
-                // Assign the memory
-                ptr = node->mPtr;
-                // Assign the size
-                size = node->mCap;
-                // Release the node instance
-                Push(node);
-                // Exit the function
+                lock.lock();
+            }
+            // Count this request
+            ++m_Stats.mRequests;
+            m_Stats.mAllocatedBytes += size;
+            // Is this size pooled and is there a block available?
+            if (cls <= MaxClass && m_Classes[cls - MinClass].mHead)
+            {
+                SizeClass & sc = m_Classes[cls - MinClass];
+                // Take the most recently released block
+                ptr = sc.mHead;
+                // Promote the next block as the head
+                std::memcpy(&sc.mHead, ptr, sizeof(Pointer));
+                --sc.mCount;
+                // Update the statistics
+                ++m_Stats.mHits;
+                --m_Stats.mPooledBlocks;
+                m_Stats.mPooledBytes -= size;
+                // We're done here
                 return;
             }
         }
-        // Round up the size to a power of two number
-        size = (size & (size - 1)) ? NextPow2(size) : size;
         // Allocate the memory directly
         ptr = AllocMem(size);
-        // See if the memory could be allocated
-        // (shouldn't reach this point if allocation failed)
-        if (!ptr)
-        {
-            // Revert the size
-            size = 0;
-            // Throw the exception
-            ThrowMemExcept("Unable to allocate (%u) bytes of memory", size);
-        }
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -225,118 +241,59 @@ private:
         {
             ThrowMemExcept("Cannot store invalid memory buffer");
         }
-        // Request a node instance
-        Node * node = Pull();
-        // Assign the specified memory
-        node->mPtr = ptr;
-        // Assign the specified size
-        node->mCap = size;
-        // Demote the current head node
-        node->mNext = m_Head;
-        // Promote as the head node
-        m_Head = node;
-    }
-
-    /* --------------------------------------------------------------------------------------------
-     * Allocate a group of nodes and pool them for later use.
-    */
-    static void Make()
-    {
-        for (SzType n = 16; n; --n)
+        // Identify the size class (rounded down in case the size is not a power of two)
+        const unsigned int cls = Log2(size);
+        // Acquire exclusive access if necessary
         {
-            // Create a new node instance
-            s_Nodes = new Node(s_Nodes);
-            // Validate the head node
-            if (!s_Nodes)
+            std::unique_lock< std::mutex > lock(m_Mutex, std::defer_lock);
+            // Is synchronization required?
+            if (m_ThreadSafe)
             {
-                ThrowMemExcept("Unable to allocate memory nodes");
+                lock.lock();
             }
+            // Count this release
+            ++m_Stats.mReleases;
+            m_Stats.mAllocatedBytes -= size;
+            // Is this size pooled and are the limits respected?
+            if (cls >= MinClass && cls <= MaxClass &&
+                m_Classes[cls - MinClass].mCount < m_BlockLimit &&
+                (m_Stats.mPooledBytes + (1u << cls)) <= m_ByteLimit)
+            {
+                SizeClass & sc = m_Classes[cls - MinClass];
+                // Store the link to the current head inside the released block
+                std::memcpy(ptr, &sc.mHead, sizeof(Pointer));
+                // Promote it as the head
+                sc.mHead = ptr;
+                ++sc.mCount;
+                // Update the statistics
+                ++m_Stats.mPooledBlocks;
+                m_Stats.mPooledBytes += (1u << cls);
+                // We're done here
+                return;
+            }
+            // The block is discarded
+            ++m_Stats.mDiscarded;
         }
+        // Free the memory directly
+        std::free(ptr);
     }
 
-    /* --------------------------------------------------------------------------------------------
-     * Retrieve an unused node from the free list.
-    */
-    static Node * Pull()
-    {
-        // Are there any nodes available?
-        if (!s_Nodes)
-        {
-            Make(); // Make some!
-        }
-        // Grab the head node
-        Node * node = s_Nodes;
-        // Promote the next node as the head
-        s_Nodes = node->mNext;
-        // Return the node
-        return node;
-    }
-
-    /* --------------------------------------------------------------------------------------------
-     * Return a node to the free list.
-    */
-    static void Push(Node * node)
-    {
-        // See if the node is even valid
-        if (!node)
-        {
-            ThrowMemExcept("Attempting to push invalid node");
-        }
-        // Demote the current head node
-        node->mNext = s_Nodes;
-        // Promote as the head node
-        s_Nodes = node;
-    }
-};
-
-// ------------------------------------------------------------------------------------------------
-MemCat::Node *  MemCat::s_Nodes = nullptr;
-
-/* ------------------------------------------------------------------------------------------------
- * Lightweight memory allocator to reduce the overhead of small allocations.
-*/
-class Memory
-{
-    // --------------------------------------------------------------------------------------------
-    friend class Buffer; // Allow the buffer type to access the memory categories.
-    friend class MemRef; // Allow the memory manager reference to create new instances.
-
 private:
 
-    /* --------------------------------------------------------------------------------------------
-     * Default constructor.
-    */
-    Memory()
-        : m_Small()
-        , m_Medium()
-        , m_Large()
-    {
-        // Allocate several nodes for when memory starts pooling
-        MemCat::Make();
-    }
+    // --------------------------------------------------------------------------------------------
+    SizeClass   m_Classes[ClassCount]; // Free lists of released blocks for each size class.
 
-    /* --------------------------------------------------------------------------------------------
-     * Destructor.
-    */
-    ~Memory()
-    {
-        for (MemCat::Node * node = MemCat::s_Nodes, * next = nullptr; node; node = next)
-        {
-            // Save the next node
-            next = node->mNext;
-            // Release the node instance
-            delete node;
-        }
-        // Explicitly set the head node to null
-        MemCat::s_Nodes = nullptr;
-    }
+    // --------------------------------------------------------------------------------------------
+    SzType      m_BlockLimit; // The maximum number of blocks pooled in each size class.
+    SzType      m_ByteLimit; // The maximum number of bytes pooled in all size classes.
 
-private:
+    // --------------------------------------------------------------------------------------------
+    bool        m_ThreadSafe; // Whether access to the pool is synchronized.
+    bool        m_ThreadMode; // Whether the synchronization mode was chosen.
+    std::mutex  m_Mutex; // Mutex used to synchronize access to the pool.
 
     // --------------------------------------------------------------------------------------------
-    MemCat m_Small; // Small memory allocations of <= 1024 bytes.
-    MemCat m_Medium; // Medium memory allocations of <= 4096 bytes.
-    MemCat m_Large; // Large memory allocations of <= 4096 bytes.
+    MemStats    m_Stats; // Statistics about the pooled memory.
 };
 
 // ------------------------------------------------------------------------------------------------
@@ -375,6 +332,124 @@ const MemRef & MemRef::Get()
     return s_Mem;
 }
 
+// ------------------------------------------------------------------------------------------------
+MemStats MemRef::GetStats()
+{
+    Memory & mem = *Get();
+    // Acquire exclusive access if necessary
+    std::unique_lock< std::mutex > lock(mem.m_Mutex, std::defer_lock);
+    // Is synchronization required?
+    if (mem.m_ThreadSafe)
+    {
+        lock.lock();
+    }
+    // Return a copy of the statistics
+    return mem.m_Stats;
+}
+
+// ------------------------------------------------------------------------------------------------
+void MemRef::ResetStats()
+{
+    Memory & mem = *Get();
+    // Acquire exclusive access if necessary
+    std::unique_lock< std::mutex > lock(mem.m_Mutex, std::defer_lock);
+    // Is synchronization required?
+    if (mem.m_ThreadSafe)
+    {
+        lock.lock();
+    }
+    // Reset only the counters and leave the current state intact
+    mem.m_Stats.mRequests = 0;
+    mem.m_Stats.mHits = 0;
+    mem.m_Stats.mReleases = 0;
+    mem.m_Stats.mDiscarded = 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int MemRef::GetBlockLimit()
+{
+    Memory & mem = *Get();
+    // Acquire exclusive access if necessary
+    std::unique_lock< std::mutex > lock(mem.m_Mutex, std::defer_lock);
+    // Is synchronization required?
+    if (mem.m_ThreadSafe)
+    {
+        lock.lock();
+    }
+    return mem.m_BlockLimit;
+}
+
+// ------------------------------------------------------------------------------------------------
+void MemRef::SetBlockLimit(unsigned int blocks)
+{
+    Memory & mem = *Get();
+    // Acquire exclusive access if necessary
+    std::unique_lock< std::mutex > lock(mem.m_Mutex, std::defer_lock);
+    // Is synchronization required?
+    if (mem.m_ThreadSafe)
+    {
+        lock.lock();
+    }
+    mem.m_BlockLimit = blocks;
+    // Release the blocks that exceed the new limit
+    mem.Trim();
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int MemRef::GetByteLimit()
+{
+    Memory & mem = *Get();
+    // Acquire exclusive access if necessary
+    std::unique_lock< std::mutex > lock(mem.m_Mutex, std::defer_lock);
+    // Is synchronization required?
+    if (mem.m_ThreadSafe)
+    {
+        lock.lock();
+    }
+    return mem.m_ByteLimit;
+}
+
+// ------------------------------------------------------------------------------------------------
+void MemRef::SetByteLimit(unsigned int bytes)
+{
+    Memory & mem = *Get();
+    // Acquire exclusive access if necessary
+    std::unique_lock< std::mutex > lock(mem.m_Mutex, std::defer_lock);
+    // Is synchronization required?
+    if (mem.m_ThreadSafe)
+    {
+        lock.lock();
+    }
+    mem.m_ByteLimit = bytes;
+    // Release the blocks that exceed the new limit
+    mem.Trim();
+}
+
+// ------------------------------------------------------------------------------------------------
+bool MemRef::IsThreadSafe()
+{
+    return Get()->m_ThreadSafe;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool MemRef::SetThreadSafe(bool toggle)
+{
+    Memory & mem = *Get();
+    // Can the mode still be chosen?
+    if (!mem.m_ThreadMode)
+    {
+        mem.m_ThreadSafe = toggle;
+        mem.m_ThreadMode = true;
+    }
+    return mem.m_ThreadSafe;
+}
+
+// ------------------------------------------------------------------------------------------------
+void MemRef::Clear()
+{
+    Get()->Clear();
+}
+
 // ------------------------------------------------------------------------------------------------
 Buffer::Buffer(const Buffer & o)
     : m_Ptr(nullptr)
@@ -463,18 +538,10 @@ void Buffer::Request(SzType n)
         // Allocate the memory directly
         m_Ptr = AllocMem(n);
     }
-    // Find out in which category does this buffer reside
-    else if (n <= 1024)
-    {
-        m_Mem->m_Small.Grab(m_Ptr, n);
-    }
-    else if (n <= 4096)
-    {
-        m_Mem->m_Medium.Grab(m_Ptr, n);
-    }
+    // Let the memory manager pick the size class
     else
     {
-        m_Mem->m_Large.Grab(m_Ptr, n);
+        m_Mem->Grab(m_Ptr, n);
     }
     // If no errors occurred then we can set the size
     m_Cap = n;
@@ -483,24 +550,15 @@ void Buffer::Request(SzType n)
 // ------------------------------------------------------------------------------------------------
 void Buffer::Release()
 {
-    // TODO: Implement a limit on how much memory can actually be pooled.
     // Is there a memory manager available?
     if (!m_Mem)
     {
         std::free(m_Ptr); // Deallocate the memory directly
     }
-    // Find out to which category does this buffer belong
-    else if (m_Cap <= 1024)
-    {
-        m_Mem->m_Small.Drop(m_Ptr, m_Cap);
-    }
-    else if (m_Cap <= 4096)
-    {
-        m_Mem->m_Medium.Drop(m_Ptr, m_Cap);
-    }
+    // Let the memory manager decide whether to pool it
     else
     {
-        m_Mem->m_Large.Drop(m_Ptr, m_Cap);
+        m_Mem->Drop(m_Ptr, m_Cap);
     }
     // Explicitly reset the buffer
     m_Ptr = nullptr;
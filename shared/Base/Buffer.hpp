@@ -16,6 +16,20 @@ namespace SqMod {
 class Memory;
 class Buffer;
 
+/* ------------------------------------------------------------------------------------------------
+ * Statistics about the memory pooled by the memory manager.
+*/
+struct MemStats
+{
+    unsigned long long  mRequests; // The number of blocks that were requested.
+    unsigned long long  mHits; // The number of requests served from the pool.
+    unsigned long long  mReleases; // The number of blocks that were released.
+    unsigned long long  mDiscarded; // The number of released blocks that exceeded the pool limits.
+    unsigned long long  mAllocatedBytes; // The number of bytes currently in use by buffers.
+    unsigned long long  mPooledBlocks; // The number of blocks currently waiting in the pool.
+    unsigned long long  mPooledBytes; // The number of bytes currently waiting in the pool.
+};
+
 /* ------------------------------------------------------------------------------------------------
  * A counted reference to a memory manager instance.
 */
@@ -50,6 +64,55 @@ public:
     */
     static const MemRef & Get();
 
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve a copy of the global memory manager statistics.
+    */
+    static MemStats GetStats();
+
+    /* --------------------------------------------------------------------------------------------
+     * Reset the request and release counters of the global memory manager.
+    */
+    static void ResetStats();
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of blocks pooled in each size class.
+    */
+    static unsigned int GetBlockLimit();
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of blocks pooled in each size class. Pooled blocks over the new limit
+     * are released.
+    */
+    static void SetBlockLimit(unsigned int blocks);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of bytes pooled in all size classes.
+    */
+    static unsigned int GetByteLimit();
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of bytes pooled in all size classes. Pooled blocks over the new limit
+     * are released, starting with the largest ones.
+    */
+    static void SetByteLimit(unsigned int bytes);
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether access to the pooled memory is synchronized.
+    */
+    static bool IsThreadSafe();
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify whether access to the pooled memory is synchronized. Only the pool is synchronized,
+     * individual buffers should still not be shared between threads. Only the first call has an
+     * effect, since other threads might be using the pool afterwards. Returns the mode in use.
+    */
+    static bool SetThreadSafe(bool toggle);
+
+    /* --------------------------------------------------------------------------------------------
+     * Release all memory blocks waiting in the pool.
+    */
+    static void Clear();
+
     /* --------------------------------------------------------------------------------------------
      * Default constructor (null).
     */
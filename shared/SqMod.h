@@ -60,6 +60,9 @@ extern "C" {
     #define SQMOD_TERMINATE_CMD     0xDEADC0DE
     #define SQMOD_CLOSING_CMD       0xBAAAAAAD
     #define SQMOD_RELEASED_CMD      0xDEADBEAF
+    #define SQMOD_LOGDUMP_CMD       0xDEADF00D
+    #define SQMOD_PROFSTART_CMD     0xFEEDF00D
+    #define SQMOD_PROFSTOP_CMD      0xFEEDFACE
     #define SQMOD_API_VER           1
 
     //primitive functions
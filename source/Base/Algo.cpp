@@ -118,10 +118,10 @@ static const LightObj & Blip_FindBySprID(Int32 sprid)
     {
         STHROWF("The specified sprite identifier is invalid: %d", sprid);
     }
-    // Obtain the ends of the entity pool
-    Core::Blips::const_iterator itr = Core::Get().GetBlips().cbegin();
-    Core::Blips::const_iterator end = Core::Get().GetBlips().cend();
-    // Process each entity in the pool
+    // Obtain the ends of the allocated entities
+    InstSpec< CBlip >::Iterator itr = InstSpec< CBlip >::CBegin();
+    InstSpec< CBlip >::Iterator end = InstSpec< CBlip >::CEnd();
+    // Process each allocated entity
     for (; itr != end; ++itr)
     {
         // Does the identifier match the specified one?
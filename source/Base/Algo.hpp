@@ -7,6 +7,7 @@
 // ------------------------------------------------------------------------------------------------
 #include <cstring>
 #include <vector>
+#include <iterator>
 #include <functional>
 
 // ------------------------------------------------------------------------------------------------
@@ -573,6 +574,90 @@ void FirstMatches(Iterator first, Iterator last,
     }
 }
 
+/* ------------------------------------------------------------------------------------------------
+ * Iterator over the instances of an entity pool with the identifiers from the specified list. The
+ * list must not change during the iteration, so functions which invoke script callbacks iterate
+ * over a copy of the active identifiers and check each entity again before it's processed.
+*/
+template < typename T > class ActiveIterator
+{
+public:
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::forward_iterator_tag       iterator_category;
+    typedef typename T::value_type          value_type;
+    typedef std::ptrdiff_t                  difference_type;
+    typedef const value_type *              pointer;
+    typedef const value_type &              reference;
+
+private:
+
+    // --------------------------------------------------------------------------------------------
+    const T *                   m_Pool; // The pool that contains the instances.
+    const Core::ActiveList *    m_List; // The identifiers of the allocated instances.
+    size_t                      m_Pos; // The current position in the list of identifiers.
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor.
+    */
+    ActiveIterator(const T & pool, const Core::ActiveList & list, size_t pos)
+        : m_Pool(&pool), m_List(&list), m_Pos(pos)
+    {
+        /* ... */
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the iterator went past the last identifier.
+    */
+    bool Done() const
+    {
+        return m_Pos >= m_List->size();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Equality comparison operator.
+    */
+    bool operator == (const ActiveIterator & o) const
+    {
+        return (m_Pos == o.m_Pos) || (Done() && o.Done());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Inequality comparison operator.
+    */
+    bool operator != (const ActiveIterator & o) const
+    {
+        return !(*this == o);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Pre-increment operator.
+    */
+    ActiveIterator & operator ++ ()
+    {
+        ++m_Pos;
+        return *this;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Indirection operator.
+    */
+    reference operator * () const
+    {
+        return (*m_Pool)[(*m_List)[m_Pos]];
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Member access operator.
+    */
+    pointer operator -> () const
+    {
+        return &(*m_Pool)[(*m_List)[m_Pos]];
+    }
+};
+
 /* ------------------------------------------------------------------------------------------------
  * Used to work with entity instances in a template fashion.
 */
@@ -586,6 +671,7 @@ template <> struct InstSpec< CBlip >
     // --------------------------------------------------------------------------------------------
     typedef Core::Blips Instances; // Container to store instances of this entity type.
     typedef Core::Blips::value_type Instance; // Type that manages this type of entity instance.
+    typedef ActiveIterator< Instances > Iterator; // Iterator over the allocated instances.
 
     // --------------------------------------------------------------------------------------------
     static constexpr int Max = SQMOD_BLIP_POOL; // Maximum identifier for this entity type.
@@ -595,19 +681,51 @@ template <> struct InstSpec< CBlip >
     static constexpr CSStr UcName = "Blip"; // Uppercase name of this entity type.
 
     /* --------------------------------------------------------------------------------------------
-     * Iterator to the beginning of the instance container.
+     * Iterator to the first allocated instance.
+    */
+    static inline Iterator CBegin()
+    {
+        return Iterator(Core::Get().GetBlips(), Core::Get().GetActiveBlips(), 0);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Iterator past the last allocated instance.
+    */
+    static inline Iterator CEnd()
+    {
+        return Iterator(Core::Get().GetBlips(), Core::Get().GetActiveBlips(), Core::Get().GetActiveBlips().size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Identifiers of the allocated instances.
+    */
+    static inline const Core::ActiveList & Active()
+    {
+        return Core::Get().GetActiveBlips();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Instance with the specified identifier.
     */
-    static inline Instances::const_iterator CBegin()
+    static inline const Instance & Get(Int32 id)
     {
-        return Core::Get().GetBlips().cbegin();
+        return Core::Get().GetBlips()[id];
     }
 
     /* --------------------------------------------------------------------------------------------
-     * Iterator to the ending of the instance container.
+     * The pool that contains the instances.
     */
-    static inline Instances::const_iterator CEnd()
+    static inline const Instances & Pool()
     {
-        return Core::Get().GetBlips().cend();
+        return Core::Get().GetBlips();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Index of the instance tags.
+    */
+    static inline const TagIndex & Tags()
+    {
+        return Core::Get().GetBlipTags();
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -627,6 +745,7 @@ template <> struct InstSpec< CCheckpoint >
     // --------------------------------------------------------------------------------------------
     typedef Core::Checkpoints Instances; // Container to store instances of this entity type.
     typedef Core::Checkpoints::value_type Instance; // Type that manages this type of entity instance.
+    typedef ActiveIterator< Instances > Iterator; // Iterator over the allocated instances.
 
     // --------------------------------------------------------------------------------------------
     static constexpr int Max = SQMOD_CHECKPOINT_POOL; // Maximum identifier for this entity type.
@@ -636,19 +755,51 @@ template <> struct InstSpec< CCheckpoint >
     static constexpr CSStr UcName = "Checkpoint"; // Uppercase name of this entity type.
 
     /* --------------------------------------------------------------------------------------------
-     * Iterator to the beginning of the instance container.
+     * Iterator to the first allocated instance.
+    */
+    static inline Iterator CBegin()
+    {
+        return Iterator(Core::Get().GetCheckpoints(), Core::Get().GetActiveCheckpoints(), 0);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Iterator past the last allocated instance.
+    */
+    static inline Iterator CEnd()
+    {
+        return Iterator(Core::Get().GetCheckpoints(), Core::Get().GetActiveCheckpoints(), Core::Get().GetActiveCheckpoints().size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Identifiers of the allocated instances.
+    */
+    static inline const Core::ActiveList & Active()
+    {
+        return Core::Get().GetActiveCheckpoints();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Instance with the specified identifier.
+    */
+    static inline const Instance & Get(Int32 id)
+    {
+        return Core::Get().GetCheckpoints()[id];
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * The pool that contains the instances.
     */
-    static inline Instances::const_iterator CBegin()
+    static inline const Instances & Pool()
     {
-        return Core::Get().GetCheckpoints().cbegin();
+        return Core::Get().GetCheckpoints();
     }
 
     /* --------------------------------------------------------------------------------------------
-     * Iterator to the ending of the instance container.
+     * Index of the instance tags.
     */
-    static inline Instances::const_iterator CEnd()
+    static inline const TagIndex & Tags()
     {
-        return Core::Get().GetCheckpoints().cend();
+        return Core::Get().GetCheckpointTags();
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -668,6 +819,7 @@ template <> struct InstSpec< CKeybind >
     // --------------------------------------------------------------------------------------------
     typedef Core::Keybinds Instances; // Container to store instances of this entity type.
     typedef Core::Keybinds::value_type Instance; // Type that manages this type of entity instance.
+    typedef ActiveIterator< Instances > Iterator; // Iterator over the allocated instances.
 
     // --------------------------------------------------------------------------------------------
     static constexpr int Max = SQMOD_KEYBIND_POOL; // Maximum identifier for this entity type.
@@ -677,19 +829,51 @@ template <> struct InstSpec< CKeybind >
     static constexpr CSStr UcName = "Keybind"; // Uppercase name of this entity type.
 
     /* --------------------------------------------------------------------------------------------
-     * Iterator to the beginning of the instance container.
+     * Iterator to the first allocated instance.
+    */
+    static inline Iterator CBegin()
+    {
+        return Iterator(Core::Get().GetKeybinds(), Core::Get().GetActiveKeybinds(), 0);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Iterator past the last allocated instance.
+    */
+    static inline Iterator CEnd()
+    {
+        return Iterator(Core::Get().GetKeybinds(), Core::Get().GetActiveKeybinds(), Core::Get().GetActiveKeybinds().size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Identifiers of the allocated instances.
+    */
+    static inline const Core::ActiveList & Active()
+    {
+        return Core::Get().GetActiveKeybinds();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Instance with the specified identifier.
     */
-    static inline Instances::const_iterator CBegin()
+    static inline const Instance & Get(Int32 id)
     {
-        return Core::Get().GetKeybinds().cbegin();
+        return Core::Get().GetKeybinds()[id];
     }
 
     /* --------------------------------------------------------------------------------------------
-     * Iterator to the ending of the instance container.
+     * The pool that contains the instances.
     */
-    static inline Instances::const_iterator CEnd()
+    static inline const Instances & Pool()
     {
-        return Core::Get().GetKeybinds().cend();
+        return Core::Get().GetKeybinds();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Index of the instance tags.
+    */
+    static inline const TagIndex & Tags()
+    {
+        return Core::Get().GetKeybindTags();
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -709,6 +893,7 @@ template <> struct InstSpec< CObject >
     // --------------------------------------------------------------------------------------------
     typedef Core::Objects Instances; // Container to store instances of this entity type.
     typedef Core::Objects::value_type Instance; // Type that manages this type of entity instance.
+    typedef ActiveIterator< Instances > Iterator; // Iterator over the allocated instances.
 
     // --------------------------------------------------------------------------------------------
     static constexpr int Max = SQMOD_OBJECT_POOL; // Maximum identifier for this entity type.
@@ -718,19 +903,51 @@ template <> struct InstSpec< CObject >
     static constexpr CSStr UcName = "Object"; // Uppercase name of this entity type.
 
     /* --------------------------------------------------------------------------------------------
-     * Iterator to the beginning of the instance container.
+     * Iterator to the first allocated instance.
+    */
+    static inline Iterator CBegin()
+    {
+        return Iterator(Core::Get().GetObjects(), Core::Get().GetActiveObjects(), 0);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Iterator past the last allocated instance.
+    */
+    static inline Iterator CEnd()
+    {
+        return Iterator(Core::Get().GetObjects(), Core::Get().GetActiveObjects(), Core::Get().GetActiveObjects().size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Identifiers of the allocated instances.
+    */
+    static inline const Core::ActiveList & Active()
+    {
+        return Core::Get().GetActiveObjects();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Instance with the specified identifier.
     */
-    static inline Instances::const_iterator CBegin()
+    static inline const Instance & Get(Int32 id)
     {
-        return Core::Get().GetObjects().cbegin();
+        return Core::Get().GetObjects()[id];
     }
 
     /* --------------------------------------------------------------------------------------------
-     * Iterator to the ending of the instance container.
+     * The pool that contains the instances.
     */
-    static inline Instances::const_iterator CEnd()
+    static inline const Instances & Pool()
     {
-        return Core::Get().GetObjects().cend();
+        return Core::Get().GetObjects();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Index of the instance tags.
+    */
+    static inline const TagIndex & Tags()
+    {
+        return Core::Get().GetObjectTags();
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -750,6 +967,7 @@ template <> struct InstSpec< CPickup >
     // --------------------------------------------------------------------------------------------
     typedef Core::Pickups Instances; // Container to store instances of this entity type.
     typedef Core::Pickups::value_type Instance; // Type that manages this type of entity instance.
+    typedef ActiveIterator< Instances > Iterator; // Iterator over the allocated instances.
 
     // --------------------------------------------------------------------------------------------
     static constexpr int Max = SQMOD_PICKUP_POOL; // Maximum identifier for this entity type.
@@ -759,19 +977,51 @@ template <> struct InstSpec< CPickup >
     static constexpr CSStr UcName = "Pickup"; // Uppercase name of this entity type.
 
     /* --------------------------------------------------------------------------------------------
-     * Iterator to the beginning of the instance container.
+     * Iterator to the first allocated instance.
+    */
+    static inline Iterator CBegin()
+    {
+        return Iterator(Core::Get().GetPickups(), Core::Get().GetActivePickups(), 0);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Iterator past the last allocated instance.
+    */
+    static inline Iterator CEnd()
+    {
+        return Iterator(Core::Get().GetPickups(), Core::Get().GetActivePickups(), Core::Get().GetActivePickups().size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Identifiers of the allocated instances.
+    */
+    static inline const Core::ActiveList & Active()
+    {
+        return Core::Get().GetActivePickups();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Instance with the specified identifier.
     */
-    static inline Instances::const_iterator CBegin()
+    static inline const Instance & Get(Int32 id)
     {
-        return Core::Get().GetPickups().cbegin();
+        return Core::Get().GetPickups()[id];
     }
 
     /* --------------------------------------------------------------------------------------------
-     * Iterator to the ending of the instance container.
+     * The pool that contains the instances.
     */
-    static inline Instances::const_iterator CEnd()
+    static inline const Instances & Pool()
     {
-        return Core::Get().GetPickups().cend();
+        return Core::Get().GetPickups();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Index of the instance tags.
+    */
+    static inline const TagIndex & Tags()
+    {
+        return Core::Get().GetPickupTags();
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -791,6 +1041,7 @@ template <> struct InstSpec< CPlayer >
     // --------------------------------------------------------------------------------------------
     typedef Core::Players Instances; // Container to store instances of this entity type.
     typedef Core::Players::value_type Instance; // Type that manages this type of entity instance.
+    typedef ActiveIterator< Instances > Iterator; // Iterator over the allocated instances.
 
     // --------------------------------------------------------------------------------------------
     static constexpr int Max = SQMOD_PLAYER_POOL; // Maximum identifier for this entity type.
@@ -800,19 +1051,51 @@ template <> struct InstSpec< CPlayer >
     static constexpr CSStr UcName = "Player"; // Uppercase name of this entity type.
 
     /* --------------------------------------------------------------------------------------------
-     * Iterator to the beginning of the instance container.
+     * Iterator to the first allocated instance.
+    */
+    static inline Iterator CBegin()
+    {
+        return Iterator(Core::Get().GetPlayers(), Core::Get().GetActivePlayers(), 0);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Iterator past the last allocated instance.
+    */
+    static inline Iterator CEnd()
+    {
+        return Iterator(Core::Get().GetPlayers(), Core::Get().GetActivePlayers(), Core::Get().GetActivePlayers().size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Identifiers of the allocated instances.
+    */
+    static inline const Core::ActiveList & Active()
+    {
+        return Core::Get().GetActivePlayers();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Instance with the specified identifier.
+    */
+    static inline const Instance & Get(Int32 id)
+    {
+        return Core::Get().GetPlayers()[id];
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * The pool that contains the instances.
     */
-    static inline Instances::const_iterator CBegin()
+    static inline const Instances & Pool()
     {
-        return Core::Get().GetPlayers().cbegin();
+        return Core::Get().GetPlayers();
     }
 
     /* --------------------------------------------------------------------------------------------
-     * Iterator to the ending of the instance container.
+     * Index of the instance tags.
     */
-    static inline Instances::const_iterator CEnd()
+    static inline const TagIndex & Tags()
     {
-        return Core::Get().GetPlayers().cend();
+        return Core::Get().GetPlayerTags();
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -832,6 +1115,7 @@ template <> struct InstSpec< CVehicle >
     // --------------------------------------------------------------------------------------------
     typedef Core::Vehicles Instances; // Container to store instances of this entity type.
     typedef Core::Vehicles::value_type Instance; // Type that manages this type of entity instance.
+    typedef ActiveIterator< Instances > Iterator; // Iterator over the allocated instances.
 
     // --------------------------------------------------------------------------------------------
     static constexpr int Max = SQMOD_VEHICLE_POOL; // Maximum identifier for this entity type.
@@ -841,19 +1125,51 @@ template <> struct InstSpec< CVehicle >
     static constexpr CSStr UcName = "Vehicle"; // Uppercase name of this entity type.
 
     /* --------------------------------------------------------------------------------------------
-     * Iterator to the beginning of the instance container.
+     * Iterator to the first allocated instance.
+    */
+    static inline Iterator CBegin()
+    {
+        return Iterator(Core::Get().GetVehicles(), Core::Get().GetActiveVehicles(), 0);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Iterator past the last allocated instance.
+    */
+    static inline Iterator CEnd()
+    {
+        return Iterator(Core::Get().GetVehicles(), Core::Get().GetActiveVehicles(), Core::Get().GetActiveVehicles().size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Identifiers of the allocated instances.
+    */
+    static inline const Core::ActiveList & Active()
+    {
+        return Core::Get().GetActiveVehicles();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Instance with the specified identifier.
     */
-    static inline Instances::const_iterator CBegin()
+    static inline const Instance & Get(Int32 id)
     {
-        return Core::Get().GetVehicles().cbegin();
+        return Core::Get().GetVehicles()[id];
     }
 
     /* --------------------------------------------------------------------------------------------
-     * Iterator to the ending of the instance container.
+     * The pool that contains the instances.
     */
-    static inline Instances::const_iterator CEnd()
+    static inline const Instances & Pool()
     {
-        return Core::Get().GetVehicles().cend();
+        return Core::Get().GetVehicles();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Index of the instance tags.
+    */
+    static inline const TagIndex & Tags()
+    {
+        return Core::Get().GetVehicleTags();
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -1199,22 +1515,46 @@ public:
         {
             STHROWF("The specified %s identifier is invalid: %d", Inst::LcName, id);
         }
-        // Obtain the ends of the entity pool
-        typename Inst::Instances::const_iterator itr = Inst::CBegin();
-        typename Inst::Instances::const_iterator end = Inst::CEnd();
-        // Process each entity in the pool
-        for (; itr != end; ++itr)
+        // Retrieve the instance with this identifier
+        const typename Inst::Instance & inst = Inst::Get(id);
+        // Is there an entity with this identifier?
+        if (VALID_ENTITY(inst.mID))
         {
-            // Does the identifier match the specified one?
-            if (itr->mID == id)
-            {
-                return itr->mObj; // Stop searching and return this entity
-            }
+            return inst.mObj;
         }
-        // Unable to locate a player matching the specified identifier
+        // Unable to locate an entity matching the specified identifier
         return Inst::Null();
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Iterator to the first entity from the specified list of identifiers.
+    */
+    static inline typename Inst::Iterator IBegin(const TagIndex::IDs & ids)
+    {
+        return typename Inst::Iterator(Inst::Pool(), ids, 0);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Iterator past the last entity from the specified list of identifiers.
+    */
+    static inline typename Inst::Iterator IEnd(const TagIndex::IDs & ids)
+    {
+        return typename Inst::Iterator(Inst::Pool(), ids, ids.size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy the identifiers of the entities with the specified tag from the tag index.
+    */
+    static inline void IndexEquals(bool cs, CSStr tag, TagIndex::IDs & ids)
+    {
+        const TagIndex::IDs * found = Inst::Tags().Equals(tag, cs);
+        // Were there any entities with this tag?
+        if (found)
+        {
+            ids = *found;
+        }
+    }
+
     /* --------------------------------------------------------------------------------------------
      * Find all active entities of this type.
     */
@@ -1239,8 +1579,20 @@ public:
         const StackGuard sg;
         // Allocate an empty array on the stack
         sq_newarray(DefaultVM::Get(), 0);
-        // Process each entity in the pool
-        EachEquals(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(), AppendElem(), tag, !neg, cs);
+        // Can the tag index answer this?
+        if (!neg)
+        {
+            // Retrieve the matching entities from the tag index
+            TagIndex::IDs ids;
+            IndexEquals(cs, tag, ids);
+            // Process each matching entity
+            Collect(IBegin(ids), IEnd(ids), ValidInst(), AppendElem());
+        }
+        else
+        {
+            // Process each entity in the pool
+            EachEquals(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(), AppendElem(), tag, !neg, cs);
+        }
         // Return the array at the top of the stack
         return Var< Array >(DefaultVM::Get(), -1).value;
     }
@@ -1255,8 +1607,20 @@ public:
         const StackGuard sg;
         // Allocate an empty array on the stack
         sq_newarray(DefaultVM::Get(), 0);
-        // Process each entity in the pool
-        EachBegins(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(), AppendElem(), tag, strlen(tag), !neg, cs);
+        // Can the tag index answer this?
+        if (!neg)
+        {
+            // Retrieve the matching entities from the tag index
+            TagIndex::IDs ids;
+            Inst::Tags().Begins(tag, cs, ids);
+            // Process each matching entity
+            Collect(IBegin(ids), IEnd(ids), ValidInst(), AppendElem());
+        }
+        else
+        {
+            // Process each entity in the pool
+            EachBegins(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(), AppendElem(), tag, strlen(tag), !neg, cs);
+        }
         // Return the array at the top of the stack
         return Var< Array >(DefaultVM::Get(), -1).value;
     }
@@ -1315,6 +1679,13 @@ public:
     static inline LightObj FirstWhereTagEquals(bool neg, bool cs, CSStr tag)
     {
         SQMOD_VALID_TAG_STR(tag)
+        // Can the tag index answer this?
+        if (!neg)
+        {
+            const TagIndex::IDs * ids = Inst::Tags().Equals(tag, cs);
+            // The lowest identifier is the first entity in the pool
+            return ids ? Inst::Get(ids->front()).mObj : Inst::Null();
+        }
         // Create a new element receiver
         RecvElem recv;
         // Process each entity in the pool
@@ -1330,6 +1701,14 @@ public:
     static inline LightObj FirstWhereTagBegins(bool neg, bool cs, CSStr tag)
     {
         SQMOD_VALID_TAG_STR(tag)
+        // Can the tag index answer this?
+        if (!neg)
+        {
+            TagIndex::IDs ids;
+            Inst::Tags().Begins(tag, cs, ids);
+            // The lowest identifier is the first entity in the pool
+            return ids.empty() ? Inst::Null() : Inst::Get(ids.front()).mObj;
+        }
         // Create a new element receiver
         RecvElem recv;
         // Process each entity in the pool
@@ -1391,8 +1770,10 @@ public:
     {
         // Create a new element forwarder
         ForwardElem fwd(env, func);
+        // Copy the identifiers since the callback may create or destroy entities
+        const TagIndex::IDs ids(Inst::Active());
         // Process each entity in the pool
-        CollectWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(),
+        CollectWhile(IBegin(ids), IEnd(ids), ValidInst(),
                         std::reference_wrapper< ForwardElem >(fwd));
         // Return the forward count
         return fwd.mCount;
@@ -1405,8 +1786,10 @@ public:
     {
         // Create a new element forwarder
         ForwardElemData fwd(data, env, func);
+        // Copy the identifiers since the callback may create or destroy entities
+        const TagIndex::IDs ids(Inst::Active());
         // Process each entity in the pool
-        CollectWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(),
+        CollectWhile(IBegin(ids), IEnd(ids), ValidInst(),
                         std::reference_wrapper< ForwardElemData >(fwd));
         // Return the forward count
         return fwd.mCount;
@@ -1420,9 +1803,23 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element forwarder
         ForwardElem fwd(env, func);
-        // Process each entity in the pool
-        EachEqualsWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
-                        std::reference_wrapper< ForwardElem >(fwd), tag, !neg, cs);
+        // Can the tag index answer this?
+        if (!neg)
+        {
+            // Retrieve the matching entities from the tag index
+            TagIndex::IDs ids;
+            IndexEquals(cs, tag, ids);
+            // Process each matching entity
+            CollectWhile(IBegin(ids), IEnd(ids), ValidInst(), std::reference_wrapper< ForwardElem >(fwd));
+        }
+        else
+        {
+            // Copy the identifiers since the callback may create or destroy entities
+            const TagIndex::IDs ids(Inst::Active());
+            // Process each entity in the pool
+            EachEqualsWhile(IBegin(ids), IEnd(ids), ValidInst(), InstTag(),
+                            std::reference_wrapper< ForwardElem >(fwd), tag, !neg, cs);
+        }
         // Return the forward count
         return fwd.mCount;
     }
@@ -1435,9 +1832,23 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element forwarder
         ForwardElemData fwd(data, env, func);
-        // Process each entity in the pool
-        EachEqualsWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
-                        std::reference_wrapper< ForwardElemData >(fwd), tag, !neg, cs);
+        // Can the tag index answer this?
+        if (!neg)
+        {
+            // Retrieve the matching entities from the tag index
+            TagIndex::IDs ids;
+            IndexEquals(cs, tag, ids);
+            // Process each matching entity
+            CollectWhile(IBegin(ids), IEnd(ids), ValidInst(), std::reference_wrapper< ForwardElemData >(fwd));
+        }
+        else
+        {
+            // Copy the identifiers since the callback may create or destroy entities
+            const TagIndex::IDs ids(Inst::Active());
+            // Process each entity in the pool
+            EachEqualsWhile(IBegin(ids), IEnd(ids), ValidInst(), InstTag(),
+                            std::reference_wrapper< ForwardElemData >(fwd), tag, !neg, cs);
+        }
         // Return the forward count
         return fwd.mCount;
     }
@@ -1450,9 +1861,23 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element forwarder
         ForwardElem fwd(env, func);
-        // Process each entity in the pool
-        EachBeginsWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
-                        std::reference_wrapper< ForwardElem >(fwd), tag, strlen(tag), !neg, cs);
+        // Can the tag index answer this?
+        if (!neg)
+        {
+            // Retrieve the matching entities from the tag index
+            TagIndex::IDs ids;
+            Inst::Tags().Begins(tag, cs, ids);
+            // Process each matching entity
+            CollectWhile(IBegin(ids), IEnd(ids), ValidInst(), std::reference_wrapper< ForwardElem >(fwd));
+        }
+        else
+        {
+            // Copy the identifiers since the callback may create or destroy entities
+            const TagIndex::IDs ids(Inst::Active());
+            // Process each entity in the pool
+            EachBeginsWhile(IBegin(ids), IEnd(ids), ValidInst(), InstTag(),
+                            std::reference_wrapper< ForwardElem >(fwd), tag, strlen(tag), !neg, cs);
+        }
         // Return the forward count
         return fwd.mCount;
     }
@@ -1465,9 +1890,23 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element forwarder
         ForwardElemData fwd(data, env, func);
-        // Process each entity in the pool
-        EachBeginsWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
-                        std::reference_wrapper< ForwardElemData >(fwd), tag, strlen(tag), !neg, cs);
+        // Can the tag index answer this?
+        if (!neg)
+        {
+            // Retrieve the matching entities from the tag index
+            TagIndex::IDs ids;
+            Inst::Tags().Begins(tag, cs, ids);
+            // Process each matching entity
+            CollectWhile(IBegin(ids), IEnd(ids), ValidInst(), std::reference_wrapper< ForwardElemData >(fwd));
+        }
+        else
+        {
+            // Copy the identifiers since the callback may create or destroy entities
+            const TagIndex::IDs ids(Inst::Active());
+            // Process each entity in the pool
+            EachBeginsWhile(IBegin(ids), IEnd(ids), ValidInst(), InstTag(),
+                            std::reference_wrapper< ForwardElemData >(fwd), tag, strlen(tag), !neg, cs);
+        }
         // Return the forward count
         return fwd.mCount;
     }
@@ -1480,8 +1919,10 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element forwarder
         ForwardElem fwd(env, func);
+        // Copy the identifiers since the callback may create or destroy entities
+        const TagIndex::IDs ids(Inst::Active());
         // Process each entity in the pool
-        EachEndsWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
+        EachEndsWhile(IBegin(ids), IEnd(ids), ValidInst(), InstTag(),
                         std::reference_wrapper< ForwardElem >(fwd), tag, strlen(tag), !neg, cs);
         // Return the forward count
         return fwd.mCount;
@@ -1495,8 +1936,10 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element forwarder
         ForwardElemData fwd(data, env, func);
+        // Copy the identifiers since the callback may create or destroy entities
+        const TagIndex::IDs ids(Inst::Active());
         // Process each entity in the pool
-        EachEndsWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
+        EachEndsWhile(IBegin(ids), IEnd(ids), ValidInst(), InstTag(),
                         std::reference_wrapper< ForwardElemData >(fwd), tag, strlen(tag), !neg, cs);
         // Return the forward count
         return fwd.mCount;
@@ -1510,8 +1953,10 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element forwarder
         ForwardElem fwd(env, func);
+        // Copy the identifiers since the callback may create or destroy entities
+        const TagIndex::IDs ids(Inst::Active());
         // Process each entity in the pool
-        EachContainsWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
+        EachContainsWhile(IBegin(ids), IEnd(ids), ValidInst(), InstTag(),
                         std::reference_wrapper< ForwardElem >(fwd), tag, !neg, cs);
         // Return the forward count
         return fwd.mCount;
@@ -1525,8 +1970,10 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element forwarder
         ForwardElemData fwd(data, env, func);
+        // Copy the identifiers since the callback may create or destroy entities
+        const TagIndex::IDs ids(Inst::Active());
         // Process each entity in the pool
-        EachContainsWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
+        EachContainsWhile(IBegin(ids), IEnd(ids), ValidInst(), InstTag(),
                         std::reference_wrapper< ForwardElemData >(fwd), tag, !neg, cs);
         // Return the forward count
         return fwd.mCount;
@@ -1540,8 +1987,10 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element forwarder
         ForwardElem fwd(env, func);
+        // Copy the identifiers since the callback may create or destroy entities
+        const TagIndex::IDs ids(Inst::Active());
         // Process each entity in the pool
-        EachMatchesWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
+        EachMatchesWhile(IBegin(ids), IEnd(ids), ValidInst(), InstTag(),
                         std::reference_wrapper< ForwardElem >(fwd), tag, !neg, cs);
         // Return the forward count
         return fwd.mCount;
@@ -1555,8 +2004,10 @@ public:
         SQMOD_VALID_TAG_STR(tag)
         // Create a new element forwarder
         ForwardElemData fwd(data, env, func);
+        // Copy the identifiers since the callback may create or destroy entities
+        const TagIndex::IDs ids(Inst::Active());
         // Process each entity in the pool
-        EachMatchesWhile(Inst::CBegin(), Inst::CEnd(), ValidInst(), InstTag(),
+        EachMatchesWhile(IBegin(ids), IEnd(ids), ValidInst(), InstTag(),
                         std::reference_wrapper< ForwardElemData >(fwd), tag, !neg, cs);
         // Return the forward count
         return fwd.mCount;
@@ -1567,13 +2018,8 @@ public:
     */
     static inline Uint32 CountActive()
     {
-        // Create a new element counter
-        CountElem cnt;
-        // Process each entity in the pool
-        Collect(Inst::CBegin(), Inst::CEnd(), ValidInst(),
-                        std::reference_wrapper< CountElem >(cnt));
-        // Return the count
-        return cnt;
+        // The active list holds exactly the allocated entities
+        return static_cast< Uint32 >(Inst::Active().size());
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -1582,6 +2028,13 @@ public:
     static inline Uint32 CountWhereTagEquals(bool neg, bool cs, CSStr tag)
     {
         SQMOD_VALID_TAG_STR(tag)
+        // Can the tag index answer this?
+        if (!neg)
+        {
+            const TagIndex::IDs * ids = Inst::Tags().Equals(tag, cs);
+            // Return the number of entities with this tag
+            return ids ? static_cast< Uint32 >(ids->size()) : 0;
+        }
         // Create a new element counter
         CountElem cnt;
         // Process each entity in the pool
@@ -1597,6 +2050,14 @@ public:
     static inline Uint32 CountWhereTagBegins(bool neg, bool cs, CSStr tag)
     {
         SQMOD_VALID_TAG_STR(tag)
+        // Can the tag index answer this?
+        if (!neg)
+        {
+            TagIndex::IDs ids;
+            Inst::Tags().Begins(tag, cs, ids);
+            // Return the number of entities with this prefix
+            return static_cast< Uint32 >(ids.size());
+        }
         // Create a new element counter
         CountElem cnt;
         // Process each entity in the pool
@@ -0,0 +1,125 @@
+// ------------------------------------------------------------------------------------------------
+#include "Base/Collector.hpp"
+#include "Base/Shared.hpp"
+#include "Library/Chrono.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+void Collector::Configure(bool enabled, Uint64 growth, Uint64 limit, Int64 budget)
+{
+    m_Enabled = enabled;
+    m_Growth = growth;
+    // The limit can't be lower than the growth that triggers a collection
+    m_Limit = std::max(growth, limit);
+    m_Budget = budget;
+    // Take a new baseline at the end of the next frame
+    m_Requested = false;
+    m_Primed = false;
+    m_Baseline = 0;
+    m_Blocks = 0;
+    // Forget the statistics
+    m_Collections = 0;
+    m_Forced = 0;
+    m_Postponed = 0;
+    m_Freed = 0;
+    m_LastPause = 0;
+    m_MaxPause = 0;
+    m_TotalPause = 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+Int64 Collector::Estimate(Uint64 blocks) const
+{
+    // Nothing to go by until a collection was timed
+    if (!m_Blocks)
+    {
+        return 0;
+    }
+    // Marking takes time proportional to the number of objects
+    return static_cast< Int64 >(static_cast< double >(m_LastPause) * blocks / m_Blocks);
+}
+
+// ------------------------------------------------------------------------------------------------
+Uint64 Collector::GetGrowth() const
+{
+    SQMemInfo info;
+    sq_vm_meminfo(&info);
+    // The memory in use may also shrink after a collection
+    return (m_Primed && info.bytes > m_Baseline) ? info.bytes - m_Baseline : 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger Collector::Collect(HSQUIRRELVM vm)
+{
+    SQMemInfo info;
+    sq_vm_meminfo(&info);
+    // Remember how many objects the collector had to go through
+    m_Blocks = info.blocks;
+    // Time the collection
+    const Int64 start = Chrono::GetCurrentSysTime();
+    const SQInteger freed = sq_collectgarbage(vm);
+    m_LastPause = Chrono::GetCurrentSysTime() - start;
+    // Update the statistics
+    ++m_Collections;
+    m_Freed += std::max(freed, SQInteger(0));
+    m_MaxPause = std::max(m_MaxPause, m_LastPause);
+    m_TotalPause += m_LastPause;
+    // Growth is measured from what remained after the collection
+    sq_vm_meminfo(&info);
+    m_Baseline = info.bytes;
+    m_Primed = true;
+    m_Requested = false;
+    // Return the number of freed objects
+    return freed;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Collector::Frame(HSQUIRRELVM vm, Int64 elapsed)
+{
+    if (!vm || (!m_Enabled && !m_Requested))
+    {
+        return; // Collections are up to the scripts
+    }
+    SQMemInfo info;
+    sq_vm_meminfo(&info);
+    // Measure growth from the memory in use after the scripts were loaded
+    if (!m_Primed)
+    {
+        m_Baseline = info.bytes;
+        m_Primed = true;
+    }
+    const Uint64 growth = info.bytes > m_Baseline ? info.bytes - m_Baseline : 0;
+    // Requested collections don't wait for the budget
+    if (!m_Requested)
+    {
+        // Is there enough reason to collect?
+        if (growth < m_Growth)
+        {
+            return;
+        }
+        // Would the collection fit in what's left of the frame?
+        const Int64 estimate = Estimate(info.blocks);
+        if (estimate > m_Budget - elapsed)
+        {
+            // Can it still wait?
+            if (growth < m_Limit)
+            {
+                ++m_Postponed;
+                return;
+            }
+            ++m_Forced;
+        }
+    }
+    const SQInteger freed = Collect(vm);
+    // Report the pause time
+    LogDbg("Garbage collection freed %lld objects in %lld microseconds (%llu bytes grown)",
+            static_cast< long long >(freed), static_cast< long long >(m_LastPause),
+            static_cast< unsigned long long >(growth));
+}
+
+} // Namespace:: SqMod
@@ -0,0 +1,155 @@
+#ifndef _BASE_COLLECTOR_HPP_
+#define _BASE_COLLECTOR_HPP_
+
+// ------------------------------------------------------------------------------------------------
+#include "Base/Utility.hpp"
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Schedules the cycle collector of the virtual machine at the end of server frames. Reference
+ * counting releases most objects as soon as they're unused, so the collector only has to run once
+ * the memory in use by the virtual machine grows enough to suggest there are cycles to collect.
+ *
+ * A collection stops everything while it runs and takes longer the more objects there are. Its
+ * duration is estimated from the previous one and it's postponed while it wouldn't fit in what is
+ * left of the frame budget, unless the memory in use grows past a limit.
+*/
+class Collector
+{
+private:
+
+    // --------------------------------------------------------------------------------------------
+    bool        m_Enabled; // Whether collections are scheduled automatically.
+    bool        m_Requested; // Whether a collection was requested for the end of the frame.
+    bool        m_Primed; // Whether the baseline was taken.
+    Uint64      m_Growth; // Growth in bytes that triggers a collection.
+    Uint64      m_Limit; // Growth in bytes that forces a collection regardless of the budget.
+    Int64       m_Budget; // Microseconds a frame may take, including the collection.
+    Uint64      m_Baseline; // Bytes in use after the last collection.
+    Uint64      m_Blocks; // Blocks in use when the last collection started.
+
+    // --------------------------------------------------------------------------------------------
+    Uint32      m_Collections; // Number of collections so far.
+    Uint32      m_Forced; // Number of collections that were expected to exceed the budget.
+    Uint32      m_Postponed; // Number of frames where a collection was postponed.
+    Int64       m_Freed; // Number of objects freed by the collections.
+    Int64       m_LastPause; // Duration of the last collection in microseconds.
+    Int64       m_MaxPause; // Duration of the longest collection in microseconds.
+    Int64       m_TotalPause; // Duration of all collections in microseconds.
+
+    /* --------------------------------------------------------------------------------------------
+     * Estimate the duration of a collection with the specified number of blocks in use.
+    */
+    Int64 Estimate(Uint64 blocks) const;
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    Collector()
+        : m_Enabled(false), m_Requested(false), m_Primed(false), m_Growth(0), m_Limit(0), m_Budget(0)
+        , m_Baseline(0), m_Blocks(0), m_Collections(0), m_Forced(0), m_Postponed(0), m_Freed(0)
+        , m_LastPause(0), m_MaxPause(0), m_TotalPause(0)
+    {
+        /* ... */
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Change the scheduling options and forget the statistics.
+    */
+    void Configure(bool enabled, Uint64 growth, Uint64 limit, Int64 budget);
+
+    /* --------------------------------------------------------------------------------------------
+     * Run a collection now and record its duration. Returns the number of freed objects.
+    */
+    SQInteger Collect(HSQUIRRELVM vm);
+
+    /* --------------------------------------------------------------------------------------------
+     * Run a collection at the end of the current frame.
+    */
+    void Request()
+    {
+        m_Requested = true;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Called at the end of a frame with the microseconds spent on it. Runs a collection if needed.
+    */
+    void Frame(HSQUIRRELVM vm, Int64 elapsed);
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether collections are scheduled automatically.
+    */
+    bool IsEnabled() const
+    {
+        return m_Enabled;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of collections so far.
+    */
+    Uint32 GetCollections() const
+    {
+        return m_Collections;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of collections that were expected to exceed the budget.
+    */
+    Uint32 GetForced() const
+    {
+        return m_Forced;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of frames where a collection was postponed.
+    */
+    Uint32 GetPostponed() const
+    {
+        return m_Postponed;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of objects freed by the collections.
+    */
+    Int64 GetFreed() const
+    {
+        return m_Freed;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the duration of the last collection in microseconds.
+    */
+    Int64 GetLastPause() const
+    {
+        return m_LastPause;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the duration of the longest collection in microseconds.
+    */
+    Int64 GetMaxPause() const
+    {
+        return m_MaxPause;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the duration of all collections in microseconds.
+    */
+    Int64 GetTotalPause() const
+    {
+        return m_TotalPause;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the growth in bytes since the last collection.
+    */
+    Uint64 GetGrowth() const;
+};
+
+} // Namespace:: SqMod
+
+#endif // _BASE_COLLECTOR_HPP_
@@ -0,0 +1,240 @@
+// ------------------------------------------------------------------------------------------------
+#include "Base/Metrics.hpp"
+#include "Base/Shared.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+Uint32 Histogram::Index(Uint64 value)
+{
+    // Small values have a bucket of their own
+    if (value < SUB_COUNT)
+    {
+        return static_cast< Uint32 >(value);
+    }
+    // Find the most significant bit
+    Uint32 msb = 0;
+    for (Uint64 v = value >> 1; v; v >>= 1)
+    {
+        ++msb;
+    }
+    // Each power of two is split by the bits that follow the most significant one
+    return (msb - SUB_BITS + 1) * SUB_COUNT +
+            static_cast< Uint32 >((value >> (msb - SUB_BITS)) & (SUB_COUNT - 1));
+}
+
+// ------------------------------------------------------------------------------------------------
+Uint64 Histogram::Highest(Uint32 index)
+{
+    if (index < SUB_COUNT)
+    {
+        return index;
+    }
+    const Uint32 shift = index / SUB_COUNT - 1;
+    // The lowest value of the bucket plus its width
+    return ((static_cast< Uint64 >(SUB_COUNT + index % SUB_COUNT) << shift) + (Uint64(1) << shift) - 1);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Histogram::Record(Uint64 value)
+{
+    ++m_Counts[Index(value)];
+    ++m_Count;
+    m_Total += value;
+    m_Min = std::min(m_Min, value);
+    m_Max = std::max(m_Max, value);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Histogram::Reset()
+{
+    std::memset(m_Counts, 0, sizeof(m_Counts));
+    m_Count = 0;
+    m_Total = 0;
+    m_Min = ~Uint64(0);
+    m_Max = 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+Uint64 Histogram::Percentile(double percent) const
+{
+    if (!m_Count)
+    {
+        return 0;
+    }
+    // Number of values that must be below the result
+    const Float64 share = std::min(percent, 100.0) / 100.0;
+    const Uint64 target = std::max(Uint64(1), static_cast< Uint64 >(std::ceil(m_Count * share)));
+    Uint64 seen = 0;
+    // Find the bucket where the target is reached
+    for (Uint32 idx = 0; idx < BUCKETS; ++idx)
+    {
+        seen += m_Counts[idx];
+        if (seen >= target)
+        {
+            return std::min(Highest(idx), m_Max);
+        }
+    }
+    return m_Max;
+}
+
+// ------------------------------------------------------------------------------------------------
+Int64 Metrics::Now()
+{
+    return std::chrono::duration_cast< std::chrono::microseconds >(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Metrics::Configure(bool enabled, Int64 interval)
+{
+    m_Enabled = enabled;
+    m_Interval = std::max(interval, Int64(0)) * 1000000;
+    Reset();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Metrics::Leave(Histogram & histogram, Int64 start)
+{
+    --m_Depth;
+    // Was this callback timed?
+    if (start < 0 || !m_Enabled)
+    {
+        return;
+    }
+    const Int64 elapsed = Now() - start;
+    histogram.Record(static_cast< Uint64 >(elapsed));
+    // Callbacks within callbacks are already part of the outer one
+    if (!m_Depth)
+    {
+        m_Pending[FP_EVENTS] += elapsed;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+Int64 Metrics::Phase(FramePhase phase, Int64 start)
+{
+    const Int64 now = Now();
+    m_Pending[phase] += now - start;
+    return now;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Metrics::Frame()
+{
+    if (m_Enabled)
+    {
+        Int64 total = 0;
+        // Record the time spent on each part of the frame
+        for (Uint32 phase = 0; phase < FP_TOTAL; ++phase)
+        {
+            m_Frame[phase].Record(static_cast< Uint64 >(m_Pending[phase]));
+            total += m_Pending[phase];
+        }
+        m_Frame[FP_TOTAL].Record(static_cast< Uint64 >(total));
+    }
+    // Start the next frame from scratch
+    std::fill(m_Pending, m_Pending + FP_MAX, 0);
+    // Is it time for a summary?
+    if (m_Enabled && m_Interval)
+    {
+        const Int64 now = Now();
+        if (!m_Summary)
+        {
+            m_Summary = now;
+        }
+        else if (now - m_Summary >= m_Interval)
+        {
+            Summarize();
+            // Each summary covers the time since the previous one
+            Reset();
+            m_Summary = now;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Metrics::Summarize() const
+{
+    const Histogram & total = m_Frame[FP_TOTAL];
+    LogInf("Frame times in microseconds over %llu frames: p50 %llu, p99 %llu, max %llu",
+            static_cast< unsigned long long >(total.GetCount()),
+            static_cast< unsigned long long >(total.Percentile(50.0)),
+            static_cast< unsigned long long >(total.Percentile(99.0)),
+            static_cast< unsigned long long >(total.GetMax()));
+    for (Uint32 phase = 0; phase < FP_TOTAL; ++phase)
+    {
+        const Histogram & hist = m_Frame[phase];
+        LogInf("  %-12s mean %.1f, p99 %llu, max %llu", GetPhaseName(static_cast< FramePhase >(phase)),
+                hist.GetMean(),
+                static_cast< unsigned long long >(hist.Percentile(99.0)),
+                static_cast< unsigned long long >(hist.GetMax()));
+    }
+    std::vector< const Callbacks::value_type * > busiest;
+    // Collect the callbacks that were made
+    for (const auto & cb : m_Callbacks)
+    {
+        if (cb.second.GetCount())
+        {
+            busiest.push_back(&cb);
+        }
+    }
+    // Order them by the total time spent on them
+    std::sort(busiest.begin(), busiest.end(),
+                [](const Callbacks::value_type * a, const Callbacks::value_type * b) {
+                    return a->second.GetTotal() > b->second.GetTotal();
+                });
+    // Show only the most expensive ones
+    if (busiest.size() > 5)
+    {
+        busiest.resize(5);
+    }
+    for (const auto cb : busiest)
+    {
+        LogInf("  %-24s calls %llu, total %llu, p50 %llu, p99 %llu, max %llu", cb->first.c_str(),
+                static_cast< unsigned long long >(cb->second.GetCount()),
+                static_cast< unsigned long long >(cb->second.GetTotal()),
+                static_cast< unsigned long long >(cb->second.Percentile(50.0)),
+                static_cast< unsigned long long >(cb->second.Percentile(99.0)),
+                static_cast< unsigned long long >(cb->second.GetMax()));
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Metrics::Reset()
+{
+    for (auto & cb : m_Callbacks)
+    {
+        cb.second.Reset();
+    }
+    for (auto & hist : m_Frame)
+    {
+        hist.Reset();
+    }
+    std::fill(m_Pending, m_Pending + FP_MAX, 0);
+    m_Summary = 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+CSStr Metrics::GetPhaseName(FramePhase phase)
+{
+    switch (phase)
+    {
+        case FP_EVENTS:     return _SC("Events");
+        case FP_ROUTINES:   return _SC("Routines");
+        case FP_TASKS:      return _SC("Tasks");
+        case FP_COLLECTOR:  return _SC("Collector");
+        case FP_TOTAL:      return _SC("Total");
+        default:            return _SC("Unknown");
+    }
+}
+
+} // Namespace:: SqMod
@@ -0,0 +1,281 @@
+#ifndef _BASE_METRICS_HPP_
+#define _BASE_METRICS_HPP_
+
+// ------------------------------------------------------------------------------------------------
+#include "Base/Utility.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <map>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Histogram of durations in microseconds. Values are counted in buckets whose width grows with
+ * the value, eight buckets for each power of two, so percentiles are accurate to within 12.5%
+ * regardless of the magnitude while the memory used stays fixed.
+*/
+class Histogram
+{
+public:
+
+    // --------------------------------------------------------------------------------------------
+    static const Uint32 SUB_BITS = 3; // Bits of precision below the most significant bit.
+    static const Uint32 SUB_COUNT = (1 << SUB_BITS); // Buckets for each power of two.
+    static const Uint32 BUCKETS = (64 - SUB_BITS + 1) * SUB_COUNT; // Buckets needed for any value.
+
+private:
+
+    // --------------------------------------------------------------------------------------------
+    Uint32  m_Counts[BUCKETS]; // Number of values in each bucket.
+    Uint64  m_Count; // Number of values.
+    Uint64  m_Total; // Sum of the values.
+    Uint64  m_Min; // Lowest value.
+    Uint64  m_Max; // Highest value.
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the bucket of the specified value.
+    */
+    static Uint32 Index(Uint64 value);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the highest value that falls into the specified bucket.
+    */
+    static Uint64 Highest(Uint32 index);
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    Histogram()
+    {
+        Reset();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Count the specified value.
+    */
+    void Record(Uint64 value);
+
+    /* --------------------------------------------------------------------------------------------
+     * Forget all values.
+    */
+    void Reset();
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the value below which the specified percentage of the values fall.
+    */
+    Uint64 Percentile(double percent) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of values.
+    */
+    Uint64 GetCount() const
+    {
+        return m_Count;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the sum of the values.
+    */
+    Uint64 GetTotal() const
+    {
+        return m_Total;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the lowest value.
+    */
+    Uint64 GetMin() const
+    {
+        return m_Count ? m_Min : 0;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the highest value.
+    */
+    Uint64 GetMax() const
+    {
+        return m_Max;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the average value.
+    */
+    Float64 GetMean() const
+    {
+        return m_Count ? static_cast< Float64 >(m_Total) / m_Count : 0.0;
+    }
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Time spent in the server callbacks and in each part of a server frame. Callbacks made while
+ * another one is in progress count towards their own histogram but not again towards the frame.
+*/
+class Metrics
+{
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Parts of a server frame.
+    */
+    enum FramePhase
+    {
+        FP_EVENTS = 0, // Server callbacks since the previous frame, including the frame event.
+        FP_ROUTINES, // Routines.
+        FP_TASKS, // Tasks.
+        FP_COLLECTOR, // Scheduled garbage collection.
+        FP_TOTAL, // All of the above.
+        FP_MAX
+    };
+
+    /* --------------------------------------------------------------------------------------------
+     * Times a server callback for as long as it exists.
+    */
+    class Timer
+    {
+        // ----------------------------------------------------------------------------------------
+        Metrics &   m_Metrics; // The instance that owns the histogram.
+        Histogram & m_Histogram; // Histogram of the callback.
+        Int64       m_Start; // When the callback started, or negative if not timed.
+
+    public:
+
+        /* ----------------------------------------------------------------------------------------
+         * Start timing the specified callback.
+        */
+        Timer(Metrics & metrics, Histogram & histogram)
+            : m_Metrics(metrics), m_Histogram(histogram), m_Start(metrics.Enter())
+        {
+            /* ... */
+        }
+
+        /* ----------------------------------------------------------------------------------------
+         * Stop timing the callback.
+        */
+        ~Timer()
+        {
+            m_Metrics.Leave(m_Histogram, m_Start);
+        }
+    };
+
+private:
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::map< String, Histogram > Callbacks; // Histogram of each callback by name.
+
+    // --------------------------------------------------------------------------------------------
+    bool        m_Enabled; // Whether anything is timed.
+    Uint32      m_Depth; // Callbacks in progress.
+    Callbacks   m_Callbacks; // Histogram of each callback.
+    Histogram   m_Frame[FP_MAX]; // Histogram of each part of a frame.
+    Int64       m_Pending[FP_MAX]; // Time spent on each part of the current frame.
+    Int64       m_Interval; // Microseconds between summaries in the log. Zero if disabled.
+    Int64       m_Summary; // When the last summary was written.
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    Metrics()
+        : m_Enabled(false), m_Depth(0), m_Callbacks(), m_Frame(), m_Pending(), m_Interval(0)
+        , m_Summary(0)
+    {
+        /* ... */
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the current time in microseconds from a monotonic clock.
+    */
+    static Int64 Now();
+
+    /* --------------------------------------------------------------------------------------------
+     * Change the options and forget the collected times.
+    */
+    void Configure(bool enabled, Int64 interval);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the histogram of the specified callback. The reference remains valid.
+    */
+    Histogram & Callback(CSStr name)
+    {
+        return m_Callbacks[name];
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * A callback has started. Returns when, or a negative value if not timed.
+    */
+    Int64 Enter()
+    {
+        ++m_Depth;
+        return m_Enabled ? Now() : -1;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * A callback that started at the specified time has ended.
+    */
+    void Leave(Histogram & histogram, Int64 start);
+
+    /* --------------------------------------------------------------------------------------------
+     * A part of the frame that started at the specified time has ended. Returns the current time.
+    */
+    Int64 Phase(FramePhase phase, Int64 start);
+
+    /* --------------------------------------------------------------------------------------------
+     * The frame has ended. Records its parts and writes a summary in the log when it's time.
+    */
+    void Frame();
+
+    /* --------------------------------------------------------------------------------------------
+     * Write a summary of the collected times in the log.
+    */
+    void Summarize() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Forget the collected times.
+    */
+    void Reset();
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether anything is timed.
+    */
+    bool IsEnabled() const
+    {
+        return m_Enabled;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Change whether anything is timed.
+    */
+    void SetEnabled(bool toggle)
+    {
+        m_Enabled = toggle;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the histograms of the callbacks.
+    */
+    const Callbacks & GetCallbacks() const
+    {
+        return m_Callbacks;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the histogram of the specified part of the frame.
+    */
+    const Histogram & GetFrame(FramePhase phase) const
+    {
+        return m_Frame[phase];
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the name of the specified part of the frame.
+    */
+    static CSStr GetPhaseName(FramePhase phase);
+};
+
+} // Namespace:: SqMod
+
+#endif // _BASE_METRICS_HPP_
@@ -0,0 +1,203 @@
+// ------------------------------------------------------------------------------------------------
+#include "Base/Profiler.hpp"
+#include "Base/Shared.hpp"
+#include "Library/Chrono.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <squirrelex.h>
+
+// ------------------------------------------------------------------------------------------------
+#include <cstdio>
+#include <chrono>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+static Profiler * g_Active = nullptr; // The profiler whose hook is installed.
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::Hook(HSQUIRRELVM vm, SQInteger type, CSStr source, SQInteger line, CSStr func)
+{
+    Profiler * p = g_Active;
+    // Let the previous hook see the event as well
+    if (p->m_Hook)
+    {
+        p->m_Hook(vm, type, source, line, func);
+    }
+    // Did the timer tick since the last sample?
+    const Uint32 ticks = p->m_Ticks.load(std::memory_order_relaxed);
+    if (ticks == p->m_Seen)
+    {
+        return;
+    }
+    SQStackInfos si;
+    // The ticks since the last event happened while no script was running if this call was made
+    // by the plug-in, so there's nothing to sample
+    if (type == 'c' && SQ_FAILED(sq_stackinfos(vm, 1, &si)))
+    {
+        p->m_Seen = ticks;
+        return;
+    }
+    p->Sample(vm, ticks - p->m_Seen);
+    p->m_Seen = ticks;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::Timer()
+{
+    std::unique_lock< std::mutex > lock(m_Mutex);
+    // Tick until asked to stop
+    while (!m_Wake.wait_for(lock, std::chrono::microseconds(m_Interval), [this] { return m_Stop; }))
+    {
+        m_Ticks.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::Sample(HSQUIRRELVM vm, Uint32 weight)
+{
+    m_Frames.clear();
+    // Collect the frames from the innermost one
+    SQStackInfos si;
+    for (SQInteger level = 0; SQ_SUCCEEDED(sq_stackinfos(vm, level, &si)); ++level)
+    {
+        m_Frames.push_back(si);
+    }
+    m_Folded.clear();
+    // The folded format lists the frames from the outermost one, separated by semicolons
+    for (std::vector< SQStackInfos >::reverse_iterator itr = m_Frames.rbegin(); itr != m_Frames.rend(); ++itr)
+    {
+        if (!m_Folded.empty())
+        {
+            m_Folded.push_back(';');
+        }
+        m_Folded.append(itr->funcname ? itr->funcname : _SC("<anonymous>"));
+        m_Folded.append(" (");
+        m_Folded.append(itr->source ? itr->source : _SC("unknown"));
+        // Native functions have no lines
+        if (itr->line >= 0)
+        {
+            m_Folded.append(":").append(std::to_string(itr->line));
+        }
+        m_Folded.push_back(')');
+    }
+    // Count the samples
+    m_Stacks[m_Folded] += weight;
+    m_Samples += weight;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::Configure(Uint32 interval, CSStr output)
+{
+    m_Default = interval ? interval : 1000;
+    m_Output.assign(output ? output : _SC(""));
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Profiler::Start(HSQUIRRELVM vm, Uint32 interval)
+{
+    // Is the specified virtual machine invalid?
+    if (!vm)
+    {
+        STHROWF("Invalid virtual machine to profile");
+    }
+    // Only one virtual machine can be profiled at once
+    else if (m_VM || g_Active)
+    {
+        return false;
+    }
+    m_VM = vm;
+    // Remember the current debug hook
+    m_Hook = sq_getnativedebughook(m_VM);
+    sq_getdebughook(m_VM);
+    m_Closure = LightObj(-1, m_VM);
+    sq_pop(m_VM, 1);
+    m_Interval = interval ? interval : m_Default;
+    m_Started = Chrono::GetCurrentSysTime();
+    m_Seen = m_Ticks.load();
+    m_Stop = false;
+    // Start ticking
+    m_Thread = std::thread(&Profiler::Timer, this);
+    // Begin sampling
+    g_Active = this;
+    sq_setnativedebughook(m_VM, &Profiler::Hook);
+    // Profiling has started
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::Stop()
+{
+    if (!m_VM)
+    {
+        return;
+    }
+    // Stop sampling and restore the previous debug hook
+    if (m_Hook)
+    {
+        sq_setnativedebughook(m_VM, m_Hook);
+    }
+    else
+    {
+        sq_pushobject(m_VM, m_Closure.GetObject());
+        sq_setdebughook(m_VM);
+    }
+    m_Hook = nullptr;
+    m_Closure.Release();
+    g_Active = nullptr;
+    // Stop ticking
+    {
+        std::lock_guard< std::mutex > lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_Wake.notify_one();
+    m_Thread.join();
+    // Remember how long it ran
+    m_Elapsed += Chrono::GetCurrentSysTime() - m_Started;
+    m_VM = nullptr;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::Clear()
+{
+    m_Stacks.clear();
+    m_Samples = 0;
+    m_Elapsed = 0;
+    m_Started = Chrono::GetCurrentSysTime();
+}
+
+// ------------------------------------------------------------------------------------------------
+Int64 Profiler::GetElapsed() const
+{
+    return m_Elapsed + (m_VM ? Chrono::GetCurrentSysTime() - m_Started : 0);
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Profiler::Dump(CSStr filename) const
+{
+    // Use the configured file if none was specified
+    if (!filename || *filename == '\0')
+    {
+        filename = m_Output.c_str();
+    }
+    if (*filename == '\0')
+    {
+        return false;
+    }
+    std::FILE * fp = std::fopen(filename, "w");
+    // Was the file opened?
+    if (!fp)
+    {
+        return false;
+    }
+    // Write one call stack per line, followed by the number of samples
+    for (const auto & stack : m_Stacks)
+    {
+        std::fprintf(fp, "%s %llu\n", stack.first.c_str(), static_cast< unsigned long long >(stack.second));
+    }
+    // Was everything written?
+    return (std::fclose(fp) == 0);
+}
+
+} // Namespace:: SqMod
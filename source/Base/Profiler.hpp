@@ -0,0 +1,167 @@
+#ifndef _BASE_PROFILER_HPP_
+#define _BASE_PROFILER_HPP_
+
+// ------------------------------------------------------------------------------------------------
+#include "Base/Utility.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <condition_variable>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Sampling profiler for scripts. A timer thread ticks at a fixed interval and the next call or return
+ * event of the virtual machine on the server thread takes the ticks as samples of the call stack.
+ * Scripts aren't compiled with line events, so a long loop without calls is sampled when it ends.
+ *
+ * Samples are aggregated by call stack, where each frame is identified by the function, source and
+ * current line, and can be written in the folded format used by flame graph tools.
+*/
+class Profiler
+{
+private:
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::unordered_map< String, Uint64 > Stacks; // Number of samples of each call stack.
+
+    // --------------------------------------------------------------------------------------------
+    HSQUIRRELVM             m_VM; // The virtual machine being profiled.
+    SQDEBUGHOOK             m_Hook; // Native debug hook that was installed before profiling.
+    LightObj                m_Closure; // Script debug hook that was installed before profiling.
+    Stacks                  m_Stacks; // Samples collected so far.
+    Uint64                  m_Samples; // Number of samples collected so far.
+    Uint32                  m_Interval; // Microseconds between samples.
+    Uint32                  m_Default; // Microseconds between samples if not specified.
+    String                  m_Output; // Where to write the samples if no file is specified.
+    Int64                   m_Started; // When the profiler was started.
+    Int64                   m_Elapsed; // Microseconds spent profiling, including previous runs.
+    Uint32                  m_Seen; // Ticks that were already taken as samples.
+    String                  m_Folded; // Buffer used to build the folded call stack.
+    std::vector< SQStackInfos > m_Frames; // Buffer used to walk the call stack.
+
+    // --------------------------------------------------------------------------------------------
+    std::atomic< Uint32 >   m_Ticks; // Ticks of the timer thread.
+    std::thread             m_Thread; // The timer thread.
+    std::mutex              m_Mutex; // Used to wake the timer thread when stopping.
+    std::condition_variable m_Wake; // Signaled when the timer thread must stop.
+    bool                    m_Stop; // Whether the timer thread must stop.
+
+    /* --------------------------------------------------------------------------------------------
+     * Debug hook installed in the virtual machine while profiling. Also forwards the events to the
+     * native hook that was installed before, if any.
+    */
+    static void Hook(HSQUIRRELVM vm, SQInteger type, CSStr source, SQInteger line, CSStr func);
+
+    /* --------------------------------------------------------------------------------------------
+     * Tick at the configured interval until asked to stop. (timer thread)
+    */
+    void Timer();
+
+    /* --------------------------------------------------------------------------------------------
+     * Record the current call stack of the virtual machine with the specified weight.
+    */
+    void Sample(HSQUIRRELVM vm, Uint32 weight);
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    Profiler()
+        : m_VM(nullptr), m_Hook(nullptr), m_Closure(), m_Stacks(), m_Samples(0), m_Interval(0), m_Default(1000), m_Output()
+        , m_Started(0), m_Elapsed(0), m_Seen(0), m_Folded(), m_Frames(), m_Ticks(0), m_Thread()
+        , m_Mutex(), m_Wake(), m_Stop(false)
+    {
+        /* ... */
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Destructor.
+    */
+    ~Profiler()
+    {
+        Stop();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Change the default interval and output file.
+    */
+    void Configure(Uint32 interval, CSStr output);
+
+    /* --------------------------------------------------------------------------------------------
+     * Start profiling the specified virtual machine. Uses the configured interval if zero.
+     * Returns false if it's already running. A script debug hook doesn't run while profiling.
+    */
+    bool Start(HSQUIRRELVM vm, Uint32 interval);
+
+    /* --------------------------------------------------------------------------------------------
+     * Stop profiling and restore the previous debug hook. The collected samples are kept until cleared.
+    */
+    void Stop();
+
+    /* --------------------------------------------------------------------------------------------
+     * Forget the collected samples.
+    */
+    void Clear();
+
+    /* --------------------------------------------------------------------------------------------
+     * Write the collected samples in the folded format to the specified file, or the configured
+     * one if not specified. Returns false on failure.
+    */
+    bool Dump(CSStr filename) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the profiler is running.
+    */
+    bool IsRunning() const
+    {
+        return m_VM != nullptr;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of samples collected so far.
+    */
+    Uint64 GetSamples() const
+    {
+        return m_Samples;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of distinct call stacks collected so far.
+    */
+    Uint64 GetStacks() const
+    {
+        return m_Stacks.size();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the microseconds spent profiling since the samples were last cleared.
+    */
+    Int64 GetElapsed() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the file where the samples are written if no file is specified.
+    */
+    const String & GetOutput() const
+    {
+        return m_Output;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the microseconds between samples.
+    */
+    Uint32 GetInterval() const
+    {
+        return m_Interval;
+    }
+};
+
+} // Namespace:: SqMod
+
+#endif // _BASE_PROFILER_HPP_
@@ -0,0 +1,649 @@
+// ------------------------------------------------------------------------------------------------
+#include "Base/ScriptCache.hpp"
+#include "Base/Shared.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <algorithm>
+#include <functional>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+static const char   CACHE_MAGIC[4] = {'S', 'Q', 'M', 'C'}; // Identifies a cached script file.
+static const Uint32 CACHE_FORMAT = 1; // Version of the cached script file layout.
+static const Uint32 CACHE_COMPILER = 1; // Version of the code generated by the bundled compiler.
+
+/* ------------------------------------------------------------------------------------------------
+ * Identifies the compiler which compiled a cached script. The version of the generated code must be
+ * bumped whenever a change to the bundled compiler alters the output for the same source.
+*/
+static Uint64 CompilerHash()
+{
+    static const char ident[] = SQUIRREL_VERSION;
+    // Also include the size of the types that end up in the compiled code
+    const Uint32 sizes[] = {
+        CACHE_COMPILER,
+        static_cast< Uint32 >(sizeof(SQInteger)), static_cast< Uint32 >(sizeof(SQFloat)),
+        static_cast< Uint32 >(sizeof(SQChar)), static_cast< Uint32 >(sizeof(SQUserPointer))
+    };
+    return ScriptSrc::Hash(reinterpret_cast< CCStr >(sizes), sizeof(sizes), ScriptSrc::Hash(ident, sizeof(ident) - 1));
+}
+
+// ------------------------------------------------------------------------------------------------
+template < typename T > static inline void Put(String & out, T value)
+{
+    out.append(reinterpret_cast< CCStr >(&value), sizeof(T));
+}
+
+// ------------------------------------------------------------------------------------------------
+template < typename T > static inline bool Get(CCStr & data, CCStr end, T & value)
+{
+    if (static_cast< size_t >(end - data) < sizeof(T))
+    {
+        return false;
+    }
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+static bool ReadFile(CSStr path, String & data)
+{
+    std::FILE * fp = std::fopen(path, "rb");
+    // Could the file be opened?
+    if (!fp)
+    {
+        return false;
+    }
+    // Find out how big the file is
+    std::fseek(fp, 0, SEEK_END);
+    const long length = std::ftell(fp);
+    std::fseek(fp, 0, SEEK_SET);
+    // Read the whole file at once
+    bool ok = (length >= 0);
+    if (ok)
+    {
+        data.resize(static_cast< size_t >(length));
+        ok = (length == 0 || std::fread(&data[0], 1, data.size(), fp) == data.size());
+    }
+    std::fclose(fp);
+    // Return whether the file was read
+    return ok;
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger WriteToString(SQUserPointer up, SQUserPointer data, SQInteger size)
+{
+    static_cast< String * >(up)->append(static_cast< CCStr >(data), static_cast< size_t >(size));
+    return size;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Range of memory from which the compiled code is read.
+*/
+struct ReadRange
+{
+    CCStr   mData; // Current position in the range.
+    CCStr   mEnd; // Where the range ends.
+};
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger ReadFromRange(SQUserPointer up, SQUserPointer data, SQInteger size)
+{
+    ReadRange & r = *static_cast< ReadRange * >(up);
+    // Don't read past the end of the range
+    const SQInteger count = std::min(size, static_cast< SQInteger >(r.mEnd - r.mData));
+    std::memcpy(data, r.mData, static_cast< size_t >(count));
+    r.mData += count;
+    // Return how much was read
+    return count;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ScriptCache::Configure(bool enabled, CSStr directory, Uint32 threads)
+{
+    m_Enabled = enabled;
+    m_Threads = threads;
+    m_Directory.assign(directory ? directory : _SC(""));
+    // Make sure the directory ends with a separator
+    if (!m_Directory.empty() && m_Directory.back() != '/' && m_Directory.back() != '\\')
+    {
+        m_Directory.push_back('/');
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+String ScriptCache::CachePath(const String & path) const
+{
+    // Store it next to the script if there's no cache directory
+    if (m_Directory.empty())
+    {
+        return path + _SC(".cnut");
+    }
+    // Name the file after the path of the script (without the shared buffer, workers use this too)
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.cnut",
+                    static_cast< unsigned long long >(ScriptSrc::Hash(path.data(), path.size())));
+    return m_Directory + name;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ScriptCache::EncodeValue(HSQUIRRELVM vm, SQInteger idx, String & out)
+{
+    // Make sure the index doesn't change when pushing values on the stack
+    if (idx < 0)
+    {
+        idx = sq_gettop(vm) + idx + 1;
+    }
+    // Encode the value according to its type
+    switch (sq_gettype(vm, idx))
+    {
+        case OT_NULL:
+        {
+            out.push_back('n');
+        } break;
+        case OT_BOOL:
+        {
+            SQBool value = SQFalse;
+            sq_getbool(vm, idx, &value);
+            out.push_back('b');
+            out.push_back(value ? 1 : 0);
+        } break;
+        case OT_INTEGER:
+        {
+            SQInteger value = 0;
+            sq_getinteger(vm, idx, &value);
+            out.push_back('i');
+            Put(out, value);
+        } break;
+        case OT_FLOAT:
+        {
+            SQFloat value = 0;
+            sq_getfloat(vm, idx, &value);
+            out.push_back('f');
+            Put(out, value);
+        } break;
+        case OT_STRING:
+        {
+            CSStr value = nullptr;
+            sq_getstring(vm, idx, &value);
+            const Uint32 size = ConvTo< Uint32 >::From(sq_getsize(vm, idx));
+            out.push_back('s');
+            Put(out, size);
+            out.append(value, size);
+        } break;
+        case OT_TABLE:
+        {
+            out.push_back('t');
+            Put(out, ConvTo< Uint32 >::From(sq_getsize(vm, idx)));
+            // Encode each element of the table (enumerations)
+            sq_pushnull(vm);
+            while (SQ_SUCCEEDED(sq_next(vm, idx)))
+            {
+                if (!EncodeValue(vm, -2, out) || !EncodeValue(vm, -1, out))
+                {
+                    sq_pop(vm, 3);
+                    return false;
+                }
+                sq_pop(vm, 2);
+            }
+            sq_pop(vm, 1);
+        } break;
+        // Anything else can't be created by the compiler
+        default: return false;
+    }
+    // The value was encoded
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ScriptCache::DecodeValue(HSQUIRRELVM vm, CCStr & data, CCStr end)
+{
+    char type = 0;
+    // Identify the type of the value
+    if (!Get(data, end, type))
+    {
+        return false;
+    }
+    // Decode the value according to its type
+    switch (type)
+    {
+        case 'n':
+        {
+            sq_pushnull(vm);
+        } break;
+        case 'b':
+        {
+            char value = 0;
+            if (!Get(data, end, value))
+            {
+                return false;
+            }
+            sq_pushbool(vm, value ? SQTrue : SQFalse);
+        } break;
+        case 'i':
+        {
+            SQInteger value = 0;
+            if (!Get(data, end, value))
+            {
+                return false;
+            }
+            sq_pushinteger(vm, value);
+        } break;
+        case 'f':
+        {
+            SQFloat value = 0;
+            if (!Get(data, end, value))
+            {
+                return false;
+            }
+            sq_pushfloat(vm, value);
+        } break;
+        case 's':
+        {
+            Uint32 size = 0;
+            if (!Get(data, end, size) || static_cast< size_t >(end - data) < size)
+            {
+                return false;
+            }
+            sq_pushstring(vm, data, static_cast< SQInteger >(size));
+            data += size;
+        } break;
+        case 't':
+        {
+            Uint32 size = 0;
+            if (!Get(data, end, size))
+            {
+                return false;
+            }
+            sq_newtableex(vm, static_cast< SQInteger >(size));
+            // Decode each element of the table
+            while (size--)
+            {
+                if (!DecodeValue(vm, data, end) || !DecodeValue(vm, data, end) ||
+                    SQ_FAILED(sq_newslot(vm, -3, SQFalse)))
+                {
+                    return false;
+                }
+            }
+        } break;
+        // Anything else means the data is malformed
+        default: return false;
+    }
+    // The value was decoded
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ScriptCache::EncodeConsts(HSQUIRRELVM vm, Consts & consts)
+{
+    const SQInteger top = sq_gettop(vm);
+    // Grab the constant table
+    sq_pushconsttable(vm);
+    // Encode each constant
+    sq_pushnull(vm);
+    while (SQ_SUCCEEDED(sq_next(vm, -2)))
+    {
+        CSStr name = nullptr;
+        // Constants are always named
+        if (sq_gettype(vm, -2) != OT_STRING)
+        {
+            sq_settop(vm, top);
+            return false;
+        }
+        sq_getstring(vm, -2, &name);
+        // Encode the value of the constant
+        String & value = consts[String(name, static_cast< size_t >(sq_getsize(vm, -2)))];
+        if (!EncodeValue(vm, -1, value))
+        {
+            sq_settop(vm, top);
+            return false;
+        }
+        sq_pop(vm, 2);
+    }
+    // Restore the stack
+    sq_settop(vm, top);
+    // The constants were encoded
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+Uint64 ScriptCache::HashConsts(const Consts & consts)
+{
+    Uint64 hash = ScriptSrc::Hash(nullptr, 0);
+    // Hash the names and values in order
+    for (const auto & c : consts)
+    {
+        hash = ScriptSrc::Hash(c.first.data(), c.first.size() + 1, hash);
+        hash = ScriptSrc::Hash(c.second.data(), c.second.size(), hash);
+    }
+    return hash;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ScriptCache::CheckHeader(CCStr & data, CCStr end, Uint64 src_hash, Uint64 const_hash)
+{
+    char magic[sizeof(CACHE_MAGIC)];
+    Uint32 format = 0;
+    Uint64 compiler = 0, source = 0, consts = 0;
+    // Validate each field of the header
+    return (Get(data, end, magic) && std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) == 0 &&
+            Get(data, end, format) && format == CACHE_FORMAT &&
+            Get(data, end, compiler) && compiler == CompilerHash() &&
+            Get(data, end, source) && source == src_hash &&
+            Get(data, end, consts) && consts == const_hash);
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ScriptCache::Load(HSQUIRRELVM vm, ScriptSrc & src, const String & data, Uint64 src_hash, Uint64 const_hash)
+{
+    CCStr ptr = data.data(), end = data.data() + data.size();
+    Uint32 count = 0;
+    // Validate the header
+    if (!CheckHeader(ptr, end, src_hash, const_hash) || !Get(ptr, end, count))
+    {
+        return false;
+    }
+    const SQInteger top = sq_gettop(vm);
+    // Decode the constants defined by the script into a temporary table
+    sq_newtable(vm);
+    while (count--)
+    {
+        if (!DecodeValue(vm, ptr, end) || !DecodeValue(vm, ptr, end) || SQ_FAILED(sq_newslot(vm, -3, SQFalse)))
+        {
+            sq_settop(vm, top);
+            return false;
+        }
+    }
+    // Load the compiled code
+    ReadRange range{ptr, end};
+    if (SQ_FAILED(sq_readclosure(vm, &ReadFromRange, &range)))
+    {
+        sq_settop(vm, top);
+        return false;
+    }
+    // Only now define the constants, as if the script was compiled
+    sq_pushconsttable(vm);
+    sq_pushnull(vm);
+    while (SQ_SUCCEEDED(sq_next(vm, top + 1)))
+    {
+        sq_newslot(vm, -4, SQFalse);
+    }
+    // Take ownership of the compiled code
+    static_cast< Object & >(src.mExec) = Object(top + 2, vm);
+    // Restore the stack
+    sq_settop(vm, top);
+    // The script was loaded
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ScriptCache::Serialize(HSQUIRRELVM vm, Uint64 src_hash, Uint64 const_hash,
+                            const Consts & before, const Consts & after, String & data)
+{
+    data.clear();
+    // Write the header
+    data.append(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    Put(data, CACHE_FORMAT);
+    Put(data, CompilerHash());
+    Put(data, src_hash);
+    Put(data, const_hash);
+    // Write the constants that the script defined or changed
+    const size_t count_pos = data.size();
+    Uint32 count = 0;
+    Put(data, count);
+    for (const auto & c : after)
+    {
+        Consts::const_iterator itr = before.find(c.first);
+        // Was this constant defined or changed by the script?
+        if (itr == before.end() || itr->second != c.second)
+        {
+            data.push_back('s');
+            Put(data, ConvTo< Uint32 >::From(c.first.size()));
+            data.append(c.first);
+            data.append(c.second);
+            ++count;
+        }
+    }
+    std::memcpy(&data[count_pos], &count, sizeof(count));
+    // Write the compiled code
+    return SQ_SUCCEEDED(sq_writeclosure(vm, &WriteToString, &data));
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ScriptCache::Store(const String & cache, const String & data)
+{
+    // Write to a temporary file first so a partial file is never used
+    const String temp(cache + _SC(".tmp"));
+    std::FILE * fp = std::fopen(temp.c_str(), "wb");
+    if (!fp)
+    {
+        return false;
+    }
+    const bool written = (std::fwrite(data.data(), 1, data.size(), fp) == data.size());
+    // Make sure everything was written
+    if ((std::fclose(fp) != 0) || !written)
+    {
+        std::remove(temp.c_str());
+        return false;
+    }
+    // Replace the previous file, if any
+    std::remove(cache.c_str());
+    if (std::rename(temp.c_str(), cache.c_str()) != 0)
+    {
+        std::remove(temp.c_str());
+        return false;
+    }
+    // The script was stored
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ScriptCache::Worker(Jobs & jobs, std::atomic< size_t > & next, const Consts & consts, Uint64 const_hash) const
+{
+    // Each worker compiles with its own virtual machine
+    HSQUIRRELVM vm = sq_open(1024);
+    // Define the same constants as the main virtual machine
+    HSQOBJECT base;
+    sq_newtable(vm);
+    for (const auto & c : consts)
+    {
+        CCStr ptr = c.second.data();
+        sq_pushstring(vm, c.first.data(), static_cast< SQInteger >(c.first.size()));
+        DecodeValue(vm, ptr, ptr + c.second.size());
+        sq_newslot(vm, -3, SQFalse);
+    }
+    sq_getstackobj(vm, -1, &base);
+    // Process scripts until there are none left
+    for (size_t idx = next++; idx < jobs.size(); idx = next++)
+    {
+        ScriptSrc & src = *(jobs[idx].first);
+        Compiled & out = *(jobs[idx].second);
+        // Compiled scripts can't be prepared in advance
+        if (!src.Read() || !src.IsPlainText())
+        {
+            continue;
+        }
+        const Uint64 src_hash = src.mHash;
+        const String cache(CachePath(src.mPath));
+        out.mConsts = const_hash;
+        // Is there a valid compiled script in the cache?
+        if (m_Enabled && ReadFile(cache.c_str(), out.mData))
+        {
+            CCStr ptr = out.mData.data();
+            if (CheckHeader(ptr, ptr + out.mData.size(), src_hash, const_hash))
+            {
+                out.mStored = true;
+                continue;
+            }
+        }
+        out.mData.clear();
+        // Start from the constants of the main virtual machine
+        sq_pushobject(vm, base);
+        sq_clone(vm, -1);
+        sq_setconsttable(vm);
+        sq_pop(vm, 1);
+        // Attempt to compile the script. Errors are reported when compiled again by the main thread
+        const size_t offset = (src.mData.compare(0, 3, "\xEF\xBB\xBF") == 0) ? 3 : 0;
+        if (SQ_FAILED(sq_compilebuffer(vm, src.mData.data() + offset,
+                                        static_cast< SQInteger >(src.mData.size() - offset),
+                                        src.mPath.c_str(), SQFalse)))
+        {
+            continue;
+        }
+        // Serialize the compiled code and the constants it defined
+        Consts after;
+        if (!EncodeConsts(vm, after) || !Serialize(vm, src_hash, const_hash, consts, after, out.mData))
+        {
+            out.mData.clear();
+        }
+        sq_pop(vm, 1);
+    }
+    // Release the worker virtual machine
+    sq_pop(vm, 1);
+    sq_close(vm);
+}
+
+// ------------------------------------------------------------------------------------------------
+void ScriptCache::Precompile(Scripts::iterator itr, Scripts::iterator end)
+{
+    // Skip the scripts which are already compiled
+    while (itr != end && !itr->mExec.IsNull())
+    {
+        ++itr;
+    }
+    // Is parallel compilation disabled, or was the next script already prepared?
+    if (!m_Threads || itr == end || m_Precompiled.count(itr->mPath))
+    {
+        return;
+    }
+    // Scripts are compiled with the constants that exist now
+    Consts consts;
+    if (!EncodeConsts(itr->mExec.GetVM(), consts))
+    {
+        return;
+    }
+    const Uint64 const_hash = HashConsts(consts);
+    // Anything prepared before was prepared with other constants
+    m_Precompiled.clear();
+    // Prepare the remaining scripts
+    Jobs jobs;
+    for (; itr != end; ++itr)
+    {
+        if (itr->mExec.IsNull())
+        {
+            jobs.emplace_back(&(*itr), &m_Precompiled[itr->mPath]);
+        }
+    }
+    // Is there anything worth doing in parallel?
+    if (jobs.size() < 2)
+    {
+        m_Precompiled.clear();
+        return;
+    }
+    std::atomic< size_t > next(0);
+    // Start the workers
+    std::vector< std::thread > workers;
+    for (Uint32 n = std::min(m_Threads, static_cast< Uint32 >(jobs.size())); n; --n)
+    {
+        workers.emplace_back(&ScriptCache::Worker, this, std::ref(jobs), std::ref(next),
+                                std::cref(consts), const_hash);
+    }
+    // Wait for all the scripts to be prepared
+    for (auto & t : workers)
+    {
+        t.join();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ScriptCache::Process(ScriptSrc & src)
+{
+    // Let the compiler deal with unreadable, compiled and UCS-2 encoded scripts
+    if (!src.Read() || !src.IsPlainText())
+    {
+        src.mExec.CompileFile(src.mPath);
+        return false;
+    }
+    // Is there nothing to look up?
+    else if (!m_Enabled && m_Precompiled.empty())
+    {
+        src.Compile();
+        return false;
+    }
+    HSQUIRRELVM vm = src.mExec.GetVM();
+    // The constants defined until now affect the compiled code
+    Consts before;
+    const bool cacheable = EncodeConsts(vm, before);
+    const Uint64 src_hash = src.mHash;
+    const Uint64 const_hash = HashConsts(before);
+    const String cache(CachePath(src.mPath));
+    // Was the script prepared in advance?
+    Precompiled::iterator pitr = m_Precompiled.find(src.mPath);
+    if (pitr != m_Precompiled.end())
+    {
+        const Compiled c(std::move(pitr->second));
+        m_Precompiled.erase(pitr);
+        // Was it prepared with the same constants?
+        if (cacheable && c.mConsts == const_hash && Load(vm, src, c.mData, src_hash, const_hash))
+        {
+            // Should it be stored in the cache?
+            if (m_Enabled && !c.mStored && !Store(cache, c.mData))
+            {
+                LogWrn("Unable to cache compiled script: %s", cache.c_str());
+            }
+            ++(c.mStored ? m_Hits : m_Misses);
+            // Let the caller know where the code came from
+            return c.mStored;
+        }
+        // The constants changed so the remaining scripts must be prepared again
+        else if (c.mConsts != const_hash)
+        {
+            m_Precompiled.clear();
+        }
+    }
+    // Attempt to load the script from the cache
+    if (m_Enabled && cacheable)
+    {
+        String data;
+        if (ReadFile(cache.c_str(), data) && Load(vm, src, data, src_hash, const_hash))
+        {
+            ++m_Hits;
+            return true;
+        }
+    }
+    ++m_Misses;
+    // Compile the script
+    src.Compile();
+    // Attempt to store the compiled script in the cache
+    Consts after;
+    if (m_Enabled && cacheable && EncodeConsts(vm, after))
+    {
+        String data;
+        sq_pushobject(vm, src.mExec.GetObject());
+        if (!Serialize(vm, src_hash, const_hash, before, after, data) || !Store(cache, data))
+        {
+            LogWrn("Unable to cache compiled script: %s", cache.c_str());
+        }
+        sq_pop(vm, 1);
+    }
+    // The script was compiled
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ScriptCache::Compile(ScriptSrc & src)
+{
+    const bool cached = Process(src);
+    // The contents are no longer needed unless they're used for line information
+    src.Discard();
+    // Let the caller know where the code came from
+    return cached;
+}
+
+} // Namespace:: SqMod
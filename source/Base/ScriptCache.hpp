@@ -0,0 +1,177 @@
+#ifndef _BASE_SCRIPTCACHE_HPP_
+#define _BASE_SCRIPTCACHE_HPP_
+
+// ------------------------------------------------------------------------------------------------
+#include "Base/ScriptSrc.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <map>
+#include <atomic>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Cache of compiled scripts on disk. A cached script is used only if the contents of the source
+ * file, the compiler and the constants that existed when it was compiled are the same. Otherwise,
+ * the script is compiled and the cache is updated.
+ *
+ * The compiler stores constants and enumerations in the constant table of the virtual machine
+ * instead of the compiled code, and uses the constants defined by previous scripts. Therefore the
+ * constants that a script defines are stored next to its compiled code and defined again when it
+ * is loaded from the cache.
+ *
+ * Scripts can also be compiled in advance by worker threads, each with its own virtual machine,
+ * into the same format as the cached files. The main virtual machine then loads them in order.
+*/
+class ScriptCache
+{
+public:
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::map< String, String > Consts; // Encoded constants sorted by name.
+    typedef std::vector< ScriptSrc > Scripts; // List of scripts.
+
+private:
+
+    /* --------------------------------------------------------------------------------------------
+     * Script prepared in advance by a worker thread.
+    */
+    struct Compiled
+    {
+        String      mData; // The compiled script, in the same format as the cached files.
+        Uint64      mConsts; // Hash of the constants it was compiled with.
+        bool        mStored; // Whether it was found in the cache.
+    };
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::unordered_map< String, Compiled > Precompiled; // Prepared scripts by path.
+    typedef std::vector< std::pair< ScriptSrc *, Compiled * > > Jobs; // Scripts to prepare.
+
+    // --------------------------------------------------------------------------------------------
+    bool        m_Enabled; // Whether compiled scripts are cached.
+    String      m_Directory; // Where to store the compiled scripts. Next to the source if empty.
+    Uint32      m_Threads; // Number of threads used to compile scripts in advance.
+    Precompiled m_Precompiled; // Scripts that were compiled in advance.
+    Uint32      m_Hits; // Number of scripts that were loaded from the cache.
+    Uint32      m_Misses; // Number of scripts that had to be compiled.
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the path of the file where the specified script is cached.
+    */
+    String CachePath(const String & path) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Encode the value at the specified stack index. Returns false if the type is not supported.
+    */
+    static bool EncodeValue(HSQUIRRELVM vm, SQInteger idx, String & out);
+
+    /* --------------------------------------------------------------------------------------------
+     * Decode a value and push it on the stack. Returns false if the data is malformed.
+    */
+    static bool DecodeValue(HSQUIRRELVM vm, CCStr & data, CCStr end);
+
+    /* --------------------------------------------------------------------------------------------
+     * Encode the constant table of the virtual machine. Returns false if it can't be encoded.
+    */
+    static bool EncodeConsts(HSQUIRRELVM vm, Consts & consts);
+
+    /* --------------------------------------------------------------------------------------------
+     * Compute a hash of the specified constants. The compiler folds constants into the code, so the
+     * whole table is hashed rather than just the constants a script refers to. Defining, removing
+     * or changing any constant before the scripts are compiled invalidates every cached script.
+    */
+    static Uint64 HashConsts(const Consts & consts);
+
+    /* --------------------------------------------------------------------------------------------
+     * Validate the header of a compiled script and skip it. Returns false if it doesn't match.
+    */
+    static bool CheckHeader(CCStr & data, CCStr end, Uint64 src_hash, Uint64 const_hash);
+
+    /* --------------------------------------------------------------------------------------------
+     * Attempt to load the script from the specified cache data. Returns false on failure.
+    */
+    static bool Load(HSQUIRRELVM vm, ScriptSrc & src, const String & data, Uint64 src_hash, Uint64 const_hash);
+
+    /* --------------------------------------------------------------------------------------------
+     * Serialize the compiled script on the stack and the constants it defined. Returns false on failure.
+    */
+    static bool Serialize(HSQUIRRELVM vm, Uint64 src_hash, Uint64 const_hash,
+                            const Consts & before, const Consts & after, String & data);
+
+    /* --------------------------------------------------------------------------------------------
+     * Attempt to write a serialized script to the specified cache file. Returns false on failure.
+    */
+    static bool Store(const String & cache, const String & data);
+
+    /* --------------------------------------------------------------------------------------------
+     * Compile scripts in advance with a separate virtual machine. (worker thread)
+    */
+    void Worker(Jobs & jobs, std::atomic< size_t > & next, const Consts & consts, Uint64 const_hash) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Compile the specified script or load it from the cache. Returns true if it was loaded from the
+     * cache.
+    */
+    bool Process(ScriptSrc & src);
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    ScriptCache()
+        : m_Enabled(false), m_Directory(), m_Threads(0), m_Precompiled(), m_Hits(0), m_Misses(0)
+    {
+        /* ... */
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Change the cache options.
+    */
+    void Configure(bool enabled, CSStr directory, Uint32 threads);
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether compiled scripts are cached.
+    */
+    bool IsEnabled() const
+    {
+        return m_Enabled;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of scripts that were loaded from the cache.
+    */
+    Uint32 GetHits() const
+    {
+        return m_Hits;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of scripts that had to be compiled.
+    */
+    Uint32 GetMisses() const
+    {
+        return m_Misses;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Compile the specified scripts in advance on worker threads, unless the first one that isn't
+     * compiled yet was already prepared. Scripts are prepared with the constants that exist now and
+     * prepared again if that changes by the time they're compiled.
+    */
+    void Precompile(Scripts::iterator itr, Scripts::iterator end);
+
+    /* --------------------------------------------------------------------------------------------
+     * Compile the specified script or load it from the cache. Returns true if it was loaded from the
+     * cache. Throws on compilation errors.
+    */
+    bool Compile(ScriptSrc & src);
+};
+
+} // Namespace:: SqMod
+
+#endif // _BASE_SCRIPTCACHE_HPP_
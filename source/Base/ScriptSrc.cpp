@@ -3,6 +3,8 @@
 
 // ------------------------------------------------------------------------------------------------
 #include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
 #include <algorithm>
 #include <stdexcept>
 
@@ -25,10 +27,7 @@ public:
     FileHandle(CSStr path)
         : mFile(std::fopen(path, "rb"))
     {
-        if (!mFile)
-        {
-            throw std::runtime_error(ToStrF("Unable to open script source (%s)", path));
-        }
+        /* ... */
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -81,29 +80,126 @@ public:
 
 
 // ------------------------------------------------------------------------------------------------
-void ScriptSrc::Process()
+Uint64 ScriptSrc::Hash(CCStr data, size_t size, Uint64 hash)
+{
+    // FNV-1a
+    for (CCStr end = data + size; data != end; ++data)
+    {
+        hash = (hash ^ static_cast< unsigned char >(*data)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// ------------------------------------------------------------------------------------------------
+Int64 ScriptSrc::ModificationTime(CSStr path)
 {
+    struct stat st;
+    // Attempt to retrieve the file information
+    if (::stat(path, &st) != 0)
+    {
+        return -1;
+    }
+    // Return the modification time
+    return static_cast< Int64 >(st.st_mtime);
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ScriptSrc::Read()
+{
+    // Were the contents already read?
+    if (!mData.empty())
+    {
+        return true;
+    }
+    // Remember when the file was modified, before reading it
+    mTime = ModificationTime(mPath.c_str());
     // Attempt to open the specified file
     FileHandle fp(mPath.c_str());
-    // First 2 bytes of the file will tell if this is a compiled script
-    std::uint16_t tag;
+    // Could the file be opened?
+    if (!fp)
+    {
+        return false;
+    }
     // Go to the end of the file
     std::fseek(fp, 0, SEEK_END);
     // Calculate buffer size from beginning to current position
     const LongI length = std::ftell(fp);
     // Go back to the beginning
     std::fseek(fp, 0, SEEK_SET);
-    // Read the first 2 bytes of the file and determine the file type
-    if ((length >= 2) && (std::fread(&tag, 1, 2, fp) != 2 || tag == SQ_BYTECODE_STREAM_TAG))
+    // Is the file empty or unreadable?
+    if (length <= 0)
     {
-        return; // Probably an empty file or compiled script
+        mHash = Hash(nullptr, 0);
+        // Only an empty file counts as read
+        return (length == 0);
     }
     // Allocate enough space to hold the file data
     mData.resize(length, 0);
-    // Go back to the beginning
-    std::fseek(fp, 0, SEEK_SET);
     // Read the file contents into allocated data
-    std::fread(&mData[0], 1, length, fp);
+    if (std::fread(&mData[0], 1, length, fp) != static_cast< size_t >(length))
+    {
+        mData.clear();
+        // Failed to read the file contents
+        return false;
+    }
+    // Remember what was read
+    mHash = Hash(mData.data(), mData.size());
+    // The contents were read
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ScriptSrc::IsPlainText() const
+{
+    // Is there enough data to identify the file type?
+    if (mData.size() < 2)
+    {
+        return true;
+    }
+    // First 2 bytes of the file will tell if this is a compiled or UCS-2 encoded script
+    std::uint16_t tag;
+    std::memcpy(&tag, mData.data(), sizeof(tag));
+    // See if it's something else than plain text
+    return (tag != SQ_BYTECODE_STREAM_TAG && tag != 0xFEFF && tag != 0xFFFE);
+}
+
+// ------------------------------------------------------------------------------------------------
+void ScriptSrc::Compile()
+{
+    HSQUIRRELVM vm = mExec.GetVM();
+    // Skip the UTF-8 byte order mark, like the compiler does when reading files
+    const size_t offset = (mData.compare(0, 3, "\xEF\xBB\xBF") == 0) ? 3 : 0;
+    // Attempt to compile the contents
+    if (SQ_FAILED(sq_compilebuffer(vm, mData.data() + offset, static_cast< SQInteger >(mData.size() - offset),
+                                    mPath.c_str(), SQTrue)))
+    {
+        throw Sqrat::Exception(Sqrat::LastErrorString(vm));
+    }
+    // Take ownership of the compiled code
+    static_cast< Object & >(mExec) = Object(-1, vm);
+    // Remove the compiled code from the stack
+    sq_pop(vm, 1);
+}
+
+// ------------------------------------------------------------------------------------------------
+void ScriptSrc::Discard()
+{
+    // Are the contents needed to fetch lines of code?
+    if (!mInfo)
+    {
+        String().swap(mData);
+        Line().swap(mLine);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void ScriptSrc::Index()
+{
+    // Was the information already calculated or is there nothing to calculate?
+    if (!mLine.empty() || mData.empty() || !IsPlainText())
+    {
+        return;
+    }
     // Where the last line ended
     size_t line_start = 0, line_end = 0;
     // Process the file data and locate new lines
@@ -146,8 +242,27 @@ void ScriptSrc::Process()
     {
         mLine.emplace_back(line_start, mData.size());
     }
-    // Specify that this script contains line information
-    mInfo = true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ScriptSrc::Changed()
+{
+    const Int64 time = ModificationTime(mPath.c_str());
+    // Was the file even modified?
+    if (time == mTime)
+    {
+        return false;
+    }
+    // Read the current contents without losing the previous ones
+    ScriptSrc current(mExec.GetVM(), mPath);
+    if (!current.Read())
+    {
+        return false; // Probably in the middle of being written
+    }
+    // Don't read the file again unless it's modified again
+    mTime = current.mTime;
+    // See if the contents are different
+    return (current.mHash != mHash);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -156,6 +271,8 @@ ScriptSrc::ScriptSrc(HSQUIRRELVM vm, String && path, bool delay, bool info)
     , mPath(std::move(path))
     , mData()
     , mLine()
+    , mHash(0)
+    , mTime(-1)
     , mInfo(info)
     , mDelay(delay)
 {
@@ -169,18 +286,15 @@ ScriptSrc::ScriptSrc(HSQUIRRELVM vm, String && path, bool delay, bool info)
     {
         throw std::runtime_error("Invalid or empty script path");
     }
-    // Should we load the file contents for debugging purposes?
-    else if (mInfo)
-    {
-        Process();
-    }
 }
 
 // ------------------------------------------------------------------------------------------------
-String ScriptSrc::FetchLine(size_t line, bool trim) const
+String ScriptSrc::FetchLine(size_t line, bool trim)
 {
+    // Locate the lines of code the first time they're needed
+    Index();
     // Do we have such line?
-    if (line > mLine.size())
+    if (line >= mLine.size())
     {
         return String(); // Nope!
     }
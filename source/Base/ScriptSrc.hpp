@@ -28,14 +28,52 @@ public:
     Script      mExec; // Reference to the script object.
     String      mPath; // Path to the script file.
     String      mData; // The contents of the script file.
-    Line        mLine; // List of lines of code in the data.
+    Line        mLine; // List of lines of code in the data. Built when first needed.
+    Uint64      mHash; // Hash of the contents that were last read.
+    Int64       mTime; // Modification time of the file when it was last read.
     bool        mInfo; // Whether this script contains line information.
     bool        mDelay; // Don't execute immediately after compilation.
 
     /* --------------------------------------------------------------------------------------------
-     * Read file contents and calculate information about the lines of code.
+     * Compute a hash of the specified data.
     */
-    void Process();
+    static Uint64 Hash(CCStr data, size_t size, Uint64 hash = 14695981039346656037ULL);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the modification time of the specified file or -1 if it can't be found.
+    */
+    static Int64 ModificationTime(CSStr path);
+
+    /* --------------------------------------------------------------------------------------------
+     * Read the file contents, unless they were already read. Returns false if it can't be read.
+    */
+    bool Read();
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the read contents are plain text that can be compiled from memory.
+    */
+    bool IsPlainText() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Compile the read contents. Throws on compilation errors.
+    */
+    void Compile();
+
+    /* --------------------------------------------------------------------------------------------
+     * Release the read contents if they're not needed for line information.
+    */
+    void Discard();
+
+    /* --------------------------------------------------------------------------------------------
+     * Calculate information about the lines of code, unless it was already calculated.
+    */
+    void Index();
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the file contents changed since they were last read. Only reads the file if the
+     * modification time changed.
+    */
+    bool Changed();
 
     /* --------------------------------------------------------------------------------------------
      * Base constructor.
@@ -74,7 +112,7 @@ public:
     /* --------------------------------------------------------------------------------------------
      * Fetches a line from the code. Can also triim whitespace at the beginning.
     */
-    String FetchLine(size_t line, bool trim = true) const;
+    String FetchLine(size_t line, bool trim = true);
 };
 
 
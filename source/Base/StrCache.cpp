@@ -0,0 +1,19 @@
+// ------------------------------------------------------------------------------------------------
+#include "Base/StrCache.hpp"
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+StrCache * StrCache::s_Head = nullptr;
+
+// ------------------------------------------------------------------------------------------------
+void StrCache::ClearAll()
+{
+    for (StrCache * cache = s_Head; cache; cache = cache->m_Next)
+    {
+        cache->Clear();
+    }
+}
+
+} // Namespace:: SqMod
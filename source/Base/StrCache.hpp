@@ -0,0 +1,108 @@
+#ifndef _BASE_STRCACHE_HPP_
+#define _BASE_STRCACHE_HPP_
+
+// ------------------------------------------------------------------------------------------------
+#include "Base/Utility.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <vector>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Script strings created from native strings identified by a number, such as the name of a weapon
+ * or a skin. Pushing a cached string doesn't have to hash it and look it up in the string table of
+ * the virtual machine again. The owner must forget a string when the native one changes.
+ *
+ * Identifiers past the limit of the cache are not cached. Every cache is released before the
+ * virtual machine is closed.
+*/
+class StrCache
+{
+private:
+
+    // --------------------------------------------------------------------------------------------
+    std::vector< LightObj > m_Strings; // Script strings by identifier.
+    LightObj                m_Scratch; // Script string of the last identifier past the limit.
+    Uint32                  m_Limit; // Identifiers below this value are cached.
+    StrCache *              m_Next; // The next cache in the list of all caches.
+
+    // --------------------------------------------------------------------------------------------
+    static StrCache *       s_Head; // The first cache in the list of all caches.
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor. (disabled)
+    */
+    StrCache(const StrCache &) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator. (disabled)
+    */
+    StrCache & operator = (const StrCache &) = delete;
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor. Includes the cache in the list of all caches.
+    */
+    explicit StrCache(Uint32 limit)
+        : m_Strings(), m_Scratch(), m_Limit(limit), m_Next(s_Head)
+    {
+        s_Head = this;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the script string of the specified identifier, creating it from the native string
+     * if it's not cached.
+    */
+    const LightObj & Get(Uint32 id, CSStr str, SQInteger len = -1)
+    {
+        // Is this identifier too large to be cached?
+        if (id >= m_Limit)
+        {
+            m_Scratch = LightObj(str, len);
+            return m_Scratch;
+        }
+        else if (id >= m_Strings.size())
+        {
+            m_Strings.resize(id + 1);
+        }
+        LightObj & obj = m_Strings[id];
+        // Create the script string only once
+        if (obj.IsNull())
+        {
+            obj = LightObj(str, len);
+        }
+        return obj;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Forget the script string of the specified identifier.
+    */
+    void Forget(Uint32 id)
+    {
+        if (id < m_Strings.size())
+        {
+            m_Strings[id].Release();
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Forget all script strings.
+    */
+    void Clear()
+    {
+        m_Strings.clear();
+        m_Scratch.Release();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Forget the script strings of all caches.
+    */
+    static void ClearAll();
+};
+
+} // Namespace:: SqMod
+
+#endif // _BASE_STRCACHE_HPP_
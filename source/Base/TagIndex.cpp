@@ -0,0 +1,132 @@
+// ------------------------------------------------------------------------------------------------
+#include "Base/TagIndex.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <cctype>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+String TagIndex::Fold(CSStr tag, size_t len)
+{
+    String str(tag, len);
+    // Fold every character to lowercase
+    for (auto & c : str)
+    {
+        c = static_cast< String::value_type >(std::tolower(static_cast< unsigned char >(c)));
+    }
+    // Return the folded string
+    return str;
+}
+
+// ------------------------------------------------------------------------------------------------
+void TagIndex::Link(Exact & map, const String & tag, Int32 id)
+{
+    IDs & ids = map[tag];
+    // Keep the identifiers sorted so the first one is always the lowest
+    IDs::iterator itr = std::lower_bound(ids.begin(), ids.end(), id);
+    // Insert it only if it's not already there
+    if (itr == ids.end() || *itr != id)
+    {
+        ids.insert(itr, id);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void TagIndex::Unlink(Exact & map, const String & tag, Int32 id)
+{
+    Exact::iterator mitr = map.find(tag);
+    // Is this tag even known?
+    if (mitr == map.end())
+    {
+        return;
+    }
+    IDs & ids = mitr->second;
+    // Find where the identifier should be
+    IDs::iterator itr = std::lower_bound(ids.begin(), ids.end(), id);
+    // Remove it only if it was found
+    if (itr != ids.end() && *itr == id)
+    {
+        ids.erase(itr);
+    }
+    // Forget tags which are no longer used
+    if (ids.empty())
+    {
+        map.erase(mitr);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void TagIndex::Collect(const Sorted & set, const String & prefix, IDs & ids)
+{
+    // Process every tag that begins with the prefix
+    for (Sorted::const_iterator itr = set.lower_bound(Sorted::value_type(prefix, INT_MIN));
+            itr != set.end() && itr->first.compare(0, prefix.size(), prefix) == 0; ++itr)
+    {
+        ids.push_back(itr->second);
+    }
+    // The tags are sorted by name so the identifiers must be sorted again
+    std::sort(ids.begin(), ids.end());
+}
+
+// ------------------------------------------------------------------------------------------------
+void TagIndex::Insert(Int32 id, const String & tag)
+{
+    const String folded(Fold(tag.data(), tag.size()));
+    // Include the entity in the hash tables
+    Link(m_Exact, tag, id);
+    Link(m_ExactCI, folded, id);
+    // Include the entity in the sorted sets
+    m_Sorted.emplace(tag, id);
+    m_SortedCI.emplace(folded, id);
+}
+
+// ------------------------------------------------------------------------------------------------
+void TagIndex::Remove(Int32 id, const String & tag)
+{
+    const String folded(Fold(tag.data(), tag.size()));
+    // Exclude the entity from the hash tables
+    Unlink(m_Exact, tag, id);
+    Unlink(m_ExactCI, folded, id);
+    // Exclude the entity from the sorted sets
+    m_Sorted.erase(Sorted::value_type(tag, id));
+    m_SortedCI.erase(Sorted::value_type(folded, id));
+}
+
+// ------------------------------------------------------------------------------------------------
+void TagIndex::Clear()
+{
+    m_Exact.clear();
+    m_ExactCI.clear();
+    m_Sorted.clear();
+    m_SortedCI.clear();
+}
+
+// ------------------------------------------------------------------------------------------------
+const TagIndex::IDs * TagIndex::Equals(CSStr tag, bool cs) const
+{
+    // Look in the appropriate hash table
+    const Exact & map = cs ? m_Exact : m_ExactCI;
+    Exact::const_iterator itr = cs ? map.find(String(tag)) : map.find(Fold(tag, std::strlen(tag)));
+    // Return the entities, if any
+    return itr == map.end() ? nullptr : &(itr->second);
+}
+
+// ------------------------------------------------------------------------------------------------
+void TagIndex::Begins(CSStr tag, bool cs, IDs & ids) const
+{
+    if (cs)
+    {
+        Collect(m_Sorted, String(tag), ids);
+    }
+    else
+    {
+        Collect(m_SortedCI, Fold(tag, std::strlen(tag)), ids);
+    }
+}
+
+} // Namespace:: SqMod
@@ -0,0 +1,90 @@
+#ifndef _BASE_TAGINDEX_HPP_
+#define _BASE_TAGINDEX_HPP_
+
+// ------------------------------------------------------------------------------------------------
+#include "Base/Utility.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <set>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Index of the tags of the entities in a pool. Allows finding the entities with a certain tag
+ * without looking at every entity, both with and without case sensitivity. Exact matches are
+ * found through hash tables and prefix matches through sorted sets.
+*/
+class TagIndex
+{
+public:
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::vector< Int32 > IDs; // Sorted list of entity identifiers.
+
+private:
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::unordered_map< String, IDs > Exact; // Entities associated with each tag.
+    typedef std::set< std::pair< String, Int32 > > Sorted; // Tags and entities sorted by tag.
+
+    // --------------------------------------------------------------------------------------------
+    Exact   m_Exact; // Case sensitive entities associated with each tag.
+    Exact   m_ExactCI; // Case insensitive entities associated with each tag.
+    Sorted  m_Sorted; // Case sensitive tags sorted for prefix searches.
+    Sorted  m_SortedCI; // Case insensitive tags sorted for prefix searches.
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the case folded version of the specified tag.
+    */
+    static String Fold(CSStr tag, size_t len);
+
+    /* --------------------------------------------------------------------------------------------
+     * Add an entity to the list associated with a tag.
+    */
+    static void Link(Exact & map, const String & tag, Int32 id);
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove an entity from the list associated with a tag.
+    */
+    static void Unlink(Exact & map, const String & tag, Int32 id);
+
+    /* --------------------------------------------------------------------------------------------
+     * Collect the entities from a sorted set whose tag begins with the specified string.
+    */
+    static void Collect(const Sorted & set, const String & prefix, IDs & ids);
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Include the specified entity and tag in the index.
+    */
+    void Insert(Int32 id, const String & tag);
+
+    /* --------------------------------------------------------------------------------------------
+     * Exclude the specified entity and tag from the index.
+    */
+    void Remove(Int32 id, const String & tag);
+
+    /* --------------------------------------------------------------------------------------------
+     * Exclude everything from the index.
+    */
+    void Clear();
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the sorted entities with the specified tag. Returns null if there are none.
+    */
+    const IDs * Equals(CSStr tag, bool cs) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Collect the sorted entities with a tag that begins with the specified string.
+    */
+    void Begins(CSStr tag, bool cs, IDs & ids) const;
+};
+
+} // Namespace:: SqMod
+
+#endif // _BASE_TAGINDEX_HPP_
@@ -5,6 +5,7 @@
 #include "Misc/Areas.hpp"
 #include "Misc/Signal.hpp"
 #include "Base/Buffer.hpp"
+#include "Base/StrCache.hpp"
 #include "Library/Utils/Buffer.hpp"
 
 // ------------------------------------------------------------------------------------------------
@@ -28,6 +29,7 @@
 // ------------------------------------------------------------------------------------------------
 #include <cstdio>
 #include <cstdarg>
+#include <cstdlib>
 #include <exception>
 #include <stdexcept>
 #include <algorithm>
@@ -142,7 +144,28 @@ Core::Core()
     , m_VM(nullptr)
     , m_Scripts()
     , m_PendingScripts()
+    , m_ScriptCache()
+    , m_Compiling(nullptr)
+    , m_Collector()
+    , m_Profiler()
+    , m_Metrics()
     , m_Options()
+    , m_ActiveBlips()
+    , m_ActiveCheckpoints()
+    , m_ActiveKeybinds()
+    , m_ActiveObjects()
+    , m_ActivePickups()
+    , m_ActivePlayers()
+    , m_ActiveVehicles()
+    , m_BlipTags()
+    , m_CheckpointTags()
+    , m_KeybindTags()
+    , m_ObjectTags()
+    , m_PickupTags()
+    , m_PlayerTags()
+    , m_VehicleTags()
+    , m_PlayerStates()
+    , m_VehicleStates()
     , m_Blips()
     , m_Checkpoints()
     , m_Keybinds()
@@ -165,6 +188,8 @@ Core::Core()
     , m_LockUnloadSignal(false)
     , m_EmptyInit(false)
     , m_Verbosity(1)
+    , m_CompressSends(false)
+    , m_CompressThreshold(128)
 {
     /* ... */
 }
@@ -218,8 +243,51 @@ bool Core::Initialize()
     m_Debugging = conf.GetBoolValue("Squirrel", "Debugging", m_Debugging);
     // Configure the empty initialization
     m_EmptyInit = conf.GetBoolValue("Squirrel", "EmptyInit", false);
+    // Configure the cache of compiled scripts
+    m_ScriptCache.Configure(conf.GetBoolValue("Squirrel", "BytecodeCache", false),
+                            conf.GetValue("Squirrel", "BytecodeCacheDir", nullptr),
+                            ConvTo< Uint32 >::From(conf.GetLongValue("Squirrel", "CompileThreads", 0)));
+    // Configure the scheduling of the garbage collector
+    m_Collector.Configure(conf.GetBoolValue("Squirrel", "CollectGarbage", false),
+                            static_cast< Uint64 >(std::max(conf.GetLongValue("Squirrel", "CollectGrowth", 4096), 0L)) * 1024,
+                            static_cast< Uint64 >(std::max(conf.GetLongValue("Squirrel", "CollectLimit", 65536), 0L)) * 1024,
+                            static_cast< Int64 >(conf.GetLongValue("Squirrel", "CollectBudget", 5000)));
+    // Configure the sampling profiler
+    m_Profiler.Configure(ConvTo< Uint32 >::From(conf.GetLongValue("Squirrel", "ProfilerInterval", 1000)),
+                            conf.GetValue("Squirrel", "ProfilerOutput", "profile.folded"));
+    // Configure the timing of callbacks and frames
+    m_Metrics.Configure(conf.GetBoolValue("Metrics", "Enabled", false),
+                        static_cast< Int64 >(conf.GetLongValue("Metrics", "SummaryInterval", 0)));
+    // Configure the allocator of the virtual machine (can't be changed once it allocated anything)
+    const bool pooled = conf.GetBoolValue("Squirrel", "PooledAllocator", false);
+    if (static_cast< bool >(sq_vm_usepool(pooled)) != pooled)
+    {
+        LogWrn("The virtual machine allocator can only be changed by restarting the server");
+    }
+    // Configure the limits of the buffer memory pool
+    MemRef::SetBlockLimit(ConvTo< Uint32 >::From(conf.GetLongValue("Buffer", "PoolBlockLimit", MemRef::GetBlockLimit())));
+    MemRef::SetByteLimit(ConvTo< Uint32 >::From(conf.GetLongValue("Buffer", "PoolByteLimit", MemRef::GetByteLimit())));
+    // Synchronization of the buffer memory pool can only be chosen at startup
+    const bool thread_safe = conf.GetBoolValue("Buffer", "PoolThreadSafe", false);
+    if (MemRef::SetThreadSafe(thread_safe) != thread_safe)
+    {
+        LogWrn("The buffer memory pool synchronization can only be changed by restarting the server");
+    }
+    // Configure the compression of client script data
+    m_CompressSends = conf.GetBoolValue("Buffer", "CompressSends", false);
+    m_CompressThreshold = ConvTo< Uint32 >::From(conf.GetLongValue("Buffer", "CompressThreshold", 128));
     // Configure the verbosity level
     m_Verbosity = conf.GetLongValue("Log", "VerbosityLevel", 1);
+    // Configure the log file format and rotation before the file is opened
+    Logger::Get().SetLogFileFormat(conf.GetBoolValue("Log", "LogFileJSON", false) ? LOGF_JSON : LOGF_TEXT);
+    Logger::Get().SetRotateSize(ConvTo< Uint32 >::From(conf.GetLongValue("Log", "LogFileRotateSize", 0)));
+    Logger::Get().SetRotateInterval(ConvTo< Uint32 >::From(conf.GetLongValue("Log", "LogFileRotateInterval", 0)));
+    // Configure the suppression of repeated errors
+    Logger::Get().SetRepeatWindow(ConvTo< Uint32 >::From(conf.GetLongValue("Log", "ErrorRepeatWindow", 0)));
+    Logger::Get().SetTracebackLimit(ConvTo< Uint32 >::From(conf.GetLongValue("Log", "TracebackLimit", 0)));
+    // Configure the in-memory ring of recent messages
+    Logger::Get().SetRingSize(ConvTo< Uint32 >::From(conf.GetLongValue("Log", "RingSize", 0)));
+    Logger::Get().SetRingDumpFile(conf.GetValue("Log", "RingDumpFile", nullptr));
     // Initialize the log filename
     Logger::Get().SetLogFilename(conf.GetValue("Log", "Filename", nullptr));
     // Configure the logging timestamps
@@ -240,6 +308,13 @@ bool Core::Initialize()
     Logger::Get().ToggleLogFileLevel(LOGL_WRN, conf.GetBoolValue("Log", "LogFileWarning", true));
     Logger::Get().ToggleLogFileLevel(LOGL_ERR, conf.GetBoolValue("Log", "LogFileError", true));
     Logger::Get().ToggleLogFileLevel(LOGL_FTL, conf.GetBoolValue("Log", "LogFileFatal", true));
+    Logger::Get().ToggleRingLevel(LOGL_DBG, conf.GetBoolValue("Log", "RingDebug", true));
+    Logger::Get().ToggleRingLevel(LOGL_USR, conf.GetBoolValue("Log", "RingUser", true));
+    Logger::Get().ToggleRingLevel(LOGL_SCS, conf.GetBoolValue("Log", "RingSuccess", true));
+    Logger::Get().ToggleRingLevel(LOGL_INF, conf.GetBoolValue("Log", "RingInfo", true));
+    Logger::Get().ToggleRingLevel(LOGL_WRN, conf.GetBoolValue("Log", "RingWarning", true));
+    Logger::Get().ToggleRingLevel(LOGL_ERR, conf.GetBoolValue("Log", "RingError", true));
+    Logger::Get().ToggleRingLevel(LOGL_FTL, conf.GetBoolValue("Log", "RingFatal", true));
 
     cLogDbg(m_Verbosity >= 1, "Resizing the entity containers");
     // Make sure the entity containers have the proper size
@@ -250,6 +325,17 @@ bool Core::Initialize()
     m_Pickups.resize(SQMOD_PICKUP_POOL);
     m_Players.resize(SQMOD_PLAYER_POOL);
     m_Vehicles.resize(SQMOD_VEHICLE_POOL);
+    // Make sure the last known state containers have the proper size
+    m_PlayerStates.resize(SQMOD_PLAYER_POOL);
+    m_VehicleStates.resize(SQMOD_VEHICLE_POOL);
+    // Make room for every entity in the active lists to avoid allocating later
+    m_ActiveBlips.reserve(SQMOD_BLIP_POOL);
+    m_ActiveCheckpoints.reserve(SQMOD_CHECKPOINT_POOL);
+    m_ActiveKeybinds.reserve(SQMOD_KEYBIND_POOL);
+    m_ActiveObjects.reserve(SQMOD_OBJECT_POOL);
+    m_ActivePickups.reserve(SQMOD_PICKUP_POOL);
+    m_ActivePlayers.reserve(SQMOD_PLAYER_POOL);
+    m_ActiveVehicles.reserve(SQMOD_VEHICLE_POOL);
 
     // Attempt to read the virtual machine stack size
     const LongI stack_size = conf.GetLongValue("Squirrel", "StackSize", SQMOD_STACK_SIZE);
@@ -461,6 +547,8 @@ bool Core::Execute()
 void Core::Terminate(bool shutdown)
 {
     m_Shutdown = shutdown;
+    // The profiler can't outlive the virtual machine
+    m_Profiler.Stop();
     // Is there a virtual machine present?
     if (m_VM)
     {
@@ -509,6 +597,10 @@ void Core::Terminate(bool shutdown)
     m_NullPickup.Release();
     m_NullPlayer.Release();
     m_NullVehicle.Release();
+    // Release the reusable client script data view
+    m_ClientDataView.Release();
+    // Release the cached script strings of native names
+    StrCache::ClearAll();
     // Is there a VM to close?
     if (m_VM)
     {
@@ -567,6 +659,107 @@ bool Core::Reload()
     return (Initialize() && Execute());
 }
 
+// ------------------------------------------------------------------------------------------------
+Int32 Core::ReloadChanged()
+{
+    // Are we already reloading?
+    if (m_CircularLocks & CCL_RELOAD_SCRIPTS)
+    {
+        STHROWF("Cannot reload scripts while already reloading");
+    }
+    // Were the scripts executed at least once? Let the initial load finish first
+    else if (!m_Executed)
+    {
+        return 0;
+    }
+    // Prevent reloads from the script reloaded event
+    const BitGuardU32 bg(m_CircularLocks, static_cast< Uint32 >(CCL_RELOAD_SCRIPTS));
+    // The number of reloaded scripts
+    Int32 count = 0;
+    // Scripts can be loaded while reloading so don't hold on to references
+    for (size_t idx = 0; idx < m_Scripts.size(); ++idx)
+    {
+        // Did the contents of this script change?
+        if (m_Scripts[idx].Changed() && RedoScript(idx))
+        {
+            ++count;
+        }
+    }
+    // Return the number of reloaded scripts
+    return count;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Core::ReloadScript(CSStr path)
+{
+    // Are we already reloading?
+    if (m_CircularLocks & CCL_RELOAD_SCRIPTS)
+    {
+        STHROWF("Cannot reload scripts while already reloading");
+    }
+    // Were the scripts executed at least once?
+    else if (!m_Executed)
+    {
+        STHROWF("Cannot reload scripts before they were executed");
+    }
+    // Find the specified script
+    Scripts::iterator itr = FindScript(path);
+    // Is it loaded?
+    if (itr == m_Scripts.end())
+    {
+        STHROWF("Script was not loaded: %s", path);
+    }
+    // Prevent reloads from the script reloaded event
+    const BitGuardU32 bg(m_CircularLocks, static_cast< Uint32 >(CCL_RELOAD_SCRIPTS));
+    // Attempt to reload it
+    return RedoScript(static_cast< size_t >(itr - m_Scripts.begin()));
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Core::RedoScript(size_t idx)
+{
+    const ScriptSrc & prev = m_Scripts[idx];
+    // Read the current contents separately, so the previous ones are kept on failure
+    ScriptSrc src(prev.mExec.GetVM(), prev.mPath, prev.mDelay, prev.mInfo);
+    // Compile errors should show the lines of the new contents
+    m_Compiling = &src;
+    // Attempt to compile them
+    bool cached = false;
+    try
+    {
+        cached = m_ScriptCache.Compile(src);
+    }
+    catch (const Sqrat::Exception & e)
+    {
+        m_Compiling = nullptr;
+        LogErr("Unable to compile: %s", src.mPath.c_str());
+        // Failed to compile properly
+        return false;
+    }
+    m_Compiling = nullptr;
+    cLogDbg(m_Verbosity >= 3, "%s script: %s", cached ? "Loaded cached" : "Compiled", src.mPath.c_str());
+    // Only now replace the previous code and contents
+    m_Scripts[idx] = std::move(src);
+    // The script may load other scripts, which moves the script container
+    Script exec(m_Scripts[idx].mExec);
+    // Attempt to execute the compiled script code again
+    try
+    {
+        exec.Run();
+    }
+    catch (const Sqrat::Exception & e)
+    {
+        LogErr("Unable to execute: %s", m_Scripts[idx].mPath.c_str());
+        // Failed to execute properly
+        return false;
+    }
+    cLogScs(m_Verbosity >= 2, "Reloaded script: %s", m_Scripts[idx].mPath.c_str());
+    // Let the script bind its handlers again
+    EmitScriptReloaded(m_Scripts[idx].mPath.c_str());
+    // The script was reloaded
+    return true;
+}
+
 // ------------------------------------------------------------------------------------------------
 CSStr Core::GetOption(CSStr name) const
 {
@@ -673,9 +866,10 @@ bool Core::LoadScript(CSStr filepath, bool delay)
         m_Scripts.emplace_back(m_VM, std::move(path), delay, m_Debugging);
 
         // Attempt to load and compile the script file
+        bool cached = false;
         try
         {
-            m_Scripts.back().mExec.CompileFile(m_Scripts.back().mPath);
+            cached = m_ScriptCache.Compile(m_Scripts.back());
         }
         catch (const Sqrat::Exception & e)
         {
@@ -686,7 +880,7 @@ bool Core::LoadScript(CSStr filepath, bool delay)
             return false;
         }
         // At this point the script should be completely loaded
-        cLogDbg(m_Verbosity >= 3, "Compiled script: %s", m_Scripts.back().mPath.c_str());
+        cLogDbg(m_Verbosity >= 3, "%s script: %s", cached ? "Loaded cached" : "Compiled", m_Scripts.back().mPath.c_str());
 
         // Attempt to execute the compiled script code
         try
@@ -751,10 +945,15 @@ void Core::SetIncomingName(CSStr name)
 // ------------------------------------------------------------------------------------------------
 String Core::FetchCodeLine(CSStr src, SQInteger line, bool trim)
 {
+    // Is this the script being compiled again?
+    if (m_Compiling && m_Compiling->mPath.compare(src) == 0)
+    {
+        return (!(m_Compiling->mInfo) || (line < 0)) ? String{} : m_Compiling->FetchLine(line, trim);
+    }
     // Find the script we're looking for
     Scripts::iterator script = FindScript(src);
     // Do we have a valid script and line?
-    if ((script == m_Scripts.end()) || !(script->mInfo) || (script->mLine.size() < line))
+    if ((script == m_Scripts.end()) || !(script->mInfo) || (line < 0))
     {
         return String{}; // No such script!
     }
@@ -777,10 +976,13 @@ bool Core::DoScripts(Scripts::iterator itr, Scripts::iterator end)
             continue; // Already compiled!
         }
 
+        // Compile the remaining scripts in advance, if enabled
+        Get().m_ScriptCache.Precompile(itr, end);
         // Attempt to load and compile the script file
+        bool cached = false;
         try
         {
-            (*itr).mExec.CompileFile((*itr).mPath);
+            cached = Get().m_ScriptCache.Compile(*itr);
         }
         catch (const Sqrat::Exception & e)
         {
@@ -789,7 +991,7 @@ bool Core::DoScripts(Scripts::iterator itr, Scripts::iterator end)
             return false;
         }
 
-        cLogDbg(Get().m_Verbosity >= 3, "Compiled script: %s", (*itr).mPath.c_str());
+        cLogDbg(Get().m_Verbosity >= 3, "%s script: %s", cached ? "Loaded cached" : "Compiled", (*itr).mPath.c_str());
 
         // Should we delay the execution of this script?
         if ((*itr).mDelay)
@@ -812,6 +1014,9 @@ bool Core::DoScripts(Scripts::iterator itr, Scripts::iterator end)
         cLogScs(Get().m_Verbosity >= 2, "Executed script: %s", (*itr).mPath.c_str());
     }
 
+    cLogDbg(Get().m_Verbosity >= 1 && Get().m_ScriptCache.IsEnabled(), "Compiled script cache: %u hits, %u misses",
+            Get().m_ScriptCache.GetHits(), Get().m_ScriptCache.GetMisses());
+
     cLogDbg(Get().m_Verbosity >= 1, "Attempting to execute the delayed scripts");
     // Execute scripts only after compilation successful
     for (itr = itr_state; itr != end; ++itr)
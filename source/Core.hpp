@@ -7,6 +7,11 @@
 #include "Base/Quaternion.hpp"
 #include "Base/Color4.hpp"
 #include "Base/ScriptSrc.hpp"
+#include "Base/Collector.hpp"
+#include "Base/Metrics.hpp"
+#include "Base/Profiler.hpp"
+#include "Base/ScriptCache.hpp"
+#include "Base/TagIndex.hpp"
 
 // ------------------------------------------------------------------------------------------------
 #include <vector>
@@ -471,13 +476,6 @@ protected:
         Int32           mKickBanHeader; // Header to send when triggering kick/ban callback.
         LightObj        mKickBanPayload; // Payload to send when triggering kick/ban callback.
 
-        // ----------------------------------------------------------------------------------------
-        Int32           mLastWeapon; // Last known weapon of the player entity.
-        Float32         mLastHealth; // Last known health of the player entity.
-        Float32         mLastArmour; // Last known armor of the player entity.
-        Float32         mLastHeading; // Last known heading of the player entity.
-        Vector3         mLastPosition; // Last known position of the player entity.
-
         // ----------------------------------------------------------------------------------------
         Int32           mAuthority; // The authority level of the managed player.
 
@@ -623,13 +621,6 @@ protected:
         SQInteger       mTrackPosition; // The number of times to track position changes.
         SQInteger       mTrackRotation; // The number of times to track rotation changes.
 
-        // ----------------------------------------------------------------------------------------
-        Int32           mLastPrimaryColor; // Last known secondary-color of the player entity.
-        Int32           mLastSecondaryColor; // Last known primary-color of the player entity.
-        Float32         mLastHealth; // Last known health of the player entity.
-        Vector3         mLastPosition; // Last known position of the player entity.
-        Quaternion      mLastRotation; // Last known rotation of the player entity.
-
         // ----------------------------------------------------------------------------------------
         LightObj        mEvents; // Table containing the emitted entity events.
 
@@ -661,6 +652,58 @@ protected:
         SignalPair      mOnLeaveArea;
     };
 
+    /* --------------------------------------------------------------------------------------------
+     * Last known state of a player entity. Kept in a separate container from the player instances,
+     * away from the script objects and signals, so that update events touch only a few bytes.
+    */
+    struct PlayerState
+    {
+        /* ----------------------------------------------------------------------------------------
+         * Reset the state to the default values.
+        */
+        void Reset()
+        {
+            mLastWeapon = -1;
+            mLastHealth = 0.0;
+            mLastArmour = 0.0;
+            mLastHeading = 0.0;
+            mLastPosition.Clear();
+        }
+
+        // ----------------------------------------------------------------------------------------
+        Int32           mLastWeapon; // Last known weapon of the player entity.
+        Float32         mLastHealth; // Last known health of the player entity.
+        Float32         mLastArmour; // Last known armor of the player entity.
+        Float32         mLastHeading; // Last known heading of the player entity.
+        Vector3         mLastPosition; // Last known position of the player entity.
+    };
+
+    /* --------------------------------------------------------------------------------------------
+     * Last known state of a vehicle entity. Kept in a separate container from the vehicle instances,
+     * away from the script objects and signals, so that update events touch only a few bytes.
+    */
+    struct VehicleState
+    {
+        /* ----------------------------------------------------------------------------------------
+         * Reset the state to the default values.
+        */
+        void Reset()
+        {
+            mLastPrimaryColor = -1;
+            mLastSecondaryColor = -1;
+            mLastHealth = 0.0;
+            mLastPosition.Clear();
+            mLastRotation.Clear();
+        }
+
+        // ----------------------------------------------------------------------------------------
+        Int32           mLastPrimaryColor; // Last known secondary-color of the vehicle entity.
+        Int32           mLastSecondaryColor; // Last known primary-color of the vehicle entity.
+        Float32         mLastHealth; // Last known health of the vehicle entity.
+        Vector3         mLastPosition; // Last known position of the vehicle entity.
+        Quaternion      mLastRotation; // Last known rotation of the vehicle entity.
+    };
+
 public:
 
     // --------------------------------------------------------------------------------------------
@@ -672,6 +715,13 @@ public:
     typedef std::vector< PlayerInst >       Players; // Players entity instances container.
     typedef std::vector< VehicleInst >      Vehicles; // Vehicles entity instances container.
 
+    // --------------------------------------------------------------------------------------------
+    typedef std::vector< PlayerState >      PlayerStates; // Players last known state container.
+    typedef std::vector< VehicleState >     VehicleStates; // Vehicles last known state container.
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::vector< Int32 >            ActiveList; // Sorted identifiers of allocated entities.
+
     // --------------------------------------------------------------------------------------------
     typedef std::vector< ScriptSrc >                Scripts; // List of loaded scripts.
     // --------------------------------------------------------------------------------------------
@@ -684,8 +734,35 @@ private:
     HSQUIRRELVM                     m_VM; // Script virtual machine.
     Scripts                         m_Scripts; // Loaded scripts objects.
     Scripts                         m_PendingScripts; // Pending scripts objects.
+    ScriptCache                     m_ScriptCache; // Cache of compiled scripts.
+    ScriptSrc *                     m_Compiling; // Script being compiled outside the containers.
+    Collector                       m_Collector; // Scheduler of the garbage collector.
+    Profiler                        m_Profiler; // Sampling profiler for scripts.
+    Metrics                         m_Metrics; // Time spent in callbacks and frames.
     Options                         m_Options; // Custom configuration options.
 
+    // --------------------------------------------------------------------------------------------
+    ActiveList                      m_ActiveBlips; // Identifiers of allocated blips.
+    ActiveList                      m_ActiveCheckpoints; // Identifiers of allocated checkpoints.
+    ActiveList                      m_ActiveKeybinds; // Identifiers of allocated key-binds.
+    ActiveList                      m_ActiveObjects; // Identifiers of allocated objects.
+    ActiveList                      m_ActivePickups; // Identifiers of allocated pickups.
+    ActiveList                      m_ActivePlayers; // Identifiers of connected players.
+    ActiveList                      m_ActiveVehicles; // Identifiers of allocated vehicles.
+
+    // --------------------------------------------------------------------------------------------
+    TagIndex                        m_BlipTags; // Tags of allocated blips.
+    TagIndex                        m_CheckpointTags; // Tags of allocated checkpoints.
+    TagIndex                        m_KeybindTags; // Tags of allocated key-binds.
+    TagIndex                        m_ObjectTags; // Tags of allocated objects.
+    TagIndex                        m_PickupTags; // Tags of allocated pickups.
+    TagIndex                        m_PlayerTags; // Tags of allocated players.
+    TagIndex                        m_VehicleTags; // Tags of allocated vehicles.
+
+    // --------------------------------------------------------------------------------------------
+    PlayerStates                    m_PlayerStates; // Players last known state.
+    VehicleStates                   m_VehicleStates; // Vehicles last known state.
+
     // --------------------------------------------------------------------------------------------
     Blips                           m_Blips; // Blips pool.
     Checkpoints                     m_Checkpoints; // Checkpoints pool.
@@ -721,6 +798,10 @@ private:
     // --------------------------------------------------------------------------------------------
     Int32                           m_Verbosity; // Restrict the amount of outputted information.
 
+    // --------------------------------------------------------------------------------------------
+    bool                            m_CompressSends; // Whether client script data is sent as blocks.
+    Uint32                          m_CompressThreshold; // Minimum size of compressed client data.
+
     // --------------------------------------------------------------------------------------------
     LightObj                        m_NullBlip; // Null Blips instance.
     LightObj                        m_NullCheckpoint; // Null Checkpoints instance.
@@ -730,6 +811,9 @@ private:
     LightObj                        m_NullPlayer; // Null Players instance.
     LightObj                        m_NullVehicle; // Null Vehicles instance.
 
+    // --------------------------------------------------------------------------------------------
+    LightObj                        m_ClientDataView; // Reusable view over received client script data.
+
 public:
 
     /* --------------------------------------------------------------------------------------------
@@ -760,6 +844,17 @@ public:
     */
     bool Reload();
 
+    /* --------------------------------------------------------------------------------------------
+     * Compile and execute again the loaded scripts whose contents changed, without reloading the
+     * plug-in core. Returns the number of scripts that were reloaded.
+    */
+    Int32 ReloadChanged();
+
+    /* --------------------------------------------------------------------------------------------
+     * Compile and execute again a loaded script, without reloading the plug-in core.
+    */
+    bool ReloadScript(CSStr path);
+
     /* --------------------------------------------------------------------------------------------
      * Modify the current plug-in state.
     */
@@ -816,6 +911,38 @@ public:
         m_AreasEnabled = toggle;
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * See whether client script data is sent to players as (possibly compressed) blocks.
+    */
+    bool CompressSends() const
+    {
+        return m_CompressSends;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Toggle whether client script data is sent to players as (possibly compressed) blocks.
+    */
+    void CompressSends(bool toggle)
+    {
+        m_CompressSends = toggle;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the minimum size of client script data before it is compressed.
+    */
+    Uint32 CompressThreshold() const
+    {
+        return m_CompressThreshold;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the minimum size of client script data before it is compressed.
+    */
+    void CompressThreshold(Uint32 size)
+    {
+        m_CompressThreshold = size;
+    }
+
     /* --------------------------------------------------------------------------------------------
      * Retrieve the value of the specified option.
     */
@@ -857,6 +984,38 @@ public:
         return m_PendingScripts;
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the cache of compiled scripts.
+    */
+    const ScriptCache & GetScriptCache() const
+    {
+        return m_ScriptCache;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the scheduler of the garbage collector.
+    */
+    Collector & GetCollector()
+    {
+        return m_Collector;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the sampling profiler for scripts.
+    */
+    Profiler & GetProfiler()
+    {
+        return m_Profiler;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the time spent in callbacks and frames.
+    */
+    Metrics & GetMetrics()
+    {
+        return m_Metrics;
+    }
+
     /* --------------------------------------------------------------------------------------------
      * Retrieve the virtual machine.
     */
@@ -977,6 +1136,11 @@ protected:
     */
     static bool DoScripts(Scripts::iterator itr, Scripts::iterator end);
 
+    /* --------------------------------------------------------------------------------------------
+     * Compile and execute again the loaded script at the specified index.
+    */
+    bool RedoScript(size_t idx);
+
     /* --------------------------------------------------------------------------------------------
      * Script output handlers.
     */
@@ -1022,6 +1186,12 @@ protected:
     void DeallocPickup(Int32 id, bool destroy, Int32 header, LightObj & payload);
     void DeallocVehicle(Int32 id, bool destroy, Int32 header, LightObj & payload);
 
+    /* --------------------------------------------------------------------------------------------
+     * Active entity list maintenance.
+    */
+    static void InsertActive(ActiveList & list, Int32 id);
+    static void RemoveActive(ActiveList & list, Int32 id);
+
 public:
 
     /* --------------------------------------------------------------------------------------------
@@ -1089,6 +1259,34 @@ public:
     const Players & GetPlayers() const { return m_Players; }
     const Vehicles & GetVehicles() const { return m_Vehicles; }
 
+    /* --------------------------------------------------------------------------------------------
+     * Last known state retrievers.
+    */
+    PlayerState & GetPlayerState(Int32 id) { return m_PlayerStates.at(id); }
+    VehicleState & GetVehicleState(Int32 id) { return m_VehicleStates.at(id); }
+
+    /* --------------------------------------------------------------------------------------------
+     * Active entity retrievers.
+    */
+    const ActiveList & GetActiveBlips() const { return m_ActiveBlips; }
+    const ActiveList & GetActiveCheckpoints() const { return m_ActiveCheckpoints; }
+    const ActiveList & GetActiveKeybinds() const { return m_ActiveKeybinds; }
+    const ActiveList & GetActiveObjects() const { return m_ActiveObjects; }
+    const ActiveList & GetActivePickups() const { return m_ActivePickups; }
+    const ActiveList & GetActivePlayers() const { return m_ActivePlayers; }
+    const ActiveList & GetActiveVehicles() const { return m_ActiveVehicles; }
+
+    /* --------------------------------------------------------------------------------------------
+     * Tag index retrievers.
+    */
+    TagIndex & GetBlipTags() { return m_BlipTags; }
+    TagIndex & GetCheckpointTags() { return m_CheckpointTags; }
+    TagIndex & GetKeybindTags() { return m_KeybindTags; }
+    TagIndex & GetObjectTags() { return m_ObjectTags; }
+    TagIndex & GetPickupTags() { return m_PickupTags; }
+    TagIndex & GetPlayerTags() { return m_PlayerTags; }
+    TagIndex & GetVehicleTags() { return m_VehicleTags; }
+
     /* --------------------------------------------------------------------------------------------
      * Null instance retrievers.
     */
@@ -1260,6 +1458,7 @@ public:
     void EmitServerOption(Int32 option, bool value, Int32 header, LightObj & payload);
     void EmitScriptReload(Int32 header, LightObj & payload);
     void EmitScriptLoaded();
+    void EmitScriptReloaded(CSStr path);
 
     /* --------------------------------------------------------------------------------------------
      * Entity pool changes events.
@@ -1437,6 +1636,7 @@ public:
     SignalPair  mOnServerOption;
     SignalPair  mOnScriptReload;
     SignalPair  mOnScriptLoaded;
+    SignalPair  mOnScriptReloaded;
 };
 
 /* ------------------------------------------------------------------------------------------------
@@ -28,7 +28,7 @@ LightObj & CBlip::GetNull()
 // ------------------------------------------------------------------------------------------------
 CBlip::CBlip(Int32 id)
     : m_ID(VALID_ENTITYGETEX(id, SQMOD_BLIP_POOL))
-    , m_Tag(ToStrF("%d", id))
+    , m_Tag(ToStrF("%d", id)), m_TagObj()
 {
     /* ... */
 }
@@ -40,9 +40,9 @@ CBlip::~CBlip()
 }
 
 // ------------------------------------------------------------------------------------------------
-const String & CBlip::ToString() const
+const LightObj & CBlip::ToString()
 {
-    return m_Tag;
+    return GetTagObj();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -51,9 +51,27 @@ const String & CBlip::GetTag() const
     return m_Tag;
 }
 
+// ------------------------------------------------------------------------------------------------
+const LightObj & CBlip::GetTagObj()
+{
+    // Create the script string only once for each tag
+    if (m_TagObj.IsNull())
+    {
+        m_TagObj = LightObj(m_Tag.data(), static_cast< SQInteger >(m_Tag.size()));
+    }
+    return m_TagObj;
+}
+
 // ------------------------------------------------------------------------------------------------
 void CBlip::SetTag(StackStrF & tag)
 {
+    // Take the entity out of the tag index while the tag changes
+    if (VALID_ENTITY(m_ID))
+    {
+        Core::Get().GetBlipTags().Remove(m_ID, m_Tag);
+    }
+    // The script string of the previous tag is no longer valid
+    m_TagObj.Release();
     if (tag.mLen > 0)
     {
         m_Tag.assign(tag.mPtr, tag.mLen);
@@ -62,6 +80,11 @@ void CBlip::SetTag(StackStrF & tag)
     {
         m_Tag.clear();
     }
+    // Put the entity back in the tag index with the new tag
+    if (VALID_ENTITY(m_ID))
+    {
+        Core::Get().GetBlipTags().Insert(m_ID, m_Tag);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -299,7 +322,7 @@ void Register_CBlip(HSQUIRRELVM vm)
         // Core Properties
         .Prop(_SC("On"), &CBlip::GetEvents)
         .Prop(_SC("ID"), &CBlip::GetID)
-        .Prop(_SC("Tag"), &CBlip::GetTag, &CBlip::SetTag)
+        .Prop(_SC("Tag"), &CBlip::GetTagObj, &CBlip::SetTag)
         .Prop(_SC("Data"), &CBlip::GetData, &CBlip::SetData)
         .Prop(_SC("Active"), &CBlip::IsActive)
         // Core Methods
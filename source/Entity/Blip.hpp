@@ -27,6 +27,11 @@ private:
     */
     String      m_Tag;
 
+    /* --------------------------------------------------------------------------------------------
+     * Script string of the user tag, created when first requested.
+    */
+    LightObj    m_TagObj;
+
     /* --------------------------------------------------------------------------------------------
      * User data associated with this instance.
     */
@@ -83,7 +88,7 @@ public:
     /* --------------------------------------------------------------------------------------------
      * Used by the script engine to convert an instance of this type to a string.
     */
-    const String & ToString() const;
+    const LightObj & ToString();
 
     /* --------------------------------------------------------------------------------------------
      * Retrieve the associated null entity instance.
@@ -116,6 +121,11 @@ public:
     */
     const String & GetTag() const;
 
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the associated user tag as a script string.
+    */
+    const LightObj & GetTagObj();
+
     /* --------------------------------------------------------------------------------------------
      * Modify the associated user tag.
     */
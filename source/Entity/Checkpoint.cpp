@@ -31,7 +31,7 @@ LightObj & CCheckpoint::GetNull()
 // ------------------------------------------------------------------------------------------------
 CCheckpoint::CCheckpoint(Int32 id)
     : m_ID(VALID_ENTITYGETEX(id, SQMOD_CHECKPOINT_POOL))
-    , m_Tag(ToStrF("%d", id)), m_Data(), m_CircularLocks(0)
+    , m_Tag(ToStrF("%d", id)), m_TagObj(), m_Data(), m_CircularLocks(0)
 {
     /* ... */
 }
@@ -43,9 +43,9 @@ CCheckpoint::~CCheckpoint()
 }
 
 // ------------------------------------------------------------------------------------------------
-const String & CCheckpoint::ToString() const
+const LightObj & CCheckpoint::ToString()
 {
-    return m_Tag;
+    return GetTagObj();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -54,9 +54,27 @@ const String & CCheckpoint::GetTag() const
     return m_Tag;
 }
 
+// ------------------------------------------------------------------------------------------------
+const LightObj & CCheckpoint::GetTagObj()
+{
+    // Create the script string only once for each tag
+    if (m_TagObj.IsNull())
+    {
+        m_TagObj = LightObj(m_Tag.data(), static_cast< SQInteger >(m_Tag.size()));
+    }
+    return m_TagObj;
+}
+
 // ------------------------------------------------------------------------------------------------
 void CCheckpoint::SetTag(StackStrF & tag)
 {
+    // Take the entity out of the tag index while the tag changes
+    if (VALID_ENTITY(m_ID))
+    {
+        Core::Get().GetCheckpointTags().Remove(m_ID, m_Tag);
+    }
+    // The script string of the previous tag is no longer valid
+    m_TagObj.Release();
     if (tag.mLen > 0)
     {
         m_Tag.assign(tag.mPtr, tag.mLen);
@@ -65,6 +83,11 @@ void CCheckpoint::SetTag(StackStrF & tag)
     {
         m_Tag.clear();
     }
+    // Put the entity back in the tag index with the new tag
+    if (VALID_ENTITY(m_ID))
+    {
+        Core::Get().GetCheckpointTags().Insert(m_ID, m_Tag);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -520,7 +543,7 @@ void Register_CCheckpoint(HSQUIRRELVM vm)
         // Core Properties
         .Prop(_SC("On"), &CCheckpoint::GetEvents)
         .Prop(_SC("ID"), &CCheckpoint::GetID)
-        .Prop(_SC("Tag"), &CCheckpoint::GetTag, &CCheckpoint::SetTag)
+        .Prop(_SC("Tag"), &CCheckpoint::GetTagObj, &CCheckpoint::SetTag)
         .Prop(_SC("Data"), &CCheckpoint::GetData, &CCheckpoint::SetData)
         .Prop(_SC("Active"), &CCheckpoint::IsActive)
         // Core Methods
@@ -36,6 +36,11 @@ private:
     */
     String      m_Tag;
 
+    /* --------------------------------------------------------------------------------------------
+     * Script string of the user tag, created when first requested.
+    */
+    LightObj    m_TagObj;
+
     /* --------------------------------------------------------------------------------------------
      * User data associated with this instance.
     */
@@ -97,7 +102,7 @@ public:
     /* --------------------------------------------------------------------------------------------
      * Used by the script engine to convert an instance of this type to a string.
     */
-    const String & ToString() const;
+    const LightObj & ToString();
 
     /* --------------------------------------------------------------------------------------------
      * Retrieve the associated null entity instance.
@@ -130,6 +135,11 @@ public:
     */
     const String & GetTag() const;
 
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the associated user tag as a script string.
+    */
+    const LightObj & GetTagObj();
+
     /* --------------------------------------------------------------------------------------------
      * Modify the associated user tag.
     */
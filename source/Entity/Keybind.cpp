@@ -28,7 +28,7 @@ LightObj & CKeybind::GetNull()
 // ------------------------------------------------------------------------------------------------
 CKeybind::CKeybind(Int32 id)
     : m_ID(VALID_ENTITYGETEX(id, SQMOD_KEYBIND_POOL))
-    , m_Tag(ToStrF("%d", id))
+    , m_Tag(ToStrF("%d", id)), m_TagObj()
 {
     /* ... */
 }
@@ -40,9 +40,9 @@ CKeybind::~CKeybind()
 }
 
 // ------------------------------------------------------------------------------------------------
-const String & CKeybind::ToString() const
+const LightObj & CKeybind::ToString()
 {
-    return m_Tag;
+    return GetTagObj();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -51,9 +51,27 @@ const String & CKeybind::GetTag() const
     return m_Tag;
 }
 
+// ------------------------------------------------------------------------------------------------
+const LightObj & CKeybind::GetTagObj()
+{
+    // Create the script string only once for each tag
+    if (m_TagObj.IsNull())
+    {
+        m_TagObj = LightObj(m_Tag.data(), static_cast< SQInteger >(m_Tag.size()));
+    }
+    return m_TagObj;
+}
+
 // ------------------------------------------------------------------------------------------------
 void CKeybind::SetTag(StackStrF & tag)
 {
+    // Take the entity out of the tag index while the tag changes
+    if (VALID_ENTITY(m_ID))
+    {
+        Core::Get().GetKeybindTags().Remove(m_ID, m_Tag);
+    }
+    // The script string of the previous tag is no longer valid
+    m_TagObj.Release();
     if (tag.mLen > 0)
     {
         m_Tag.assign(tag.mPtr, tag.mLen);
@@ -62,6 +80,11 @@ void CKeybind::SetTag(StackStrF & tag)
     {
         m_Tag.clear();
     }
+    // Put the entity back in the tag index with the new tag
+    if (VALID_ENTITY(m_ID))
+    {
+        Core::Get().GetKeybindTags().Insert(m_ID, m_Tag);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -198,7 +221,7 @@ void Register_CKeybind(HSQUIRRELVM vm)
         // Core Properties
         .Prop(_SC("On"), &CKeybind::GetEvents)
         .Prop(_SC("ID"), &CKeybind::GetID)
-        .Prop(_SC("Tag"), &CKeybind::GetTag, &CKeybind::SetTag)
+        .Prop(_SC("Tag"), &CKeybind::GetTagObj, &CKeybind::SetTag)
         .Prop(_SC("Data"), &CKeybind::GetData, &CKeybind::SetData)
         .Prop(_SC("Active"), &CKeybind::IsActive)
         // Core Methods
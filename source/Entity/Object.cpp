@@ -31,7 +31,7 @@ LightObj & CObject::GetNull()
 // ------------------------------------------------------------------------------------------------
 CObject::CObject(Int32 id)
     : m_ID(VALID_ENTITYGETEX(id, SQMOD_OBJECT_POOL))
-    , m_Tag(ToStrF("%d", id)), m_Data(), m_CircularLocks(0)
+    , m_Tag(ToStrF("%d", id)), m_TagObj(), m_Data(), m_CircularLocks(0)
     , mMoveToDuration(0)
     , mMoveByDuration(0)
     , mRotateToDuration(0)
@@ -49,9 +49,9 @@ CObject::~CObject()
 }
 
 // ------------------------------------------------------------------------------------------------
-const String & CObject::ToString() const
+const LightObj & CObject::ToString()
 {
-    return m_Tag;
+    return GetTagObj();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -60,9 +60,27 @@ const String & CObject::GetTag() const
     return m_Tag;
 }
 
+// ------------------------------------------------------------------------------------------------
+const LightObj & CObject::GetTagObj()
+{
+    // Create the script string only once for each tag
+    if (m_TagObj.IsNull())
+    {
+        m_TagObj = LightObj(m_Tag.data(), static_cast< SQInteger >(m_Tag.size()));
+    }
+    return m_TagObj;
+}
+
 // ------------------------------------------------------------------------------------------------
 void CObject::SetTag(StackStrF & tag)
 {
+    // Take the entity out of the tag index while the tag changes
+    if (VALID_ENTITY(m_ID))
+    {
+        Core::Get().GetObjectTags().Remove(m_ID, m_Tag);
+    }
+    // The script string of the previous tag is no longer valid
+    m_TagObj.Release();
     if (tag.mLen > 0)
     {
         m_Tag.assign(tag.mPtr, tag.mLen);
@@ -71,6 +89,11 @@ void CObject::SetTag(StackStrF & tag)
     {
         m_Tag.clear();
     }
+    // Put the entity back in the tag index with the new tag
+    if (VALID_ENTITY(m_ID))
+    {
+        Core::Get().GetObjectTags().Insert(m_ID, m_Tag);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -886,7 +909,7 @@ void Register_CObject(HSQUIRRELVM vm)
         // Core Properties
         .Prop(_SC("On"), &CObject::GetEvents)
         .Prop(_SC("ID"), &CObject::GetID)
-        .Prop(_SC("Tag"), &CObject::GetTag, &CObject::SetTag)
+        .Prop(_SC("Tag"), &CObject::GetTagObj, &CObject::SetTag)
         .Prop(_SC("Data"), &CObject::GetData, &CObject::SetData)
         .Prop(_SC("Active"), &CObject::IsActive)
         // Core Methods
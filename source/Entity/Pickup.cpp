@@ -30,7 +30,7 @@ LightObj & CPickup::GetNull()
 // ------------------------------------------------------------------------------------------------
 CPickup::CPickup(Int32 id)
     : m_ID(VALID_ENTITYGETEX(id, SQMOD_PICKUP_POOL))
-    , m_Tag(ToStrF("%d", id)), m_Data(), m_CircularLocks(0)
+    , m_Tag(ToStrF("%d", id)), m_TagObj(), m_Data(), m_CircularLocks(0)
 {
     /* ... */
 }
@@ -42,9 +42,9 @@ CPickup::~CPickup()
 }
 
 // ------------------------------------------------------------------------------------------------
-const String & CPickup::ToString() const
+const LightObj & CPickup::ToString()
 {
-    return m_Tag;
+    return GetTagObj();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -53,9 +53,27 @@ const String & CPickup::GetTag() const
     return m_Tag;
 }
 
+// ------------------------------------------------------------------------------------------------
+const LightObj & CPickup::GetTagObj()
+{
+    // Create the script string only once for each tag
+    if (m_TagObj.IsNull())
+    {
+        m_TagObj = LightObj(m_Tag.data(), static_cast< SQInteger >(m_Tag.size()));
+    }
+    return m_TagObj;
+}
+
 // ------------------------------------------------------------------------------------------------
 void CPickup::SetTag(StackStrF & tag)
 {
+    // Take the entity out of the tag index while the tag changes
+    if (VALID_ENTITY(m_ID))
+    {
+        Core::Get().GetPickupTags().Remove(m_ID, m_Tag);
+    }
+    // The script string of the previous tag is no longer valid
+    m_TagObj.Release();
     if (tag.mLen > 0)
     {
         m_Tag.assign(tag.mPtr, tag.mLen);
@@ -64,6 +82,11 @@ void CPickup::SetTag(StackStrF & tag)
     {
         m_Tag.clear();
     }
+    // Put the entity back in the tag index with the new tag
+    if (VALID_ENTITY(m_ID))
+    {
+        Core::Get().GetPickupTags().Insert(m_ID, m_Tag);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -497,7 +520,7 @@ void Register_CPickup(HSQUIRRELVM vm)
         // Core Properties
         .Prop(_SC("On"), &CPickup::GetEvents)
         .Prop(_SC("ID"), &CPickup::GetID)
-        .Prop(_SC("Tag"), &CPickup::GetTag, &CPickup::SetTag)
+        .Prop(_SC("Tag"), &CPickup::GetTagObj, &CPickup::SetTag)
         .Prop(_SC("Data"), &CPickup::GetData, &CPickup::SetData)
         .Prop(_SC("Active"), &CPickup::IsActive)
         // Core Methods
@@ -39,6 +39,11 @@ private:
     */
     String      m_Tag;
 
+    /* --------------------------------------------------------------------------------------------
+     * Script string of the user tag, created when first requested.
+    */
+    LightObj    m_TagObj;
+
     /* --------------------------------------------------------------------------------------------
      * User data associated with this instance.
     */
@@ -100,7 +105,7 @@ public:
     /* --------------------------------------------------------------------------------------------
      * Used by the script engine to convert an instance of this type to a string.
     */
-    const String & ToString() const;
+    const LightObj & ToString();
 
     /* --------------------------------------------------------------------------------------------
      * Retrieve the associated null entity instance.
@@ -133,6 +138,11 @@ public:
     */
     const String & GetTag() const;
 
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the associated user tag as a script string.
+    */
+    const LightObj & GetTagObj();
+
     /* --------------------------------------------------------------------------------------------
      * Modify the associated user tag.
     */
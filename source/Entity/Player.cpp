@@ -46,7 +46,7 @@ LightObj & CPlayer::GetNull()
 // ------------------------------------------------------------------------------------------------
 CPlayer::CPlayer(Int32 id)
     : m_ID(VALID_ENTITYGETEX(id, SQMOD_PLAYER_POOL))
-    , m_Tag(ToStrF("%d", id)), m_Data(), m_Buffer(256), m_CircularLocks(0)
+    , m_Tag(ToStrF("%d", id)), m_TagObj(), m_NameObj(), m_Data(), m_Buffer(256), m_CircularLocks(0)
     , mBufferInitSize(256)
     , mMessageColor(0x6599FFFF)
     , mAnnounceStyle(1)
@@ -57,6 +57,7 @@ CPlayer::CPlayer(Int32 id)
     , mAnnouncePostfix(_SC(""))
     , mMessagePrefixes()
     , mLimitPrefixPostfixMessage(true)
+    , mBroadcastMask(0)
 {
     // Reset message prefixes
     for (unsigned n = 0; n < SQMOD_PLAYER_MSG_PREFIXES; ++n)
@@ -72,9 +73,9 @@ CPlayer::~CPlayer()
 }
 
 // ------------------------------------------------------------------------------------------------
-const String & CPlayer::ToString() const
+const LightObj & CPlayer::ToString()
 {
-    return m_Tag;
+    return GetTagObj();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -83,9 +84,27 @@ const String & CPlayer::GetTag() const
     return m_Tag;
 }
 
+// ------------------------------------------------------------------------------------------------
+const LightObj & CPlayer::GetTagObj()
+{
+    // Create the script string only once for each tag
+    if (m_TagObj.IsNull())
+    {
+        m_TagObj = LightObj(m_Tag.data(), static_cast< SQInteger >(m_Tag.size()));
+    }
+    return m_TagObj;
+}
+
 // ------------------------------------------------------------------------------------------------
 void CPlayer::SetTag(StackStrF & tag)
 {
+    // Take the entity out of the tag index while the tag changes
+    if (VALID_ENTITY(m_ID))
+    {
+        Core::Get().GetPlayerTags().Remove(m_ID, m_Tag);
+    }
+    // The script string of the previous tag is no longer valid
+    m_TagObj.Release();
     if (tag.mLen > 0)
     {
         m_Tag.assign(tag.mPtr, tag.mLen);
@@ -94,6 +113,11 @@ void CPlayer::SetTag(StackStrF & tag)
     {
         m_Tag.clear();
     }
+    // Put the entity back in the tag index with the new tag
+    if (VALID_ENTITY(m_ID))
+    {
+        Core::Get().GetPlayerTags().Insert(m_ID, m_Tag);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -323,10 +347,23 @@ CSStr CPlayer::GetName() const
 }
 
 // ------------------------------------------------------------------------------------------------
-void CPlayer::SetName(StackStrF & name) const
+const LightObj & CPlayer::GetNameObj()
+{
+    // Create the script string only once for each name
+    if (m_NameObj.IsNull())
+    {
+        m_NameObj = LightObj(GetName(), -1);
+    }
+    return m_NameObj;
+}
+
+// ------------------------------------------------------------------------------------------------
+void CPlayer::SetName(StackStrF & name)
 {
     // Validate the managed identifier
     Validate();
+    // The script string of the current name is no longer valid
+    m_NameObj.Release();
     // Perform the requested operation
     const vcmpError ret = _Func->SetPlayerName(m_ID, name.mPtr);
     // Validate the resulted status
@@ -1729,7 +1766,7 @@ Int32 CPlayer::GetLastWeapon() const
     // Validate the managed identifier
     Validate();
     // Return the requested information
-    return Core::Get().GetPlayer(m_ID).mLastWeapon;
+    return Core::Get().GetPlayerState(m_ID).mLastWeapon;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1738,7 +1775,7 @@ Float32 CPlayer::GetLastHealth() const
     // Validate the managed identifier
     Validate();
     // Return the requested information
-    return Core::Get().GetPlayer(m_ID).mLastHealth;
+    return Core::Get().GetPlayerState(m_ID).mLastHealth;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1747,7 +1784,7 @@ Float32 CPlayer::GetLastArmour() const
     // Validate the managed identifier
     Validate();
     // Return the requested information
-    return Core::Get().GetPlayer(m_ID).mLastArmour;
+    return Core::Get().GetPlayerState(m_ID).mLastArmour;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1756,7 +1793,7 @@ Float32 CPlayer::GetLastHeading() const
     // Validate the managed identifier
     Validate();
     // Return the requested information
-    return Core::Get().GetPlayer(m_ID).mLastHeading;
+    return Core::Get().GetPlayerState(m_ID).mLastHeading;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1765,7 +1802,7 @@ const Vector3 & CPlayer::GetLastPosition() const
     // Validate the managed identifier
     Validate();
     // Return the requested information
-    return Core::Get().GetPlayer(m_ID).mLastPosition;
+    return Core::Get().GetPlayerState(m_ID).mLastPosition;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1877,7 +1914,7 @@ void CPlayer::FlushStream(bool reset)
         STHROWF("Cannot send empty stream buffer");
     }
     // Attempt to send the stream buffer contents
-    const vcmpError result = _Func->SendClientScriptData(m_ID, m_Buffer.Data(), m_Buffer.Position());
+    const vcmpError result = SendClientData(m_ID, m_Buffer.Data(), m_Buffer.Position());
     // Should we reset the buffer cursor?
     if (reset)
     {
@@ -1909,8 +1946,7 @@ void CPlayer::SendBuffer(const SqBuffer & buffer) const
         STHROWF("Cannot send empty stream buffer");
     }
     // Attempt to send the stream buffer contents
-    const vcmpError result = _Func->SendClientScriptData(m_ID, buffer.GetRef()->Data(),
-                                                                buffer.GetRef()->Position());
+    const vcmpError result = SendClientData(m_ID, buffer.GetRef()->Data(), buffer.GetRef()->Position());
     // Check for errors
     if (result == vcmpErrorTooLargeInput)
     {
@@ -1918,6 +1954,21 @@ void CPlayer::SendBuffer(const SqBuffer & buffer) const
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+vcmpError CPlayer::SendClientData(Int32 id, CCStr data, Uint32 size)
+{
+    // Should the data be sent as is?
+    if (!Core::Get().CompressSends())
+    {
+        return _Func->SendClientScriptData(id, data, size);
+    }
+    // Wrap the data into a block
+    Buffer b(size + 16);
+    CompressBlock(b, data, size, Core::Get().CompressThreshold());
+    // Send the resulted block
+    return _Func->SendClientScriptData(id, b.Data(), b.Position());
+}
+
 // ------------------------------------------------------------------------------------------------
 Float32 CPlayer::GetPositionX() const
 {
@@ -2706,10 +2757,11 @@ void Register_CPlayer(HSQUIRRELVM vm)
         .Var(_SC("AnnouncePrefix"), &CPlayer::mAnnouncePrefix)
         .Var(_SC("AnnouncePostfix"), &CPlayer::mAnnouncePostfix)
         .Var(_SC("LimitPrefixPostfixMessage"), &CPlayer::mLimitPrefixPostfixMessage)
+        .Var(_SC("BroadcastMask"), &CPlayer::mBroadcastMask)
         // Core Properties
         .Prop(_SC("On"), &CPlayer::GetEvents)
         .Prop(_SC("ID"), &CPlayer::GetID)
-        .Prop(_SC("Tag"), &CPlayer::GetTag, &CPlayer::SetTag)
+        .Prop(_SC("Tag"), &CPlayer::GetTagObj, &CPlayer::SetTag)
         .Prop(_SC("Data"), &CPlayer::GetData, &CPlayer::SetData)
         .Prop(_SC("Active"), &CPlayer::IsActive)
         // Core Methods
@@ -2722,7 +2774,7 @@ void Register_CPlayer(HSQUIRRELVM vm)
         .Prop(_SC("UID"), &CPlayer::GetUID)
         .Prop(_SC("UID2"), &CPlayer::GetUID2)
         .Prop(_SC("Key"), &CPlayer::GetKey)
-        .Prop(_SC("Name"), &CPlayer::GetName, &CPlayer::SetName)
+        .Prop(_SC("Name"), &CPlayer::GetNameObj, &CPlayer::SetName)
         .Prop(_SC("State"), &CPlayer::GetState)
         .Prop(_SC("World"), &CPlayer::GetWorld, &CPlayer::SetWorld)
         .Prop(_SC("SecWorld"), &CPlayer::GetSecondaryWorld, &CPlayer::SetSecondaryWorld)
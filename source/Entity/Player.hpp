@@ -48,6 +48,16 @@ private:
     */
     String      m_Tag;
 
+    /* --------------------------------------------------------------------------------------------
+     * Script string of the user tag, created when first requested.
+    */
+    LightObj    m_TagObj;
+
+    /* --------------------------------------------------------------------------------------------
+     * Script string of the nick name, created when first requested.
+    */
+    LightObj    m_NameObj;
+
     /* --------------------------------------------------------------------------------------------
      * User data associated with this instance.
     */
@@ -128,6 +138,11 @@ public:
     */
     bool            mLimitPrefixPostfixMessage;
 
+    /* --------------------------------------------------------------------------------------------
+     * User defined bits which can be used to select the player in filtered broadcasts.
+    */
+    Uint32          mBroadcastMask;
+
     /* --------------------------------------------------------------------------------------------
      * Copy constructor. (disabled)
     */
@@ -167,7 +182,7 @@ public:
     /* --------------------------------------------------------------------------------------------
      * Used by the script engine to convert an instance of this type to a string.
     */
-    const String & ToString() const;
+    const LightObj & ToString();
 
     /* --------------------------------------------------------------------------------------------
      * Retrieve the associated null entity instance.
@@ -200,6 +215,11 @@ public:
     */
     const String & GetTag() const;
 
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the associated user tag as a script string.
+    */
+    const LightObj & GetTagObj();
+
     /* --------------------------------------------------------------------------------------------
      * Modify the associated user tag.
     */
@@ -300,10 +320,15 @@ public:
     */
     CSStr GetName() const;
 
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the nick name of the managed player entity as a script string.
+    */
+    const LightObj & GetNameObj();
+
     /* --------------------------------------------------------------------------------------------
      * Modify the nick name of the managed player entity.
     */
-    void SetName(StackStrF & name) const;
+    void SetName(StackStrF & name);
 
     /* --------------------------------------------------------------------------------------------
      * Retrieve the current state of the managed player entity.
@@ -986,6 +1011,12 @@ public:
     */
     void SendBuffer(const SqBuffer & buffer) const;
 
+    /* --------------------------------------------------------------------------------------------
+     * Send client script data to the specified player, wrapped in a (possibly compressed) block
+     * if that was enabled.
+    */
+    static vcmpError SendClientData(Int32 id, CCStr data, Uint32 size);
+
     /* --------------------------------------------------------------------------------------------
      * Retrieve the position on the x axis of the managed player entity.
     */
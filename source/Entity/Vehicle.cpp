@@ -33,7 +33,7 @@ LightObj & CVehicle::GetNull()
 // ------------------------------------------------------------------------------------------------
 CVehicle::CVehicle(Int32 id)
     : m_ID(VALID_ENTITYGETEX(id, SQMOD_VEHICLE_POOL))
-    , m_Tag(ToStrF("%d", id)), m_Data(), m_CircularLocks(0)
+    , m_Tag(ToStrF("%d", id)), m_TagObj(), m_Data(), m_CircularLocks(0)
 {
     /* ... */
 }
@@ -45,9 +45,9 @@ CVehicle::~CVehicle()
 }
 
 // ------------------------------------------------------------------------------------------------
-const String & CVehicle::ToString() const
+const LightObj & CVehicle::ToString()
 {
-    return m_Tag;
+    return GetTagObj();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -56,9 +56,27 @@ const String & CVehicle::GetTag() const
     return m_Tag;
 }
 
+// ------------------------------------------------------------------------------------------------
+const LightObj & CVehicle::GetTagObj()
+{
+    // Create the script string only once for each tag
+    if (m_TagObj.IsNull())
+    {
+        m_TagObj = LightObj(m_Tag.data(), static_cast< SQInteger >(m_Tag.size()));
+    }
+    return m_TagObj;
+}
+
 // ------------------------------------------------------------------------------------------------
 void CVehicle::SetTag(StackStrF & tag)
 {
+    // Take the entity out of the tag index while the tag changes
+    if (VALID_ENTITY(m_ID))
+    {
+        Core::Get().GetVehicleTags().Remove(m_ID, m_Tag);
+    }
+    // The script string of the previous tag is no longer valid
+    m_TagObj.Release();
     if (tag.mLen > 0)
     {
         m_Tag.assign(tag.mPtr, tag.mLen);
@@ -67,6 +85,11 @@ void CVehicle::SetTag(StackStrF & tag)
     {
         m_Tag.clear();
     }
+    // Put the entity back in the tag index with the new tag
+    if (VALID_ENTITY(m_ID))
+    {
+        Core::Get().GetVehicleTags().Insert(m_ID, m_Tag);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1303,7 +1326,7 @@ Int32 CVehicle::GetLastPrimaryColor() const
     // Validate the managed identifier
     Validate();
     // Return the requested information
-    return Core::Get().GetVehicle(m_ID).mLastPrimaryColor;
+    return Core::Get().GetVehicleState(m_ID).mLastPrimaryColor;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1312,7 +1335,7 @@ Int32 CVehicle::GetLastSecondaryColor() const
     // Validate the managed identifier
     Validate();
     // Return the requested information
-    return Core::Get().GetVehicle(m_ID).mLastSecondaryColor;
+    return Core::Get().GetVehicleState(m_ID).mLastSecondaryColor;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1321,7 +1344,7 @@ Float32 CVehicle::GetLastHealth() const
     // Validate the managed identifier
     Validate();
     // Return the requested information
-    return Core::Get().GetVehicle(m_ID).mLastHealth;
+    return Core::Get().GetVehicleState(m_ID).mLastHealth;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1330,7 +1353,7 @@ const Vector3 & CVehicle::GetLastPosition() const
     // Validate the managed identifier
     Validate();
     // Return the requested information
-    return Core::Get().GetVehicle(m_ID).mLastPosition;
+    return Core::Get().GetVehicleState(m_ID).mLastPosition;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1339,7 +1362,7 @@ const Quaternion & CVehicle::GetLastRotation() const
     // Validate the managed identifier
     Validate();
     // Return the requested information
-    return Core::Get().GetVehicle(m_ID).mLastRotation;
+    return Core::Get().GetVehicleState(m_ID).mLastRotation;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1958,7 +1981,7 @@ void Register_CVehicle(HSQUIRRELVM vm)
         // Core Properties
         .Prop(_SC("On"), &CVehicle::GetEvents)
         .Prop(_SC("ID"), &CVehicle::GetID)
-        .Prop(_SC("Tag"), &CVehicle::GetTag, &CVehicle::SetTag)
+        .Prop(_SC("Tag"), &CVehicle::GetTagObj, &CVehicle::SetTag)
         .Prop(_SC("Data"), &CVehicle::GetData, &CVehicle::SetData)
         .Prop(_SC("Active"), &CVehicle::IsActive)
         // Core Methods
@@ -10,6 +10,7 @@ namespace SqMod {
 
 // ------------------------------------------------------------------------------------------------
 extern void Register_Buffer(HSQUIRRELVM vm);
+extern void Register_BufferLayout(HSQUIRRELVM vm);
 
 /* ------------------------------------------------------------------------------------------------
  * Probably not the best implementation but should cover all sorts of weird cases.
@@ -93,6 +94,7 @@ void Register_Utils(HSQUIRRELVM vm)
     );
 
     Register_Buffer(vm);
+    Register_BufferLayout(vm);
 }
 
 } // Namespace:: SqMod
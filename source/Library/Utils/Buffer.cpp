@@ -1,5 +1,6 @@
 // ------------------------------------------------------------------------------------------------
 #include "Library/Utils/Buffer.hpp"
+#include "Library/Utils/Layout.hpp"
 #include "Library/Numeric/LongInt.hpp"
 #include "Base/AABB.hpp"
 #include "Base/Circle.hpp"
@@ -13,13 +14,306 @@
 #include "Base/Vector4.hpp"
 
 // ------------------------------------------------------------------------------------------------
+#include <cmath>
 #include <cstring>
 
+// ------------------------------------------------------------------------------------------------
+#include <lz4.h>
+
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
 
 // ------------------------------------------------------------------------------------------------
 SQMODE_DECL_TYPENAME(Typename, _SC("SqBuffer"))
+SQMODE_DECL_TYPENAME(ViewTypename, _SC("SqBufferView"))
+
+/* ------------------------------------------------------------------------------------------------
+ * Make sure the number of bits for a packed value is within the supported range.
+*/
+static inline Uint32 ValidateBits(SQInteger bits)
+{
+    if (bits < 1 || bits > 32)
+    {
+        STHROWF("Number of bits (%lld) is outside the supported range [1, 32]", static_cast< Int64 >(bits));
+    }
+    return static_cast< Uint32 >(bits);
+}
+
+// ------------------------------------------------------------------------------------------------
+void EncodeVarUint(Buffer & b, Uint64 n)
+{
+    // Write groups of 7 bits with the high bit telling whether more follow
+    while (n >= 0x80)
+    {
+        b.Push< Uint8 >(static_cast< Uint8 >((n & 0x7F) | 0x80));
+        n >>= 7;
+    }
+    // Write the last group
+    b.Push< Uint8 >(static_cast< Uint8 >(n));
+}
+
+// ------------------------------------------------------------------------------------------------
+Uint64 DecodeVarUint(CCStr data, Buffer::SzType size, Buffer::SzType & cur)
+{
+    Uint64 n = 0;
+    // Read groups of 7 bits until one without the high bit is found
+    for (Uint32 shift = 0; ; shift += 7)
+    {
+        // Is there any data left?
+        if (cur >= size)
+        {
+            STHROWF("Variable length integer starting at (%u) exceeds the buffer size (%u)", cur, size);
+        }
+        // Would this overflow a 64 bit integer?
+        else if (shift >= 64)
+        {
+            STHROWF("Variable length integer at (%u) is too long", cur);
+        }
+        // Grab the next group
+        const Uint8 byte = static_cast< Uint8 >(data[cur++]);
+        n |= static_cast< Uint64 >(byte & 0x7F) << shift;
+        // Was this the last group?
+        if (!(byte & 0x80))
+        {
+            break;
+        }
+    }
+    // Return the decoded value
+    return n;
+}
+
+// ------------------------------------------------------------------------------------------------
+Uint32 Quantize(SQFloat value, SQFloat min, SQFloat max, SQInteger bits)
+{
+    const Uint64 steps = (static_cast< Uint64 >(1) << ValidateBits(bits)) - 1;
+    // Is the range valid?
+    if (!(max > min))
+    {
+        STHROWF("Invalid quantization range [%f, %f]", min, max);
+    }
+    // Clamp the value to the range (NaN ends up at the minimum)
+    value = !(value > min) ? min : ((value > max) ? max : value);
+    // Map it to the closest step with enough precision for 32 bits
+    const Uint64 step = static_cast< Uint64 >(std::llround((static_cast< Float64 >(value) - min) /
+                                                (static_cast< Float64 >(max) - min) * static_cast< Float64 >(steps)));
+    // Rounding must not step outside the range
+    return static_cast< Uint32 >(step > steps ? steps : step);
+}
+
+// ------------------------------------------------------------------------------------------------
+SQFloat Dequantize(Uint32 value, SQFloat min, SQFloat max, SQInteger bits)
+{
+    const Uint64 steps = (static_cast< Uint64 >(1) << ValidateBits(bits)) - 1;
+    // Map the step back to the range
+    return static_cast< SQFloat >(min + (static_cast< Float64 >(max) - min) *
+                                    (static_cast< Float64 >(value) / static_cast< Float64 >(steps)));
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Block types written by CompressBlock().
+*/
+enum BlockType
+{
+    BLOCK_STORED = 0,
+    BLOCK_LZ4
+};
+
+// ------------------------------------------------------------------------------------------------
+void CompressBlock(Buffer & b, CCStr data, Buffer::SzType size, Buffer::SzType threshold)
+{
+    // Is the data large enough to be worth compressing?
+    if (size && size >= threshold && lz4_compress_bound(static_cast< int >(size)) > 0)
+    {
+        // Obtain a temporary buffer large enough for the worst case
+        Buffer tmp(static_cast< Buffer::SzType >(lz4_compress_bound(static_cast< int >(size))));
+        // Attempt to compress the data
+        const int n = lz4_compress(data, tmp.Data(), static_cast< int >(size), static_cast< int >(tmp.Capacity()));
+        // Did it make the data smaller?
+        if (n > 0 && static_cast< Buffer::SzType >(n) < size)
+        {
+            b.Push< Uint8 >(BLOCK_LZ4);
+            EncodeVarUint(b, size);
+            EncodeVarUint(b, static_cast< Uint64 >(n));
+            b.Append(tmp.Data(), static_cast< Buffer::SzType >(n));
+            // We're done here
+            return;
+        }
+    }
+    // Store the data as is
+    b.Push< Uint8 >(BLOCK_STORED);
+    EncodeVarUint(b, size);
+    b.Append(data, size);
+}
+
+// ------------------------------------------------------------------------------------------------
+void DecompressBlock(Buffer & b, CCStr data, Buffer::SzType size, Buffer::SzType & cur)
+{
+    // Is there enough data for the block type?
+    if (cur >= size)
+    {
+        STHROWF("Unable to read a compressed block at (%u) from (%u) bytes", cur, size);
+    }
+    // Grab the block type
+    const Uint8 type = static_cast< Uint8 >(data[cur]);
+    // Work on a copy of the cursor until the block is fully read
+    Buffer::SzType pos = cur + 1;
+    // Grab the size of the original data
+    const Uint64 raw = DecodeVarUint(data, size, pos);
+    // See what kind of block this is
+    if (type == BLOCK_STORED)
+    {
+        // Is the data all there?
+        if (raw > (size - pos))
+        {
+            STHROWF("Stored block of (%llu) bytes exceeds the remaining (%u) bytes", raw, size - pos);
+        }
+        // Copy the data as is
+        b.Append(data + pos, static_cast< Buffer::SzType >(raw));
+        pos += static_cast< Buffer::SzType >(raw);
+    }
+    else if (type == BLOCK_LZ4)
+    {
+        // Grab the size of the compressed data
+        const Uint64 packed = DecodeVarUint(data, size, pos);
+        // Is the compressed data all there?
+        if (packed > (size - pos))
+        {
+            STHROWF("Compressed block of (%llu) bytes exceeds the remaining (%u) bytes", packed, size - pos);
+        }
+        // LZ4 can't expand the data more than this so don't trust larger sizes
+        else if (raw > (packed * 255 + 16) || raw > LZ4_MAX_INPUT_SIZE)
+        {
+            STHROWF("Compressed block claims an invalid size of (%llu) bytes", raw);
+        }
+        // Make sure the buffer can hold the original data
+        if (raw > b.Remaining())
+        {
+            b.Grow(static_cast< Buffer::SzType >(raw) - b.Remaining());
+        }
+        // Attempt to decompress the data
+        const int n = lz4_decompress(data + pos, b.Data() + b.Position(),
+                                        static_cast< int >(packed), static_cast< int >(raw));
+        // Did we obtain exactly what was promised?
+        if (n < 0 || static_cast< Uint64 >(n) != raw)
+        {
+            STHROWF("Compressed block at (%u) is malformed", cur);
+        }
+        // Move after the decompressed data
+        b.Advance(static_cast< Buffer::SzType >(raw));
+        pos += static_cast< Buffer::SzType >(packed);
+    }
+    else
+    {
+        STHROWF("Unknown block type (%u) at (%u)", static_cast< Uint32 >(type), cur);
+    }
+    // The block was read successfully
+    cur = pos;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Wrap the specified buffer into a script object.
+*/
+static Object WrapBuffer(Buffer && b)
+{
+    // Remember the current stack size
+    const StackGuard sg;
+    // Create a protected instance of a buffer wrapper with the specified buffer
+    DeleteGuard< SqBuffer > ad(new SqBuffer(std::move(b)));
+    // Transform the pointer into a script object
+    PushVar< SqBuffer * >(DefaultVM::Get(), ad.Get());
+    // The script took over the instance now
+    ad.Release();
+    // Return the resulted object
+    return Var< Object >(DefaultVM::Get(), -1).value;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SqBuffer::WriteBits(SQInteger val, SQInteger bits)
+{
+    const Uint32 n = ValidateBits(bits);
+    // Validate the managed buffer reference
+    Validate();
+    // Append the bits to the accumulator
+    m_WrBits.mBits |= (static_cast< Uint64 >(val) & ((static_cast< Uint64 >(1) << n) - 1)) << m_WrBits.mCount;
+    m_WrBits.mCount += n;
+    // Write every complete byte
+    while (m_WrBits.mCount >= 8)
+    {
+        m_Buffer->Push< Uint8 >(static_cast< Uint8 >(m_WrBits.mBits & 0xFF));
+        m_WrBits.mBits >>= 8;
+        m_WrBits.mCount -= 8;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SqBuffer::FlushBits()
+{
+    // Is there an incomplete byte?
+    if (m_WrBits.mCount)
+    {
+        // Validate the managed buffer reference
+        Validate();
+        // Write it padded with zeros
+        m_Buffer->Push< Uint8 >(static_cast< Uint8 >(m_WrBits.mBits & 0xFF));
+    }
+    // Start with a new byte
+    m_WrBits.Reset();
+}
+
+// ------------------------------------------------------------------------------------------------
+void SqBuffer::WriteQVector3(const Vector3 & val, SQFloat min, SQFloat max, SQInteger bits)
+{
+    WriteBits(Quantize(val.x, min, max, bits), bits);
+    WriteBits(Quantize(val.y, min, max, bits), bits);
+    WriteBits(Quantize(val.z, min, max, bits), bits);
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger SqBuffer::ReadVarUint()
+{
+    // Validate the managed buffer reference
+    ValidateDeeper();
+    // Decode the value starting at the cursor
+    SzType cur = m_Buffer->Position();
+    const Uint64 n = DecodeVarUint(m_Buffer->Data(), m_Buffer->Capacity(), cur);
+    // Move the cursor after the value
+    m_Buffer->Move(cur);
+    // Return the requested information
+    return static_cast< SQInteger >(n);
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger SqBuffer::ReadBits(SQInteger bits)
+{
+    const Uint32 n = ValidateBits(bits);
+    // Validate the managed buffer reference
+    ValidateDeeper();
+    // Read whole bytes until there are enough bits
+    while (m_RdBits.mCount < n)
+    {
+        const Uint8 byte = m_Buffer->Cursor< Uint8 >();
+        m_Buffer->Advance< Uint8 >(1);
+        // Append the bits to the accumulator
+        m_RdBits.mBits |= static_cast< Uint64 >(byte) << m_RdBits.mCount;
+        m_RdBits.mCount += 8;
+    }
+    // Extract the requested bits
+    const Uint64 val = m_RdBits.mBits & ((static_cast< Uint64 >(1) << n) - 1);
+    m_RdBits.mBits >>= n;
+    m_RdBits.mCount -= n;
+    // Return the requested information
+    return static_cast< SQInteger >(val);
+}
+
+// ------------------------------------------------------------------------------------------------
+Vector3 SqBuffer::ReadQVector3(SQFloat min, SQFloat max, SQInteger bits)
+{
+    const SQFloat x = ReadQuantized(min, max, bits);
+    const SQFloat y = ReadQuantized(min, max, bits);
+    const SQFloat z = ReadQuantized(min, max, bits);
+    // Return the requested information
+    return Vector3(x, y, z);
+}
 
 // ------------------------------------------------------------------------------------------------
 void SqBuffer::WriteInt64(const SLongInt & val)
@@ -387,9 +681,329 @@ Vector4 SqBuffer::ReadVector4()
     return Vector4(value);
 }
 
+// ------------------------------------------------------------------------------------------------
+Object SqBuffer::Compress() const
+{
+    // Validate the managed buffer reference
+    Validate();
+    // The compressed data is usually smaller than the original
+    Buffer b(m_Buffer->Position() / 2 + 16);
+    // Compress the data up to the cursor
+    CompressBlock(b, m_Buffer->Data(), m_Buffer->Position());
+    // Return the resulted buffer
+    return WrapBuffer(std::move(b));
+}
+
+// ------------------------------------------------------------------------------------------------
+Object SqBuffer::Decompress()
+{
+    // Validate the managed buffer reference
+    ValidateDeeper();
+    // Decompress the block at the cursor
+    Buffer b;
+    SzType cur = m_Buffer->Position();
+    DecompressBlock(b, m_Buffer->Data(), m_Buffer->Capacity(), cur);
+    // Move the cursor after the block
+    m_Buffer->Move(cur);
+    // Let the script read from the beginning
+    b.Move(0);
+    // Return the resulted buffer
+    return WrapBuffer(std::move(b));
+}
+
+// ------------------------------------------------------------------------------------------------
+Object SqBufferView::Copy() const
+{
+    // Make sure the view is valid
+    Validate(0);
+    // Remember the current stack size
+    const StackGuard sg;
+    // Create a protected instance of a buffer wrapper with a copy of the data
+    DeleteGuard< SqBuffer > ad(new SqBuffer(Buffer(m_Data, m_Size, m_Cur)));
+    // Transform the pointer into a script object
+    PushVar< SqBuffer * >(DefaultVM::Get(), ad.Get());
+    // The script took over the instance now
+    ad.Release();
+    // Return the resulted object
+    return Var< Object >(DefaultVM::Get(), -1).value;
+}
+
+// ------------------------------------------------------------------------------------------------
+Object SqBufferView::Decompress()
+{
+    // Make sure the view is valid
+    Validate(0);
+    // Decompress the block at the cursor
+    Buffer b;
+    DecompressBlock(b, m_Data, m_Size, m_Cur);
+    // Any pending bits belong to the skipped data
+    m_RdBits.Reset();
+    // Let the script read from the beginning
+    b.Move(0);
+    // Return the resulted buffer
+    return WrapBuffer(std::move(b));
+}
+
+// ------------------------------------------------------------------------------------------------
+SLongInt SqBufferView::ReadInt64()
+{
+    return SLongInt(Read< Int64 >());
+}
+
+// ------------------------------------------------------------------------------------------------
+ULongInt SqBufferView::ReadUint64()
+{
+    return ULongInt(Read< Uint64 >());
+}
+
+// ------------------------------------------------------------------------------------------------
+Object SqBufferView::ReadString()
+{
+    // Read the string length and convert it to little endian
+    Uint16 length = Read< Uint16 >();
+    length = ((length >> 8) & 0xFF) | ((length & 0xFF) << 8);
+    // Make sure the string is within range
+    Validate(length);
+    // Remember the current stack size
+    const StackGuard sg;
+    // Attempt to create the string as an object
+    sq_pushstring(DefaultVM::Get(), m_Data + m_Cur, length);
+    // Advance the cursor after the string
+    m_Cur += length;
+    // Return the resulted object
+    return Var< Object >(DefaultVM::Get(), -1).value;
+}
+
+// ------------------------------------------------------------------------------------------------
+Object SqBufferView::ReadRawString(SQInteger length)
+{
+    // Make sure the view is valid
+    Validate(0);
+    // Start with a length of zero
+    SzType len = 0;
+    // Should we identify the string length ourselves?
+    if (length < 0)
+    {
+        // Attempt to look for a string terminator
+        while ((m_Cur + len) < m_Size && m_Data[m_Cur + len] != '\0')
+        {
+            ++len;
+        }
+    }
+    else
+    {
+        len = ConvTo< SzType >::From(length);
+    }
+    // Make sure the string is within range
+    Validate(len);
+    // Remember the current stack size
+    const StackGuard sg;
+    // Attempt to create the string as an object
+    sq_pushstring(DefaultVM::Get(), m_Data + m_Cur, len);
+    // Advance the cursor after the string
+    m_Cur += len;
+    // Return the resulted object
+    return Var< Object >(DefaultVM::Get(), -1).value;
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger SqBufferView::ReadBits(SQInteger bits)
+{
+    const Uint32 n = ValidateBits(bits);
+    // Read whole bytes until there are enough bits
+    while (m_RdBits.mCount < n)
+    {
+        // Append the bits to the accumulator
+        m_RdBits.mBits |= static_cast< Uint64 >(Read< Uint8 >()) << m_RdBits.mCount;
+        m_RdBits.mCount += 8;
+    }
+    // Extract the requested bits
+    const Uint64 val = m_RdBits.mBits & ((static_cast< Uint64 >(1) << n) - 1);
+    m_RdBits.mBits >>= n;
+    m_RdBits.mCount -= n;
+    // Return the requested information
+    return static_cast< SQInteger >(val);
+}
+
+// ------------------------------------------------------------------------------------------------
+Vector3 SqBufferView::ReadQVector3(SQFloat min, SQFloat max, SQInteger bits)
+{
+    const SQFloat x = ReadQuantized(min, max, bits);
+    const SQFloat y = ReadQuantized(min, max, bits);
+    const SQFloat z = ReadQuantized(min, max, bits);
+    // Return the requested information
+    return Vector3(x, y, z);
+}
+
+// ------------------------------------------------------------------------------------------------
+AABB SqBufferView::ReadAABB()
+{
+    return Read< AABB >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Circle SqBufferView::ReadCircle()
+{
+    return Read< Circle >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Color3 SqBufferView::ReadColor3()
+{
+    return Read< Color3 >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Color4 SqBufferView::ReadColor4()
+{
+    return Read< Color4 >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Quaternion SqBufferView::ReadQuaternion()
+{
+    return Read< Quaternion >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Sphere SqBufferView::ReadSphere()
+{
+    return Read< Sphere >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Vector2 SqBufferView::ReadVector2()
+{
+    return Read< Vector2 >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Vector2i SqBufferView::ReadVector2i()
+{
+    return Read< Vector2i >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Vector3 SqBufferView::ReadVector3()
+{
+    return Read< Vector3 >();
+}
+
+// ------------------------------------------------------------------------------------------------
+Vector4 SqBufferView::ReadVector4()
+{
+    return Read< Vector4 >();
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBufferPoolRequests()
+{
+    return static_cast< SQInteger >(MemRef::GetStats().mRequests);
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBufferPoolHits()
+{
+    return static_cast< SQInteger >(MemRef::GetStats().mHits);
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBufferPoolMisses()
+{
+    const MemStats stats = MemRef::GetStats();
+    // Every request that was not a hit required a new allocation
+    return static_cast< SQInteger >(stats.mRequests - stats.mHits);
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQFloat SqBufferPoolHitRate()
+{
+    const MemStats stats = MemRef::GetStats();
+    // Avoid dividing by zero
+    if (!stats.mRequests)
+    {
+        return SQFloat(0.0);
+    }
+    // Return the fraction of requests served from the pool
+    return static_cast< SQFloat >(static_cast< double >(stats.mHits) / static_cast< double >(stats.mRequests));
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBufferPoolReleases()
+{
+    return static_cast< SQInteger >(MemRef::GetStats().mReleases);
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBufferPoolDiscarded()
+{
+    return static_cast< SQInteger >(MemRef::GetStats().mDiscarded);
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBufferPoolAllocated()
+{
+    return static_cast< SQInteger >(MemRef::GetStats().mAllocatedBytes);
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBufferPoolPooledBlocks()
+{
+    return static_cast< SQInteger >(MemRef::GetStats().mPooledBlocks);
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBufferPoolPooledBytes()
+{
+    return static_cast< SQInteger >(MemRef::GetStats().mPooledBytes);
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBufferPoolGetBlockLimit()
+{
+    return static_cast< SQInteger >(MemRef::GetBlockLimit());
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqBufferPoolSetBlockLimit(SQInteger blocks)
+{
+    MemRef::SetBlockLimit(ConvTo< Uint32 >::From(blocks));
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBufferPoolGetByteLimit()
+{
+    return static_cast< SQInteger >(MemRef::GetByteLimit());
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqBufferPoolSetByteLimit(SQInteger bytes)
+{
+    MemRef::SetByteLimit(ConvTo< Uint32 >::From(bytes));
+}
+
 // ================================================================================================
 void Register_Buffer(HSQUIRRELVM vm)
 {
+    RootTable(vm).Bind(_SC("SqBufferPool"), Table(vm)
+        .Func(_SC("Requests"), &SqBufferPoolRequests)
+        .Func(_SC("Hits"), &SqBufferPoolHits)
+        .Func(_SC("Misses"), &SqBufferPoolMisses)
+        .Func(_SC("HitRate"), &SqBufferPoolHitRate)
+        .Func(_SC("Releases"), &SqBufferPoolReleases)
+        .Func(_SC("Discarded"), &SqBufferPoolDiscarded)
+        .Func(_SC("Allocated"), &SqBufferPoolAllocated)
+        .Func(_SC("PooledBlocks"), &SqBufferPoolPooledBlocks)
+        .Func(_SC("PooledBytes"), &SqBufferPoolPooledBytes)
+        .Func(_SC("GetBlockLimit"), &SqBufferPoolGetBlockLimit)
+        .Func(_SC("SetBlockLimit"), &SqBufferPoolSetBlockLimit)
+        .Func(_SC("GetByteLimit"), &SqBufferPoolGetByteLimit)
+        .Func(_SC("SetByteLimit"), &SqBufferPoolSetByteLimit)
+        .Func(_SC("IsThreadSafe"), &MemRef::IsThreadSafe)
+        .Func(_SC("ResetStats"), &MemRef::ResetStats)
+        .Func(_SC("Clear"), &MemRef::Clear)
+    );
+
     RootTable(vm).Bind(Typename::Str,
         Class< SqBuffer >(vm, Typename::Str)
         // Constructors
@@ -410,6 +1024,7 @@ void Register_Buffer(HSQUIRRELVM vm)
         .Prop(_SC("Capacity"), &SqBuffer::GetCapacity, &SqBuffer::Adjust)
         .Prop(_SC("Position"), &SqBuffer::GetPosition, &SqBuffer::Move)
         .Prop(_SC("Remaining"), &SqBuffer::GetRemaining)
+        .Prop(_SC("PendingBits"), &SqBuffer::GetPendingBits)
         // Member Methods
         .Func(_SC("Get"), &SqBuffer::Get)
         .Func(_SC("Set"), &SqBuffer::Set)
@@ -433,6 +1048,12 @@ void Register_Buffer(HSQUIRRELVM vm)
         .Func(_SC("WriteUint64"), &SqBuffer::WriteUint64)
         .Func(_SC("WriteFloat32"), &SqBuffer::WriteFloat32)
         .Func(_SC("WriteFloat64"), &SqBuffer::WriteFloat64)
+        .Func(_SC("WriteVarUint"), &SqBuffer::WriteVarUint)
+        .Func(_SC("WriteVarInt"), &SqBuffer::WriteVarInt)
+        .Func(_SC("WriteBits"), &SqBuffer::WriteBits)
+        .Func(_SC("FlushBits"), &SqBuffer::FlushBits)
+        .Func(_SC("WriteQuantized"), &SqBuffer::WriteQuantized)
+        .Func(_SC("WriteQVector3"), &SqBuffer::WriteQVector3)
         .Func(_SC("WriteString"), &SqBuffer::WriteString)
         .Func(_SC("WriteRawString"), &SqBuffer::WriteRawString)
         .Func(_SC("WriteAABB"), &SqBuffer::WriteAABB)
@@ -459,6 +1080,12 @@ void Register_Buffer(HSQUIRRELVM vm)
         .Func(_SC("ReadUint64"), &SqBuffer::ReadUint64)
         .Func(_SC("ReadFloat32"), &SqBuffer::ReadFloat32)
         .Func(_SC("ReadFloat64"), &SqBuffer::ReadFloat64)
+        .Func(_SC("ReadVarUint"), &SqBuffer::ReadVarUint)
+        .Func(_SC("ReadVarInt"), &SqBuffer::ReadVarInt)
+        .Func(_SC("ReadBits"), &SqBuffer::ReadBits)
+        .Func(_SC("AlignBits"), &SqBuffer::AlignBits)
+        .Func(_SC("ReadQuantized"), &SqBuffer::ReadQuantized)
+        .Func(_SC("ReadQVector3"), &SqBuffer::ReadQVector3)
         .Func(_SC("ReadString"), &SqBuffer::ReadString)
         .Func(_SC("ReadRawString"), &SqBuffer::ReadRawString)
         .Func(_SC("ReadAABB"), &SqBuffer::ReadAABB)
@@ -471,6 +1098,61 @@ void Register_Buffer(HSQUIRRELVM vm)
         .Func(_SC("ReadVector2i"), &SqBuffer::ReadVector2i)
         .Func(_SC("ReadVector3"), &SqBuffer::ReadVector3)
         .Func(_SC("ReadVector4"), &SqBuffer::ReadVector4)
+        .Func(_SC("Compress"), &SqBuffer::Compress)
+        .Func(_SC("Decompress"), &SqBuffer::Decompress)
+        .SquirrelFunc(_SC("Pack"), &SqBufferLayout::PackBuffer)
+        .SquirrelFunc(_SC("Unpack"), &SqBufferLayout::UnpackBuffer)
+    );
+
+    RootTable(vm).Bind(ViewTypename::Str,
+        Class< SqBufferView, NoConstructor< SqBufferView > >(vm, ViewTypename::Str)
+        // Core Meta-methods
+        .SquirrelFunc(_SC("_typename"), &ViewTypename::Fn)
+        // Properties
+        .Prop(_SC("Valid"), &SqBufferView::IsAttached)
+        .Prop(_SC("Size"), &SqBufferView::GetSize)
+        .Prop(_SC("Position"), &SqBufferView::GetPosition, &SqBufferView::Move)
+        .Prop(_SC("Remaining"), &SqBufferView::GetRemaining)
+        // Member Methods
+        .Func(_SC("Get"), &SqBufferView::Get)
+        .Func(_SC("Move"), &SqBufferView::Move)
+        .Func(_SC("Advance"), &SqBufferView::Advance)
+        .Func(_SC("Retreat"), &SqBufferView::Retreat)
+        .Func(_SC("Copy"), &SqBufferView::Copy)
+        .Func(_SC("Decompress"), &SqBufferView::Decompress)
+        .Func(_SC("ReadByte"), &SqBufferView::ReadUint8)
+        .Func(_SC("ReadShort"), &SqBufferView::ReadInt16)
+        .Func(_SC("ReadInt"), &SqBufferView::ReadInt32)
+        .Func(_SC("ReadFloat"), &SqBufferView::ReadFloat32)
+        .Func(_SC("ReadInt8"), &SqBufferView::ReadInt8)
+        .Func(_SC("ReadUint8"), &SqBufferView::ReadUint8)
+        .Func(_SC("ReadInt16"), &SqBufferView::ReadInt16)
+        .Func(_SC("ReadUint16"), &SqBufferView::ReadUint16)
+        .Func(_SC("ReadInt32"), &SqBufferView::ReadInt32)
+        .Func(_SC("ReadUint32"), &SqBufferView::ReadUint32)
+        .Func(_SC("ReadInt64"), &SqBufferView::ReadInt64)
+        .Func(_SC("ReadUint64"), &SqBufferView::ReadUint64)
+        .Func(_SC("ReadFloat32"), &SqBufferView::ReadFloat32)
+        .Func(_SC("ReadFloat64"), &SqBufferView::ReadFloat64)
+        .Func(_SC("ReadVarUint"), &SqBufferView::ReadVarUint)
+        .Func(_SC("ReadVarInt"), &SqBufferView::ReadVarInt)
+        .Func(_SC("ReadBits"), &SqBufferView::ReadBits)
+        .Func(_SC("AlignBits"), &SqBufferView::AlignBits)
+        .Func(_SC("ReadQuantized"), &SqBufferView::ReadQuantized)
+        .Func(_SC("ReadQVector3"), &SqBufferView::ReadQVector3)
+        .Func(_SC("ReadString"), &SqBufferView::ReadString)
+        .Func(_SC("ReadRawString"), &SqBufferView::ReadRawString)
+        .Func(_SC("ReadAABB"), &SqBufferView::ReadAABB)
+        .Func(_SC("ReadCircle"), &SqBufferView::ReadCircle)
+        .Func(_SC("ReadColor3"), &SqBufferView::ReadColor3)
+        .Func(_SC("ReadColor4"), &SqBufferView::ReadColor4)
+        .Func(_SC("ReadQuaternion"), &SqBufferView::ReadQuaternion)
+        .Func(_SC("ReadSphere"), &SqBufferView::ReadSphere)
+        .Func(_SC("ReadVector2"), &SqBufferView::ReadVector2)
+        .Func(_SC("ReadVector2i"), &SqBufferView::ReadVector2i)
+        .Func(_SC("ReadVector3"), &SqBufferView::ReadVector3)
+        .Func(_SC("ReadVector4"), &SqBufferView::ReadVector4)
+        .SquirrelFunc(_SC("Unpack"), &SqBufferLayout::UnpackView)
     );
 }
 
@@ -5,9 +5,89 @@
 #include "Base/Shared.hpp"
 #include "Base/Buffer.hpp"
 
+// ------------------------------------------------------------------------------------------------
+#include <cstring>
+
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
 
+/* ------------------------------------------------------------------------------------------------
+ * Accumulator for values with an arbitrary number of bits. Bits are stored least significant first.
+*/
+struct BitAcc
+{
+    // --------------------------------------------------------------------------------------------
+    Uint64  mBits; // Bits waiting to be written or read.
+    Uint32  mCount; // The number of bits in the accumulator.
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    BitAcc()
+        : mBits(0), mCount(0)
+    {
+        /* ... */
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Discard the accumulated bits.
+    */
+    void Reset()
+    {
+        mBits = 0;
+        mCount = 0;
+    }
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Map a signed integer to an unsigned one so that small negative values stay small.
+*/
+inline Uint64 ZigZagEncode(Int64 n)
+{
+    return (static_cast< Uint64 >(n) << 1) ^ static_cast< Uint64 >(n >> 63);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Revert the mapping of a signed integer to an unsigned one.
+*/
+inline Int64 ZigZagDecode(Uint64 n)
+{
+    return static_cast< Int64 >(n >> 1) ^ -static_cast< Int64 >(n & 1);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Write an unsigned integer as a variable length (LEB128) sequence of bytes.
+*/
+void EncodeVarUint(Buffer & b, Uint64 n);
+
+/* ------------------------------------------------------------------------------------------------
+ * Read an unsigned integer stored as a variable length (LEB128) sequence of bytes.
+*/
+Uint64 DecodeVarUint(CCStr data, Buffer::SzType size, Buffer::SzType & cur);
+
+/* ------------------------------------------------------------------------------------------------
+ * Map a floating point value within the specified range to an integer with the specified bits.
+*/
+Uint32 Quantize(SQFloat value, SQFloat min, SQFloat max, SQInteger bits);
+
+/* ------------------------------------------------------------------------------------------------
+ * Map an integer with the specified bits back to a floating point value within the specified range.
+*/
+SQFloat Dequantize(Uint32 value, SQFloat min, SQFloat max, SQInteger bits);
+
+/* ------------------------------------------------------------------------------------------------
+ * Write the specified data as a block prefixed by a small header. Data with at least the specified
+ * number of bytes is compressed with LZ4 when that makes it smaller. The header is a byte with the
+ * block type (0 stored, 1 compressed) followed by the original size as a variable length integer
+ * and, for compressed blocks, the size of the compressed data as a variable length integer.
+*/
+void CompressBlock(Buffer & b, CCStr data, Buffer::SzType size, Buffer::SzType threshold = 0);
+
+/* ------------------------------------------------------------------------------------------------
+ * Read a block written by CompressBlock() from the specified memory and append the original data.
+*/
+void DecompressBlock(Buffer & b, CCStr data, Buffer::SzType size, Buffer::SzType & cur);
+
 /* ------------------------------------------------------------------------------------------------
  * Squirrel wrapper for the shared buffer class.
 */
@@ -22,6 +102,10 @@ private:
     // --------------------------------------------------------------------------------------------
     SRef m_Buffer; // The managed memory buffer.
 
+    // --------------------------------------------------------------------------------------------
+    BitAcc m_WrBits; // Bits waiting to be written to the buffer.
+    BitAcc m_RdBits; // Bits read from the buffer but not consumed yet.
+
 public:
 
     // --------------------------------------------------------------------------------------------
@@ -581,6 +665,59 @@ public:
         m_Buffer->Push< Float64 >(ConvTo< Float64 >::From(val));
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Write an unsigned integer as a variable length sequence of bytes.
+    */
+    void WriteVarUint(SQInteger val)
+    {
+        // Validate the managed buffer reference
+        Validate();
+        // Perform the requested operation
+        EncodeVarUint(*m_Buffer, static_cast< Uint64 >(val));
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Write a signed integer as a zigzag encoded variable length sequence of bytes.
+    */
+    void WriteVarInt(SQInteger val)
+    {
+        // Validate the managed buffer reference
+        Validate();
+        // Perform the requested operation
+        EncodeVarUint(*m_Buffer, ZigZagEncode(static_cast< Int64 >(val)));
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Write the specified number of low bits from a value. Call FlushBits() when done.
+    */
+    void WriteBits(SQInteger val, SQInteger bits);
+
+    /* --------------------------------------------------------------------------------------------
+     * Write the bits that don't fill a whole byte, padded with zeros.
+    */
+    void FlushBits();
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of bits waiting to be written to the buffer.
+    */
+    SQInteger GetPendingBits() const
+    {
+        return static_cast< SQInteger >(m_WrBits.mCount);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Write a floating point value within a range using the specified number of bits.
+    */
+    void WriteQuantized(SQFloat val, SQFloat min, SQFloat max, SQInteger bits)
+    {
+        WriteBits(Quantize(val, min, max, bits), bits);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Write a Vector3 whose components are within a range using the specified number of bits each.
+    */
+    void WriteQVector3(const Vector3 & val, SQFloat min, SQFloat max, SQInteger bits);
+
     /* --------------------------------------------------------------------------------------------
      * Write a string to the buffer.
     */
@@ -771,6 +908,45 @@ public:
         return ConvTo< SQFloat >::From(value);
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Read an unsigned integer stored as a variable length sequence of bytes.
+    */
+    SQInteger ReadVarUint();
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a signed integer stored as a zigzag encoded variable length sequence of bytes.
+    */
+    SQInteger ReadVarInt()
+    {
+        return static_cast< SQInteger >(ZigZagDecode(static_cast< Uint64 >(ReadVarUint())));
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a value with the specified number of bits. Call AlignBits() before reading bytes again.
+    */
+    SQInteger ReadBits(SQInteger bits);
+
+    /* --------------------------------------------------------------------------------------------
+     * Discard the bits that remained from the last byte read by ReadBits().
+    */
+    void AlignBits()
+    {
+        m_RdBits.Reset();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a floating point value within a range stored with the specified number of bits.
+    */
+    SQFloat ReadQuantized(SQFloat min, SQFloat max, SQInteger bits)
+    {
+        return Dequantize(static_cast< Uint32 >(ReadBits(bits)), min, max, bits);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a Vector3 whose components are within a range stored with the specified number of bits.
+    */
+    Vector3 ReadQVector3(SQFloat min, SQFloat max, SQInteger bits);
+
     /* --------------------------------------------------------------------------------------------
      * Read a string from the buffer.
     */
@@ -830,6 +1006,402 @@ public:
      * Read a Vector4 from the buffer.
     */
     Vector4 ReadVector4();
+
+    /* --------------------------------------------------------------------------------------------
+     * Compress the data up to the cursor into a new buffer with the cursor after the block.
+    */
+    Object Compress() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Decompress the block at the cursor into a new buffer with the cursor at the beginning.
+    */
+    Object Decompress();
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Read-only view over memory that is owned by someone else. The view does not copy the memory
+ * and is only valid for as long as the owner keeps it attached.
+*/
+class SqBufferView
+{
+    // --------------------------------------------------------------------------------------------
+    friend class SqBufferLayout; // Allow layouts to read directly from the viewed memory.
+
+public:
+
+    // --------------------------------------------------------------------------------------------
+    typedef Buffer::Value   Value; // The type of value used to represent a byte.
+
+    // --------------------------------------------------------------------------------------------
+    typedef const Value *   ConstPtr; // A const pointer to the stored value type.
+
+    // --------------------------------------------------------------------------------------------
+    typedef Buffer::SzType  SzType; // The type used to represent size in general.
+
+private:
+
+    // --------------------------------------------------------------------------------------------
+    ConstPtr    m_Data; // The viewed memory.
+    SzType      m_Size; // The size of the viewed memory.
+    SzType      m_Cur; // The read cursor.
+    BitAcc      m_RdBits; // Bits read from the view but not consumed yet.
+
+    /* --------------------------------------------------------------------------------------------
+     * Validate the viewed memory and make sure the specified amount of bytes can be read.
+    */
+    void Validate(SzType n) const
+    {
+        // Is the view still attached to something?
+        if (!m_Data)
+        {
+            STHROWF("Buffer view is no longer valid. Use Copy() to keep the data");
+        }
+        // Is there enough data left?
+        else if (n > (m_Size - m_Cur))
+        {
+            STHROWF("Unable to read (%u) bytes at (%u) from a view of (%u) bytes", n, m_Cur, m_Size);
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a value of the specified type from the view and advance the cursor.
+    */
+    template < typename T > T Read()
+    {
+        // Make sure the value can be read
+        Validate(sizeof(T));
+        // The data is not guaranteed to be aligned
+        T value;
+        std::memcpy(static_cast< void * >(&value), m_Data + m_Cur, sizeof(T));
+        // Advance the cursor
+        m_Cur += sizeof(T);
+        // Return the value
+        return value;
+    }
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    SqBufferView()
+        : m_Data(nullptr)
+        , m_Size(0)
+        , m_Cur(0)
+    {
+        /* ... */
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor. (disabled)
+    */
+    SqBufferView(const SqBufferView & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move constructor. (disabled)
+    */
+    SqBufferView(SqBufferView && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator. (disabled)
+    */
+    SqBufferView & operator = (const SqBufferView & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move assignment operator. (disabled)
+    */
+    SqBufferView & operator = (SqBufferView && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Start viewing the specified memory.
+    */
+    void Attach(ConstPtr data, SzType size)
+    {
+        m_Data = data;
+        m_Size = data ? size : 0;
+        m_Cur = 0;
+        m_RdBits.Reset();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Stop viewing the memory. Any further access from scripts will throw an error.
+    */
+    void Detach()
+    {
+        m_Data = nullptr;
+        m_Size = 0;
+        m_Cur = 0;
+        m_RdBits.Reset();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the view is attached to any memory.
+    */
+    bool IsAttached() const
+    {
+        return (m_Data != nullptr);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the element at the specified position.
+    */
+    SQInteger Get(SQInteger n) const
+    {
+        // Make sure the view is valid
+        Validate(0);
+        // Is the specified position within range?
+        if (n < 0 || ConvTo< SzType >::From(n) >= m_Size)
+        {
+            STHROWF("Position (%lld) is out of view range (%u)", static_cast< Int64 >(n), m_Size);
+        }
+        // Return the requested element
+        return ConvTo< SQInteger >::From(static_cast< Uint8 >(m_Data[n]));
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the size of the viewed memory.
+    */
+    SzType GetSize() const
+    {
+        return m_Size;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the read cursor position.
+    */
+    SzType GetPosition() const
+    {
+        return m_Cur;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the amount of bytes after the read cursor.
+    */
+    SzType GetRemaining() const
+    {
+        return m_Size - m_Cur;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Reposition the read cursor to a fixed position within the view.
+    */
+    void Move(SQInteger n)
+    {
+        // Make sure the view is valid
+        Validate(0);
+        // Is the specified position within range?
+        if (n < 0 || ConvTo< SzType >::From(n) > m_Size)
+        {
+            STHROWF("Position (%lld) is out of view range (%u)", static_cast< Int64 >(n), m_Size);
+        }
+        // Perform the requested operation
+        m_Cur = ConvTo< SzType >::From(n);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Reposition the read cursor to the specified number of elements ahead.
+    */
+    void Advance(SQInteger n)
+    {
+        Move(static_cast< SQInteger >(m_Cur) + n);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Reposition the read cursor to the specified number of elements behind.
+    */
+    void Retreat(SQInteger n)
+    {
+        Move(static_cast< SQInteger >(m_Cur) - n);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy the viewed memory into a buffer that can be kept after the view is detached.
+    */
+    Object Copy() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Decompress the block at the cursor into a new buffer with the cursor at the beginning.
+    */
+    Object Decompress();
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a signed 8 bit integer from the view.
+    */
+    SQInteger ReadInt8()
+    {
+        return ConvTo< SQInteger >::From(Read< Int8 >());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read an unsigned 8 bit integer from the view.
+    */
+    SQInteger ReadUint8()
+    {
+        return ConvTo< SQInteger >::From(Read< Uint8 >());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a signed 16 bit integer from the view.
+    */
+    SQInteger ReadInt16()
+    {
+        return ConvTo< SQInteger >::From(Read< Int16 >());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read an unsigned 16 bit integer from the view.
+    */
+    SQInteger ReadUint16()
+    {
+        return ConvTo< SQInteger >::From(Read< Uint16 >());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a signed 32 bit integer from the view.
+    */
+    SQInteger ReadInt32()
+    {
+        return ConvTo< SQInteger >::From(Read< Int32 >());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read an unsigned 32 bit integer from the view.
+    */
+    SQInteger ReadUint32()
+    {
+        return ConvTo< SQInteger >::From(Read< Uint32 >());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a signed 64 bit integer from the view.
+    */
+    SLongInt ReadInt64();
+
+    /* --------------------------------------------------------------------------------------------
+     * Read an unsigned 64 bit integer from the view.
+    */
+    ULongInt ReadUint64();
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a 32 bit float from the view.
+    */
+    SQFloat ReadFloat32()
+    {
+        return ConvTo< SQFloat >::From(Read< Float32 >());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a 64 bit float from the view.
+    */
+    SQFloat ReadFloat64()
+    {
+        return ConvTo< SQFloat >::From(Read< Float64 >());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read an unsigned integer stored as a variable length sequence of bytes.
+    */
+    SQInteger ReadVarUint()
+    {
+        // Make sure the view is valid
+        Validate(0);
+        // Perform the requested operation
+        return static_cast< SQInteger >(DecodeVarUint(m_Data, m_Size, m_Cur));
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a signed integer stored as a zigzag encoded variable length sequence of bytes.
+    */
+    SQInteger ReadVarInt()
+    {
+        return static_cast< SQInteger >(ZigZagDecode(static_cast< Uint64 >(ReadVarUint())));
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a value with the specified number of bits. Call AlignBits() before reading bytes again.
+    */
+    SQInteger ReadBits(SQInteger bits);
+
+    /* --------------------------------------------------------------------------------------------
+     * Discard the bits that remained from the last byte read by ReadBits().
+    */
+    void AlignBits()
+    {
+        m_RdBits.Reset();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a floating point value within a range stored with the specified number of bits.
+    */
+    SQFloat ReadQuantized(SQFloat min, SQFloat max, SQInteger bits)
+    {
+        return Dequantize(static_cast< Uint32 >(ReadBits(bits)), min, max, bits);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a Vector3 whose components are within a range stored with the specified number of bits.
+    */
+    Vector3 ReadQVector3(SQFloat min, SQFloat max, SQInteger bits);
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a string from the view.
+    */
+    Object ReadString();
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a raw string from the view.
+    */
+    Object ReadRawString(SQInteger length);
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a AABB from the view.
+    */
+    AABB ReadAABB();
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a Circle from the view.
+    */
+    Circle ReadCircle();
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a Color3 from the view.
+    */
+    Color3 ReadColor3();
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a Color4 from the view.
+    */
+    Color4 ReadColor4();
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a Quaternion from the view.
+    */
+    Quaternion ReadQuaternion();
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a Sphere from the view.
+    */
+    Sphere ReadSphere();
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a Vector2 from the view.
+    */
+    Vector2 ReadVector2();
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a Vector2i from the view.
+    */
+    Vector2i ReadVector2i();
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a Vector3 from the view.
+    */
+    Vector3 ReadVector3();
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a Vector4 from the view.
+    */
+    Vector4 ReadVector4();
 };
 
 } // Namespace:: SqMod
@@ -0,0 +1,609 @@
+// ------------------------------------------------------------------------------------------------
+#include "Library/Utils/Layout.hpp"
+#include "Library/Utils/Buffer.hpp"
+#include "Base/AABB.hpp"
+#include "Base/Circle.hpp"
+#include "Base/Color3.hpp"
+#include "Base/Color4.hpp"
+#include "Base/Quaternion.hpp"
+#include "Base/Sphere.hpp"
+#include "Base/Vector2.hpp"
+#include "Base/Vector2i.hpp"
+#include "Base/Vector3.hpp"
+#include "Base/Vector4.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <cctype>
+#include <limits>
+#include <cstring>
+#include <unordered_map>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+SQMODE_DECL_TYPENAME(Typename, _SC("SqBufferLayout"))
+
+/* ------------------------------------------------------------------------------------------------
+ * Maximum number of layout descriptions kept in the shared cache.
+*/
+#define SQMOD_LAYOUT_CACHE_SIZE 256
+
+/* ------------------------------------------------------------------------------------------------
+ * Names, types and sizes of the supported fields.
+*/
+static const struct
+{
+    CSStr   mName;
+    Uint8   mType;
+    Uint32  mSize;
+} g_FieldTypes[] = {
+    {_SC("i8"),     SqBufferLayout::LFT_I8,         sizeof(Int8)},
+    {_SC("u8"),     SqBufferLayout::LFT_U8,         sizeof(Uint8)},
+    {_SC("i16"),    SqBufferLayout::LFT_I16,        sizeof(Int16)},
+    {_SC("u16"),    SqBufferLayout::LFT_U16,        sizeof(Uint16)},
+    {_SC("i32"),    SqBufferLayout::LFT_I32,        sizeof(Int32)},
+    {_SC("u32"),    SqBufferLayout::LFT_U32,        sizeof(Uint32)},
+    {_SC("i64"),    SqBufferLayout::LFT_I64,        sizeof(Int64)},
+    {_SC("u64"),    SqBufferLayout::LFT_U64,        sizeof(Uint64)},
+    {_SC("f32"),    SqBufferLayout::LFT_F32,        sizeof(Float32)},
+    {_SC("f64"),    SqBufferLayout::LFT_F64,        sizeof(Float64)},
+    {_SC("bool"),   SqBufferLayout::LFT_BOOL,       sizeof(Uint8)},
+    {_SC("str8"),   SqBufferLayout::LFT_STR8,       0},
+    {_SC("str16"),  SqBufferLayout::LFT_STR16,      0},
+    {_SC("str"),    SqBufferLayout::LFT_STR16,      0},
+    {_SC("vu"),     SqBufferLayout::LFT_VARUINT,    0},
+    {_SC("vi"),     SqBufferLayout::LFT_VARINT,     0},
+    {_SC("aabb"),   SqBufferLayout::LFT_AABB,       sizeof(AABB)},
+    {_SC("circle"), SqBufferLayout::LFT_CIRCLE,     sizeof(Circle)},
+    {_SC("c3"),     SqBufferLayout::LFT_COLOR3,     sizeof(Color3)},
+    {_SC("c4"),     SqBufferLayout::LFT_COLOR4,     sizeof(Color4)},
+    {_SC("quat"),   SqBufferLayout::LFT_QUATERNION, sizeof(Quaternion)},
+    {_SC("sphere"), SqBufferLayout::LFT_SPHERE,     sizeof(Sphere)},
+    {_SC("v2"),     SqBufferLayout::LFT_VECTOR2,    sizeof(Vector2)},
+    {_SC("v2i"),    SqBufferLayout::LFT_VECTOR2I,   sizeof(Vector2i)},
+    {_SC("v3"),     SqBufferLayout::LFT_VECTOR3,    sizeof(Vector3)},
+    {_SC("v4"),     SqBufferLayout::LFT_VECTOR4,    sizeof(Vector4)},
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Read a value of the specified type from unaligned memory and advance the cursor.
+*/
+template < typename T > static inline T ReadValue(CCStr data, Buffer::SzType & cur)
+{
+    T value;
+    std::memcpy(static_cast< void * >(&value), data + cur, sizeof(T));
+    cur += sizeof(T);
+    return value;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Read an instance of the specified type from unaligned memory and push it on the stack.
+*/
+template < typename T > static inline void PushValue(HSQUIRRELVM vm, CCStr data, Buffer::SzType & cur)
+{
+    Var< const T & >::push(vm, ReadValue< T >(data, cur));
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Write an instance of the specified type from the stack into the buffer.
+*/
+template < typename T > static inline void PushInstance(HSQUIRRELVM vm, SQInteger idx, Buffer & b)
+{
+    b.Push< T >(Var< const T & >(vm, idx).value);
+}
+
+// ------------------------------------------------------------------------------------------------
+void SqBufferLayout::Compile(CSStr layout)
+{
+    // Is there anything to compile?
+    if (!layout || *layout == '\0')
+    {
+        STHROWF("Invalid or empty buffer layout");
+    }
+    // Remember the original description
+    m_Layout.assign(layout);
+    // The number of fields with a name
+    Uint32 named = 0;
+    // Go through each field in the description
+    for (CSStr itr = layout; *itr != '\0';)
+    {
+        // Skip separators
+        if (std::isspace(*itr) || *itr == ',')
+        {
+            ++itr;
+            continue;
+        }
+        // Find where the field ends and where the name ends, if any
+        CSStr beg = itr, sep = nullptr;
+        for (; *itr != '\0' && *itr != ',' && !std::isspace(*itr); ++itr)
+        {
+            if (*itr == ':' && !sep)
+            {
+                sep = itr;
+            }
+        }
+        // Extract the type of the field
+        const String type(sep ? (sep + 1) : beg, itr);
+        // Look for a matching type
+        Field f{LFT_MAX, 0, String()};
+        for (const auto & ft : g_FieldTypes)
+        {
+            if (type.compare(ft.mName) == 0)
+            {
+                f.mType = ft.mType;
+                f.mSize = ft.mSize;
+                break;
+            }
+        }
+        // Was this type recognized?
+        if (f.mType == LFT_MAX)
+        {
+            STHROWF("Unknown field type (%s) in buffer layout: %s", type.c_str(), layout);
+        }
+        // Does this field have a name?
+        if (sep)
+        {
+            // Make sure the name isn't empty
+            if (sep == beg)
+            {
+                STHROWF("Empty field name in buffer layout: %s", layout);
+            }
+            f.mName.assign(beg, sep);
+            ++named;
+        }
+        // Keep track of the fixed size
+        m_Size += f.mSize;
+        // Store the compiled field
+        m_Fields.push_back(std::move(f));
+    }
+    // Were there any fields at all?
+    if (m_Fields.empty())
+    {
+        STHROWF("Invalid or empty buffer layout");
+    }
+    // Either all fields have a name or none of them
+    else if (named && named != m_Fields.size())
+    {
+        STHROWF("Some fields are missing a name in buffer layout: %s", layout);
+    }
+    // Remember whether results are placed in a table
+    m_Named = (named != 0);
+}
+
+// ------------------------------------------------------------------------------------------------
+bool SqBufferLayout::IsVariable() const
+{
+    for (const auto & f : m_Fields)
+    {
+        if (!f.mSize)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger SqBufferLayout::FieldIndex(CSStr name) const
+{
+    for (Fields::const_iterator itr = m_Fields.cbegin(); itr != m_Fields.cend(); ++itr)
+    {
+        if (itr->mName.compare(name) == 0)
+        {
+            return static_cast< SQInteger >(itr - m_Fields.cbegin());
+        }
+    }
+    return -1;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SqBufferLayout::PackField(HSQUIRRELVM vm, SQInteger idx, const Field & f, Buffer & b) const
+{
+    switch (f.mType)
+    {
+        case LFT_I8:    b.Push< Int8 >(ConvTo< Int8 >::From(PopStackInteger(vm, idx))); break;
+        case LFT_U8:    b.Push< Uint8 >(ConvTo< Uint8 >::From(PopStackInteger(vm, idx))); break;
+        case LFT_I16:   b.Push< Int16 >(ConvTo< Int16 >::From(PopStackInteger(vm, idx))); break;
+        case LFT_U16:   b.Push< Uint16 >(ConvTo< Uint16 >::From(PopStackInteger(vm, idx))); break;
+        case LFT_I32:   b.Push< Int32 >(ConvTo< Int32 >::From(PopStackInteger(vm, idx))); break;
+        case LFT_U32:   b.Push< Uint32 >(ConvTo< Uint32 >::From(PopStackInteger(vm, idx))); break;
+        case LFT_I64:   b.Push< Int64 >(static_cast< Int64 >(PopStackInteger(vm, idx))); break;
+        case LFT_U64:   b.Push< Uint64 >(static_cast< Uint64 >(PopStackInteger(vm, idx))); break;
+        case LFT_F32:   b.Push< Float32 >(ConvTo< Float32 >::From(PopStackFloat(vm, idx))); break;
+        case LFT_F64:   b.Push< Float64 >(ConvTo< Float64 >::From(PopStackFloat(vm, idx))); break;
+        case LFT_BOOL:  b.Push< Uint8 >(PopStackInteger(vm, idx) != 0 ? 1 : 0); break;
+        case LFT_VARUINT: EncodeVarUint(b, static_cast< Uint64 >(PopStackInteger(vm, idx))); break;
+        case LFT_VARINT:  EncodeVarUint(b, ZigZagEncode(static_cast< Int64 >(PopStackInteger(vm, idx)))); break;
+        case LFT_STR8:
+        case LFT_STR16:
+        {
+            // Attempt to retrieve the value as a string
+            StackStrF val(vm, idx);
+            // Have we failed to retrieve the string?
+            if (SQ_FAILED(val.Proc(false)))
+            {
+                STHROWF("Unable to retrieve the string for field (%" PRINT_SZ_FMT ")",
+                        static_cast< size_t >(&f - m_Fields.data()));
+            }
+            const SQInteger max = (f.mType == LFT_STR8) ? 0xFF : 0xFFFF;
+            // Make sure the length can be represented
+            if (val.mLen > max)
+            {
+                STHROWF("String of size (%lld) exceeds the field limit (%lld)",
+                        static_cast< Int64 >(val.mLen), static_cast< Int64 >(max));
+            }
+            // Write the length
+            if (f.mType == LFT_STR8)
+            {
+                b.Push< Uint8 >(static_cast< Uint8 >(val.mLen));
+            }
+            else
+            {
+                const Uint16 length = static_cast< Uint16 >(val.mLen);
+                // Same big endian length as SqBuffer.WriteString()
+                b.Push< Uint16 >(((length >> 8) & 0xFF) | ((length & 0xFF) << 8));
+            }
+            // Write the string contents
+            b.AppendS(val.mPtr, static_cast< SzType >(val.mLen));
+        } break;
+        case LFT_AABB:          PushInstance< AABB >(vm, idx, b); break;
+        case LFT_CIRCLE:        PushInstance< Circle >(vm, idx, b); break;
+        case LFT_COLOR3:        PushInstance< Color3 >(vm, idx, b); break;
+        case LFT_COLOR4:        PushInstance< Color4 >(vm, idx, b); break;
+        case LFT_QUATERNION:    PushInstance< Quaternion >(vm, idx, b); break;
+        case LFT_SPHERE:        PushInstance< Sphere >(vm, idx, b); break;
+        case LFT_VECTOR2:       PushInstance< Vector2 >(vm, idx, b); break;
+        case LFT_VECTOR2I:      PushInstance< Vector2i >(vm, idx, b); break;
+        case LFT_VECTOR3:       PushInstance< Vector3 >(vm, idx, b); break;
+        case LFT_VECTOR4:       PushInstance< Vector4 >(vm, idx, b); break;
+        default: STHROWF("Unknown field type (%u)", f.mType);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SqBufferLayout::UnpackField(HSQUIRRELVM vm, const Field & f, CCStr data, SzType size, SzType & cur) const
+{
+    // Make sure the fixed part of the field is within range
+    if ((f.mSize ? f.mSize : (f.mType == LFT_STR16 ? 2 : 1)) > (size - cur))
+    {
+        STHROWF("Field (%" PRINT_SZ_FMT ") starting at (%u) exceeds the buffer size (%u)",
+                static_cast< size_t >(&f - m_Fields.data()), cur, size);
+    }
+    // Read the value from memory
+    switch (f.mType)
+    {
+        case LFT_I8:    sq_pushinteger(vm, ReadValue< Int8 >(data, cur)); break;
+        case LFT_U8:    sq_pushinteger(vm, ReadValue< Uint8 >(data, cur)); break;
+        case LFT_I16:   sq_pushinteger(vm, ReadValue< Int16 >(data, cur)); break;
+        case LFT_U16:   sq_pushinteger(vm, ReadValue< Uint16 >(data, cur)); break;
+        case LFT_I32:   sq_pushinteger(vm, ReadValue< Int32 >(data, cur)); break;
+        case LFT_U32:   sq_pushinteger(vm, static_cast< SQInteger >(ReadValue< Uint32 >(data, cur))); break;
+        case LFT_I64:   sq_pushinteger(vm, static_cast< SQInteger >(ReadValue< Int64 >(data, cur))); break;
+        case LFT_U64:
+        {
+            const Uint64 value = ReadValue< Uint64 >(data, cur);
+            // Script integers are signed and can't hold the upper half of the range
+            if (value > static_cast< Uint64 >(std::numeric_limits< SQInteger >::max()))
+            {
+                STHROWF("Value of field (%" PRINT_SZ_FMT ") is too large for a script integer",
+                        static_cast< size_t >(&f - m_Fields.data()));
+            }
+            sq_pushinteger(vm, static_cast< SQInteger >(value));
+        } break;
+        case LFT_F32:   sq_pushfloat(vm, static_cast< SQFloat >(ReadValue< Float32 >(data, cur))); break;
+        case LFT_F64:   sq_pushfloat(vm, static_cast< SQFloat >(ReadValue< Float64 >(data, cur))); break;
+        case LFT_BOOL:  sq_pushbool(vm, ReadValue< Uint8 >(data, cur) != 0); break;
+        case LFT_VARUINT: sq_pushinteger(vm, static_cast< SQInteger >(DecodeVarUint(data, size, cur))); break;
+        case LFT_VARINT:  sq_pushinteger(vm, static_cast< SQInteger >(ZigZagDecode(DecodeVarUint(data, size, cur)))); break;
+        case LFT_STR8:
+        case LFT_STR16:
+        {
+            SzType length = 0;
+            // Read the length
+            if (f.mType == LFT_STR8)
+            {
+                length = ReadValue< Uint8 >(data, cur);
+            }
+            else
+            {
+                const Uint16 be = ReadValue< Uint16 >(data, cur);
+                // Convert the length to little endian
+                length = ((be >> 8) & 0xFF) | ((be & 0xFF) << 8);
+            }
+            // Make sure the string is within range
+            if (length > (size - cur))
+            {
+                STHROWF("String of size (%u) starting at (%u) exceeds the buffer size (%u)", length, cur, size);
+            }
+            // Create the string
+            sq_pushstring(vm, data + cur, length);
+            // Advance the cursor after the string
+            cur += length;
+        } break;
+        case LFT_AABB:          PushValue< AABB >(vm, data, cur); break;
+        case LFT_CIRCLE:        PushValue< Circle >(vm, data, cur); break;
+        case LFT_COLOR3:        PushValue< Color3 >(vm, data, cur); break;
+        case LFT_COLOR4:        PushValue< Color4 >(vm, data, cur); break;
+        case LFT_QUATERNION:    PushValue< Quaternion >(vm, data, cur); break;
+        case LFT_SPHERE:        PushValue< Sphere >(vm, data, cur); break;
+        case LFT_VECTOR2:       PushValue< Vector2 >(vm, data, cur); break;
+        case LFT_VECTOR2I:      PushValue< Vector2i >(vm, data, cur); break;
+        case LFT_VECTOR3:       PushValue< Vector3 >(vm, data, cur); break;
+        case LFT_VECTOR4:       PushValue< Vector4 >(vm, data, cur); break;
+        default: STHROWF("Unknown field type (%u)", f.mType);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SqBufferLayout::Pack(HSQUIRRELVM vm, SQInteger idx, Buffer & b) const
+{
+    const SQInteger top = sq_gettop(vm);
+    // Reserve the space needed by the fixed size fields up front
+    if (b.Remaining() < m_Size)
+    {
+        b.Grow(m_Size - b.Remaining());
+    }
+    // Remember where the values begin in case one of them can't be written
+    const SzType pos = b.Position();
+    // Attempt to write the values
+    try
+    {
+        PackFields(vm, idx, top, b);
+    }
+    catch (...)
+    {
+        // Don't leave a partially written record before the cursor
+        b.Move(pos);
+        // Let the caller know why it failed
+        throw;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SqBufferLayout::PackFields(HSQUIRRELVM vm, SQInteger idx, SQInteger top, Buffer & b) const
+{
+    // Were the values of a named layout specified as a table?
+    if (m_Named && top == idx && sq_gettype(vm, idx) == OT_TABLE)
+    {
+        for (const auto & f : m_Fields)
+        {
+            // Look for the value of this field
+            sq_pushstring(vm, f.mName.c_str(), static_cast< SQInteger >(f.mName.size()));
+            // Was there a value for this field?
+            if (SQ_FAILED(sq_get(vm, idx)))
+            {
+                STHROWF("Missing value for field (%s)", f.mName.c_str());
+            }
+            // Write the value
+            PackField(vm, sq_gettop(vm), f, b);
+            // Pop the value from the stack
+            sq_pop(vm, 1);
+        }
+    }
+    // Is there a value for each field?
+    else if (static_cast< size_t >(top - idx + 1) != m_Fields.size())
+    {
+        STHROWF("Buffer layout expects (%" PRINT_SZ_FMT ") values but (%lld) were given",
+                m_Fields.size(), static_cast< Int64 >(top - idx + 1));
+    }
+    else
+    {
+        for (const auto & f : m_Fields)
+        {
+            PackField(vm, idx++, f, b);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SqBufferLayout::Unpack(HSQUIRRELVM vm, CCStr data, SzType size, SzType & cur) const
+{
+    // Create the container for the values
+    if (m_Named)
+    {
+        sq_newtableex(vm, static_cast< SQInteger >(m_Fields.size()));
+    }
+    else
+    {
+        sq_newarray(vm, 0);
+    }
+    // Read each field
+    for (const auto & f : m_Fields)
+    {
+        if (m_Named)
+        {
+            // Push the name of the field
+            sq_pushstring(vm, f.mName.c_str(), static_cast< SQInteger >(f.mName.size()));
+            // Push the value of the field
+            UnpackField(vm, f, data, size, cur);
+            // Insert it into the table
+            sq_newslot(vm, -3, SQFalse);
+        }
+        else
+        {
+            // Push the value of the field
+            UnpackField(vm, f, data, size, cur);
+            // Insert it into the array
+            sq_arrayappend(vm, -2);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+SqBufferLayout::Ptr SqBufferLayout::Acquire(CSStr layout)
+{
+    static std::unordered_map< String, Ptr > cache;
+    // Was this layout compiled before?
+    auto itr = cache.find(layout);
+    // Return it if it was
+    if (itr != cache.end())
+    {
+        return itr->second;
+    }
+    // Compile the layout before the cache is touched
+    Ptr compiled = std::make_shared< const SqBufferLayout >(layout);
+    // Don't let the cache grow forever if layouts are generated dynamically
+    if (cache.size() >= SQMOD_LAYOUT_CACHE_SIZE)
+    {
+        cache.clear(); // Layouts still in use are kept alive by their callers
+    }
+    // Store the compiled layout and return it
+    return cache.emplace(compiled->m_Layout, compiled).first->second;
+}
+
+// ------------------------------------------------------------------------------------------------
+SqBufferLayout::Ptr SqBufferLayout::Acquire(HSQUIRRELVM vm, SQInteger idx)
+{
+    // Is this a description?
+    if (sq_gettype(vm, idx) == OT_STRING)
+    {
+        CSStr layout = nullptr;
+        // Retrieve the description
+        sq_getstring(vm, idx, &layout);
+        // Retrieve the compiled layout
+        return Acquire(layout);
+    }
+    // Is this a layout instance?
+    else if (sq_gettype(vm, idx) == OT_INSTANCE)
+    {
+        // The instance is kept alive by the stack so the pointer doesn't have to own it
+        return Ptr(Ptr(), &Var< const SqBufferLayout & >(vm, idx).value);
+    }
+    // Unable to work with anything else
+    STHROWF("Expected a buffer layout instance or description");
+    // Shouldn't really reach this point
+    return Acquire(_SC("u8"));
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger SqBufferLayout::PackBuffer(HSQUIRRELVM vm)
+{
+    // Was the layout specified?
+    if (sq_gettop(vm) <= 1)
+    {
+        return sq_throwerror(vm, "Missing buffer layout");
+    }
+    // Attempt to pack the values
+    try
+    {
+        SqBuffer * inst = Var< SqBuffer * >(vm, 1).value;
+        // Do we have a valid instance?
+        if (!inst)
+        {
+            return sq_throwerror(vm, "Invalid buffer instance");
+        }
+        // Validate the managed buffer reference
+        inst->Validate();
+        // Remember where the values begin
+        Buffer & b = *(inst->GetRef());
+        const SzType pos = b.Position();
+        // Write the values
+        Acquire(vm, 2)->Pack(vm, 3, b);
+        // Return the number of written bytes
+        sq_pushinteger(vm, static_cast< SQInteger >(b.Position() - pos));
+    }
+    catch (const Sqrat::Exception & e)
+    {
+        return sq_throwerror(vm, e.what());
+    }
+    catch (const std::exception & e)
+    {
+        return sq_throwerror(vm, e.what());
+    }
+    // Specify that we have a value on the stack
+    return 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger SqBufferLayout::UnpackBuffer(HSQUIRRELVM vm)
+{
+    // Was the layout specified?
+    if (sq_gettop(vm) <= 1)
+    {
+        return sq_throwerror(vm, "Missing buffer layout");
+    }
+    // Attempt to unpack the values
+    try
+    {
+        SqBuffer * inst = Var< SqBuffer * >(vm, 1).value;
+        // Do we have a valid instance?
+        if (!inst)
+        {
+            return sq_throwerror(vm, "Invalid buffer instance");
+        }
+        // Validate the managed buffer reference and the buffer itself
+        inst->ValidateDeeper();
+        // Read the values starting at the cursor
+        Buffer & b = *(inst->GetRef());
+        SzType cur = b.Position();
+        Acquire(vm, 2)->Unpack(vm, b.Data(), b.Capacity(), cur);
+        // Move the cursor after the values
+        b.Move(cur);
+    }
+    catch (const Sqrat::Exception & e)
+    {
+        return sq_throwerror(vm, e.what());
+    }
+    catch (const std::exception & e)
+    {
+        return sq_throwerror(vm, e.what());
+    }
+    // Specify that we have a value on the stack
+    return 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger SqBufferLayout::UnpackView(HSQUIRRELVM vm)
+{
+    // Was the layout specified?
+    if (sq_gettop(vm) <= 1)
+    {
+        return sq_throwerror(vm, "Missing buffer layout");
+    }
+    // Attempt to unpack the values
+    try
+    {
+        SqBufferView * inst = Var< SqBufferView * >(vm, 1).value;
+        // Do we have a valid instance?
+        if (!inst)
+        {
+            return sq_throwerror(vm, "Invalid buffer view instance");
+        }
+        // Make sure the view is still attached
+        inst->Validate(0);
+        // Read the values starting at the cursor and move the cursor after them
+        Acquire(vm, 2)->Unpack(vm, inst->m_Data, inst->m_Size, inst->m_Cur);
+    }
+    catch (const Sqrat::Exception & e)
+    {
+        return sq_throwerror(vm, e.what());
+    }
+    catch (const std::exception & e)
+    {
+        return sq_throwerror(vm, e.what());
+    }
+    // Specify that we have a value on the stack
+    return 1;
+}
+
+// ================================================================================================
+void Register_BufferLayout(HSQUIRRELVM vm)
+{
+    RootTable(vm).Bind(Typename::Str,
+        Class< SqBufferLayout >(vm, Typename::Str)
+        // Constructors
+        .Ctor< CSStr >()
+        // Core Meta-methods
+        .SquirrelFunc(_SC("_typename"), &Typename::Fn)
+        .Func(_SC("_tostring"), &SqBufferLayout::ToString)
+        // Properties
+        .Prop(_SC("Layout"), &SqBufferLayout::GetLayout)
+        .Prop(_SC("Count"), &SqBufferLayout::GetCount)
+        .Prop(_SC("Size"), &SqBufferLayout::GetSize)
+        .Prop(_SC("Variable"), &SqBufferLayout::IsVariable)
+        .Prop(_SC("Named"), &SqBufferLayout::IsNamed)
+    );
+}
+
+} // Namespace:: SqMod
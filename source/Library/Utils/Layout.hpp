@@ -0,0 +1,249 @@
+#ifndef _LIBRARY_UTILS_LAYOUT_HPP_
+#define _LIBRARY_UTILS_LAYOUT_HPP_
+
+// ------------------------------------------------------------------------------------------------
+#include "Base/Shared.hpp"
+#include "Base/Buffer.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <memory>
+#include <vector>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Binary layout compiled from a textual description which can pack and unpack several values
+ * to and from a buffer in a single call. The description is a list of fields separated by spaces
+ * or commas where each field is a type optionally prefixed by a name. (ex: "id:u8 pos:v3 str16")
+*/
+class SqBufferLayout
+{
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Supported field types.
+    */
+    enum FieldType
+    {
+        LFT_I8 = 0,
+        LFT_U8,
+        LFT_I16,
+        LFT_U16,
+        LFT_I32,
+        LFT_U32,
+        LFT_I64,
+        LFT_U64,
+        LFT_F32,
+        LFT_F64,
+        LFT_BOOL,
+        LFT_STR8,
+        LFT_STR16,
+        LFT_VARUINT,
+        LFT_VARINT,
+        LFT_AABB,
+        LFT_CIRCLE,
+        LFT_COLOR3,
+        LFT_COLOR4,
+        LFT_QUATERNION,
+        LFT_SPHERE,
+        LFT_VECTOR2,
+        LFT_VECTOR2I,
+        LFT_VECTOR3,
+        LFT_VECTOR4,
+        LFT_MAX
+    };
+
+    // --------------------------------------------------------------------------------------------
+    typedef Buffer::SzType  SzType; // The type used to represent size in general.
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::shared_ptr< const SqBufferLayout > Ptr; // Shared reference to a compiled layout.
+
+private:
+
+    /* --------------------------------------------------------------------------------------------
+     * A single compiled field.
+    */
+    struct Field
+    {
+        Uint8       mType; // The type of value stored in this field.
+        SzType      mSize; // The number of bytes occupied by the field. (0 if variable)
+        String      mName; // The name of the field, if any.
+    };
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::vector< Field > Fields; // List of compiled fields.
+
+    // --------------------------------------------------------------------------------------------
+    Fields      m_Fields; // The compiled fields.
+    String      m_Layout; // The original description of the layout.
+    SzType      m_Size; // The number of bytes occupied by the fixed size fields.
+    bool        m_Named; // Whether the fields have names.
+
+    /* --------------------------------------------------------------------------------------------
+     * Compile the specified layout description.
+    */
+    void Compile(CSStr layout);
+
+    /* --------------------------------------------------------------------------------------------
+     * Write the value at the specified stack index to the buffer.
+    */
+    void PackField(HSQUIRRELVM vm, SQInteger idx, const Field & f, Buffer & b) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Write the values starting at the specified stack index to the buffer without rolling back.
+    */
+    void PackFields(HSQUIRRELVM vm, SQInteger idx, SQInteger top, Buffer & b) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Read a value from the specified memory and push it on the stack.
+    */
+    void UnpackField(HSQUIRRELVM vm, const Field & f, CCStr data, SzType size, SzType & cur) const;
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve a compiled layout from the shared cache, compiling it if necessary. The layout
+     * remains valid even if the cache is cleared while it's being used.
+    */
+    static Ptr Acquire(CSStr layout);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the layout at the specified stack index, either as an instance or a description.
+    */
+    static Ptr Acquire(HSQUIRRELVM vm, SQInteger idx);
+
+    /* --------------------------------------------------------------------------------------------
+     * Script function which packs the given values into a SqBuffer instance.
+    */
+    static SQInteger PackBuffer(HSQUIRRELVM vm);
+
+    /* --------------------------------------------------------------------------------------------
+     * Script function which unpacks values from a SqBuffer instance.
+    */
+    static SQInteger UnpackBuffer(HSQUIRRELVM vm);
+
+    /* --------------------------------------------------------------------------------------------
+     * Script function which unpacks values from a SqBufferView instance.
+    */
+    static SQInteger UnpackView(HSQUIRRELVM vm);
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor.
+    */
+    explicit SqBufferLayout(CSStr layout)
+        : m_Fields()
+        , m_Layout()
+        , m_Size(0)
+        , m_Named(false)
+    {
+        Compile(layout);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor.
+    */
+    SqBufferLayout(const SqBufferLayout & o) = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move constructor.
+    */
+    SqBufferLayout(SqBufferLayout && o) = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Destructor.
+    */
+    ~SqBufferLayout() = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator.
+    */
+    SqBufferLayout & operator = (const SqBufferLayout & o) = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move assignment operator.
+    */
+    SqBufferLayout & operator = (SqBufferLayout && o) = default;
+
+    /* --------------------------------------------------------------------------------------------
+     * Used by the script engine to convert an instance of this type to a string.
+    */
+    const String & ToString() const
+    {
+        return m_Layout;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the original description of the layout.
+    */
+    const String & GetLayout() const
+    {
+        return m_Layout;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of fields in the layout.
+    */
+    SQInteger GetCount() const
+    {
+        return ConvTo< SQInteger >::From(m_Fields.size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of bytes occupied by the fixed size fields.
+    */
+    SQInteger GetSize() const
+    {
+        return ConvTo< SQInteger >::From(m_Size);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the layout contains fields with a variable size.
+    */
+    bool IsVariable() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the fields have names and are unpacked into a table.
+    */
+    bool IsNamed() const
+    {
+        return m_Named;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the index of the field with the specified name or -1 if there's no such field.
+    */
+    SQInteger FieldIndex(CSStr name) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Write the value at the specified stack index to the buffer as the specified field.
+    */
+    void PackAt(HSQUIRRELVM vm, SQInteger idx, SzType field, Buffer & b) const
+    {
+        PackField(vm, idx, m_Fields.at(field), b);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Read the specified field from the specified memory and push it on the stack.
+    */
+    void UnpackAt(HSQUIRRELVM vm, SzType field, CCStr data, SzType size, SzType & cur) const
+    {
+        UnpackField(vm, m_Fields.at(field), data, size, cur);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Write the values starting at the specified stack index to the buffer. The cursor is moved
+     * back where it was if any of the values can't be written.
+    */
+    void Pack(HSQUIRRELVM vm, SQInteger idx, Buffer & b) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Read the values from the specified memory and push them on the stack as an array or table.
+    */
+    void Unpack(HSQUIRRELVM vm, CCStr data, SzType size, SzType & cur) const;
+};
+
+} // Namespace:: SqMod
+
+#endif // _LIBRARY_UTILS_LAYOUT_HPP_
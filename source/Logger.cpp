@@ -6,6 +6,7 @@
 // ------------------------------------------------------------------------------------------------
 #include <ctime>
 #include <cerrno>
+#include <chrono>
 #include <cstring>
 #include <cstdarg>
 
@@ -193,18 +194,99 @@ static inline void OutputConsoleMessage(Uint8 level, bool sub, CCStr tms, CCStr
 #endif // SQMOD_OS_WINDOWS
 }
 
+/* ------------------------------------------------------------------------------------------------
+ * Convert a time value to local time in a thread safe manner.
+*/
+static inline void GetLocalTime(std::time_t t, std::tm & tm)
+{
+#ifdef SQMOD_OS_WINDOWS
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif // SQMOD_OS_WINDOWS
+}
+
 /* ------------------------------------------------------------------------------------------------
  * Identify the associated message color.
 */
 static inline CCStr GetTimeStampStr()
 {
     static CharT tmbuff[80];
-    std::time_t t = std::time(nullptr);
-    std::strftime(tmbuff, sizeof(tmbuff), "%Y-%m-%d %H:%M:%S", std::localtime(&t));
+    std::tm tm;
+    GetLocalTime(std::time(nullptr), tm);
+    std::strftime(tmbuff, sizeof(tmbuff), "%Y-%m-%d %H:%M:%S", &tm);
     // Return the resulted buffer
     return tmbuff;
 }
 
+/* ------------------------------------------------------------------------------------------------
+ * Generate a file name from a pattern which may contain time-stamp format specifiers.
+*/
+static bool GenerateFilename(const std::string & pattern, std::time_t t, std::string & out)
+{
+    CharT buffer[1024];
+    std::tm tm;
+    GetLocalTime(t, tm);
+    // Generate the filename using the specified time-stamp
+    if (std::strftime(buffer, sizeof(buffer), pattern.c_str(), &tm) > 0)
+    {
+        out.assign(buffer);
+        return true;
+    }
+    return false;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * See if a file with the specified name exists.
+*/
+static bool FileExists(const std::string & filename)
+{
+    std::FILE * fp = std::fopen(filename.c_str(), "r");
+    // Could the file be opened?
+    if (fp)
+    {
+        std::fclose(fp);
+        return true;
+    }
+    return false;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Append a string to a JSON document while escaping the necessary characters.
+*/
+static void AppendJSONString(std::string & out, CCStr str)
+{
+    out.push_back('"');
+    // Process each character in the string
+    for (; *str != '\0'; ++str)
+    {
+        const unsigned char c = static_cast< unsigned char >(*str);
+        switch (c)
+        {
+            case '"':   out.append("\\\""); break;
+            case '\\':  out.append("\\\\"); break;
+            case '\n':  out.append("\\n"); break;
+            case '\r':  out.append("\\r"); break;
+            case '\t':  out.append("\\t"); break;
+            default:
+            {
+                // Is this a control character?
+                if (c < 0x20)
+                {
+                    CharT esc[8];
+                    std::snprintf(esc, sizeof(esc), "\\u%04x", c);
+                    out.append(esc);
+                }
+                else
+                {
+                    out.push_back(static_cast< char >(c));
+                }
+            }
+        }
+    }
+    out.push_back('"');
+}
+
 // ------------------------------------------------------------------------------------------------
 Logger Logger::s_Inst;
 
@@ -219,6 +301,36 @@ Logger::Logger()
     , m_StringTruncate(32)
     , m_File(nullptr)
     , m_Filename()
+    , m_FilePattern()
+    , m_LogFileFormat(LOGF_TEXT)
+    , m_RotateSize(0)
+    , m_RotateInterval(0)
+    , m_FileSize(0)
+    , m_FileTime(0)
+    , m_Pending()
+    , m_Writer()
+    , m_Mutex()
+    , m_Condition()
+    , m_Flushed()
+    , m_Taken(0)
+    , m_Written(0)
+    , m_Writing(false)
+    , m_RotateNow(false)
+    , m_Traceback()
+    , m_Record()
+    , m_Folding(false)
+    , m_Repeats()
+    , m_RepeatWindow(0)
+    , m_TracebackLimit(0)
+    , m_TracebackCount(0)
+    , m_TracebackSkipped(0)
+    , m_TracebackTime(0)
+    , m_SuppressTime(0)
+    , m_Ring()
+    , m_RingPos(0)
+    , m_RingFull(false)
+    , m_RingLevels(LOGL_ANY)
+    , m_RingDumpFile()
     , m_LogCb{}
 {
     /* ... */
@@ -233,6 +345,19 @@ Logger::~Logger()
 // ------------------------------------------------------------------------------------------------
 void Logger::Close()
 {
+    // Is there a writer thread to stop?
+    if (m_Writer.joinable())
+    {
+        {
+            std::lock_guard< std::mutex > lg(m_Mutex);
+            // Tell the writer thread to stop after writing the pending records
+            m_Writing = false;
+        }
+        // Wake up the writer thread
+        m_Condition.notify_one();
+        // Wait for the writer thread to finish
+        m_Writer.join();
+    }
     // Is there a file handle to close?
     if (m_File)
     {
@@ -250,32 +375,161 @@ void Logger::SetLogFilename(CCStr filename)
 {
     // Close the current logging file, if any
     Close();
-    // Clear the current name
+    // Clear the current name and pattern
     m_Filename.clear();
+    m_FilePattern.clear();
     // Was there a name specified?
     if (!filename || *filename == '\0')
     {
         return; // We're done here!
     }
-    // Make sure the internal buffer has some memory
-    m_Buffer.Adjust(1024);
-    // Obtain the current time for generating the filename
-    const std::time_t t = std::time(nullptr);
+    // Remember the pattern for when the file is rotated
+    m_FilePattern.assign(filename);
     // Generate the filename using the current time-stamp
-    if (std::strftime(m_Buffer.Data(), m_Buffer.Size(), filename, std::localtime(&t)) > 0)
+    if (!GenerateFilename(m_FilePattern, std::time(nullptr), m_Filename))
     {
-        m_Filename.assign(m_Buffer.Data());
+        return; // We're done here!
     }
-    else
+    // Attempt to open the file for writing
+    if (OpenFile(m_Filename))
     {
-        return; // We're done here!
+        m_Writing = true;
+        // Leave the writing and rotation to a separate thread
+        m_Writer = std::thread(&Logger::WriterLoop, this);
     }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Logger::OpenFile(const std::string & filename)
+{
     // Attempt to open the file for writing
-    m_File = std::fopen(m_Filename.c_str(), "w");
+    m_File = std::fopen(filename.c_str(), "w");
     // See if the file could be opened
     if (!m_File)
     {
-        OutputError("Unable to open the log file (%s) : %s", m_Filename.c_str(), std::strerror(errno));
+        OutputError("Unable to open the log file (%s) : %s", filename.c_str(), std::strerror(errno));
+        // Nothing else to do
+        return false;
+    }
+    // Reset the rotation counters
+    m_FileSize = 0;
+    m_FileTime = std::time(nullptr);
+    // File was opened
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::Rotate()
+{
+    {
+        std::lock_guard< std::mutex > lg(m_Mutex);
+        // Let the writer thread know it should rotate the file
+        m_RotateNow = true;
+    }
+    // Wake up the writer thread
+    m_Condition.notify_one();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::RotateFile(std::time_t now)
+{
+    std::string filename;
+    // Generate the name of the next file from the original pattern
+    if (!GenerateFilename(m_FilePattern, now, filename))
+    {
+        filename = m_Filename;
+    }
+    // Close the current file, if any
+    if (m_File)
+    {
+        std::fclose(m_File);
+        m_File = nullptr;
+    }
+    // Would the new file overwrite the current one?
+    if (filename == m_Filename)
+    {
+        CharT suffix[32];
+        std::tm tm;
+        GetLocalTime(now, tm);
+        std::strftime(suffix, sizeof(suffix), ".%Y%m%d-%H%M%S", &tm);
+        // Archive the current file under a time-stamped name
+        std::string archive(m_Filename);
+        archive.append(suffix);
+        // Don't overwrite files archived within the same second
+        for (Uint32 n = 1; FileExists(archive) && n < 1000; ++n)
+        {
+            archive.assign(m_Filename).append(suffix).append(ToStrF(".%u", n));
+        }
+        // Attempt to archive the current file
+        if (std::rename(m_Filename.c_str(), archive.c_str()) != 0)
+        {
+            OutputError("Unable to archive the log file (%s) : %s", m_Filename.c_str(), std::strerror(errno));
+        }
+    }
+    // Open the new file
+    OpenFile(filename);
+    // The main thread may be reading the file name
+    std::lock_guard< std::mutex > lg(m_Mutex);
+    // Remember the name of the new file
+    m_Filename.swap(filename);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::WriterLoop()
+{
+    std::string records;
+    // Acquire ownership of the shared state
+    std::unique_lock< std::mutex > lock(m_Mutex);
+    // Keep writing until told otherwise
+    for (;;)
+    {
+        // Wait for records or requests but wake up periodically to check the rotation time
+        m_Condition.wait_for(lock, std::chrono::seconds(1), [this]() {
+            return !m_Writing || m_RotateNow || !m_Pending.empty();
+        });
+        // Take ownership of the pending records
+        records.swap(m_Pending);
+        // Remember which batch is being written
+        const Uint32 batch = records.empty() ? m_Taken : ++m_Taken;
+        // Grab the state that is shared with the main thread
+        const bool running = m_Writing;
+        const Uint32 rotate_size = m_RotateSize;
+        const Uint32 rotate_interval = m_RotateInterval;
+        bool rotate = m_RotateNow;
+        m_RotateNow = false;
+        // Allow the main thread to queue more records while writing
+        lock.unlock();
+        // Is there anything to write?
+        if (!records.empty() && m_File)
+        {
+            std::fwrite(records.data(), 1, records.size(), m_File);
+            std::fflush(m_File);
+            // Keep track of the file size
+            m_FileSize += static_cast< Uint64 >(records.size());
+        }
+        // Keep the allocated memory for the next batch
+        records.clear();
+        // Obtain the current time
+        const std::time_t now = std::time(nullptr);
+        // See if the file should be rotated
+        if (running && (rotate || (rotate_size && m_FileSize >= rotate_size) ||
+                        (rotate_interval && (now - m_FileTime) >= static_cast< std::time_t >(rotate_interval))))
+        {
+            RotateFile(now);
+        }
+        // Re-acquire ownership of the shared state
+        lock.lock();
+        // Let anyone waiting for this batch know that it was written
+        if (m_Written != batch)
+        {
+            m_Written = batch;
+            m_Flushed.notify_all();
+        }
+        // Should we stop?
+        if (!running)
+        {
+            break;
+        }
     }
 }
 
@@ -379,6 +633,21 @@ SQBool Logger::ProcessCb(Uint8 level, bool sub)
 // ------------------------------------------------------------------------------------------------
 void Logger::Proccess(Uint8 level, bool sub)
 {
+    // Should the message be recorded in the in-memory ring?
+    if (GetActiveRingLevels() & level)
+    {
+        RecordRing(level, sub);
+        // Preserve the recent history if this is a fatal error
+        if (level == LOGL_FTL && !m_RingDumpFile.empty())
+        {
+            DumpRing(m_RingDumpFile.c_str());
+        }
+    }
+    // Is this level allowed anywhere other than the ring?
+    if (!((m_ConsoleLevels | m_LogFileLevels) & level))
+    {
+        return;
+    }
     // Is there a cyclic lock on the logger?
     if (!m_CyclicLock)
     {
@@ -402,21 +671,217 @@ void Logger::Proccess(Uint8 level, bool sub)
         OutputConsoleMessage(level, sub, (m_ConsoleTime ? tms : nullptr), m_Buffer.Get());
     }
     // Are we allowed to write it to a file?
-    if (m_File && (m_LogFileLevels & level))
+    if (m_Writing && (m_LogFileLevels & level))
+    {
+        Enqueue(level, sub, (m_LogFileTime ? tms : nullptr));
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::RecordRing(Uint8 level, bool sub)
+{
+    CharT head[64];
+    // Generate the header of the record
+    const int len = std::snprintf(head, sizeof(head), "%s %s %s", GetLevelTag(level), GetTimeStampStr(), sub ? "  " : "");
+    // Write the header, the message and the record terminator
+    AppendRing(head, len > 0 ? ConvTo< Uint32 >::From(len) : 0);
+    AppendRing(m_Buffer.Get(), ConvTo< Uint32 >::From(std::strlen(m_Buffer.Get())));
+    AppendRing("\n", 1);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::AppendRing(CCStr data, Uint32 size)
+{
+    const Uint32 cap = static_cast< Uint32 >(m_Ring.size());
+    // Does the data overwrite the whole ring?
+    if (size >= cap)
+    {
+        std::memcpy(m_Ring.data(), data + (size - cap), cap);
+        // The ring is full and starts at the beginning
+        m_RingPos = 0;
+        m_RingFull = true;
+        return;
+    }
+    // Space left until the end of the ring
+    const Uint32 room = cap - m_RingPos;
+    // Does the data fit without wrapping around?
+    if (size < room)
+    {
+        std::memcpy(m_Ring.data() + m_RingPos, data, size);
+        m_RingPos += size;
+    }
+    else
+    {
+        std::memcpy(m_Ring.data() + m_RingPos, data, room);
+        std::memcpy(m_Ring.data(), data + room, size - room);
+        m_RingPos = size - room;
+        m_RingFull = true;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::SetRingSize(Uint32 size)
+{
+    // Discard the recorded messages and the previously allocated memory
+    std::vector< char >(size).swap(m_Ring);
+    // Start from the beginning
+    ClearRing();
+}
+
+// ------------------------------------------------------------------------------------------------
+std::string Logger::GetRing() const
+{
+    // Has the ring wrapped around?
+    if (!m_RingFull)
+    {
+        return std::string(m_Ring.data(), m_RingPos);
+    }
+    std::string str;
+    str.reserve(m_Ring.size());
+    // The oldest data starts right after the last write position
+    str.append(m_Ring.data() + m_RingPos, m_Ring.size() - m_RingPos);
+    str.append(m_Ring.data(), m_RingPos);
+    // The oldest record was most likely partially overwritten
+    const std::string::size_type pos = str.find('\n');
+    // Discard whatever remained of it
+    if (pos != std::string::npos)
+    {
+        str.erase(0, pos + 1);
+    }
+    // Return the ordered records
+    return str;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Logger::DumpRing(CCStr filename) const
+{
+    const std::string str(GetRing());
+    // Should the ring be dumped to the console?
+    if (!filename || *filename == '\0')
+    {
+        std::fwrite(str.data(), 1, str.size(), stdout);
+        std::fflush(stdout);
+        return true;
+    }
+    // Attempt to open the specified file
+    std::FILE * fp = std::fopen(filename, "w");
+    // Were we able to open the file?
+    if (!fp)
+    {
+        return false;
+    }
+    // Write the contents of the ring
+    const bool ok = (std::fwrite(str.data(), 1, str.size(), fp) == str.size());
+    // Close the file and report whether everything was written
+    return (std::fclose(fp) == 0) && ok;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::Enqueue(Uint8 level, bool sub, CCStr tms)
+{
+    // Messages logged by script callbacks are never part of the structured error record
+    const bool fold = (m_Folding && !m_CyclicLock);
+    // Is this a traceback block that belongs to the structured error record?
+    if (fold && level != LOGL_ERR)
+    {
+        return; // The debug function folds it into the record
+    }
+    std::unique_lock< std::mutex > lock(m_Mutex);
+    // Does the writer thread need to be woken up?
+    const bool wake = m_Pending.empty();
+    // Should the record be structured?
+    if (m_LogFileFormat == LOGF_JSON)
+    {
+        // The error record is held back until the blocks of its traceback are generated
+        std::string & out = fold ? m_Record : m_Pending;
+        // Begin the record with the time and level
+        out.append(ToStrF("{\"time\":%lld,\"date\":\"%s\",\"level\":\"%.3s\",\"sub\":%s,\"message\":",
+                                static_cast< long long >(std::time(nullptr)), GetTimeStampStr(),
+                                GetLevelTag(level) + 1, sub ? "true" : "false"));
+        // Write the message
+        AppendJSONString(out, m_Buffer.Get());
+        // Obtain the script location, if any
+        HSQUIRRELVM vm = DefaultVM::Get_();
+        SQStackInfos si;
+        // Skip native functions until a script function is found
+        for (SQInteger lvl = 0; vm && lvl < 3 && SQ_SUCCEEDED(sq_stackinfos(vm, lvl, &si)); ++lvl)
+        {
+            if (si.source && si.line > 0)
+            {
+                out.append(",\"source\":");
+                AppendJSONString(out, si.source);
+                out.append(ToStrF(",\"line\":%d,\"function\":", static_cast< int >(si.line)));
+                AppendJSONString(out, si.funcname ? si.funcname : _SC("unknown"));
+                break;
+            }
+        }
+        // Include the traceback, if any
+        if (!m_Traceback.empty())
+        {
+            out.append(",\"traceback\":").append(m_Traceback);
+            m_Traceback.clear();
+        }
+        // Is the record complete?
+        if (fold)
+        {
+            return;
+        }
+        // Terminate the record
+        m_Pending.append("}\n");
+    }
+    else
     {
         // Write the level tag
-        std::fputs(GetLevelTag(level), m_File);
-        std::fputc(' ', m_File);
+        m_Pending.append(GetLevelTag(level)).push_back(' ');
         // Should we include the time-stamp?
-        if (m_LogFileTime && tms)
+        if (tms)
         {
-            std::fputs(tms, m_File);
-            std::fputc(' ', m_File);
+            m_Pending.append(tms).push_back(' ');
         }
-        // Write the message
-        std::fputs(m_Buffer.Get(), m_File);
-        // Append a new line
-        std::fputc('\n', m_File);
+        // Write the message and append a new line
+        m_Pending.append(m_Buffer.Get()).push_back('\n');
+    }
+    // A fatal error is usually followed by a crash, so wait until the record reaches the file
+    if (level == LOGL_FTL)
+    {
+        // The record is part of the next batch taken by the writer thread
+        const Uint32 batch = m_Taken + 1;
+        m_Condition.notify_one();
+        m_Flushed.wait(lock, [this, batch]() {
+            return !m_Writing || static_cast< Int32 >(m_Written - batch) >= 0;
+        });
+        return;
+    }
+    // Release the lock before notifying the writer thread
+    lock.unlock();
+    // Should the writer thread be woken up?
+    if (wake)
+    {
+        m_Condition.notify_one();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::FlushRecord()
+{
+    m_Folding = false;
+    // Was the error record consumed by a callback?
+    if (m_Record.empty())
+    {
+        return;
+    }
+    std::unique_lock< std::mutex > lock(m_Mutex);
+    // Does the writer thread need to be woken up?
+    const bool wake = m_Pending.empty();
+    // Terminate the record and move it with the others
+    m_Pending.append(m_Record).append("}\n");
+    m_Record.clear();
+    // Release the lock before notifying the writer thread
+    lock.unlock();
+    // Should the writer thread be woken up?
+    if (wake)
+    {
+        m_Condition.notify_one();
     }
 }
 
@@ -424,7 +889,7 @@ void Logger::Proccess(Uint8 level, bool sub)
 void Logger::Send(Uint8 level, bool sub, CCStr fmt, va_list args)
 {
     // Is this level even allowed?
-    if ((m_ConsoleLevels & level) || (m_LogFileLevels & level))
+    if (IsEnabled(level))
     {
         // Generate the message in the buffer
         m_Buffer.WriteF(0, fmt, args);
@@ -436,7 +901,8 @@ void Logger::Send(Uint8 level, bool sub, CCStr fmt, va_list args)
 // ------------------------------------------------------------------------------------------------
 void Logger::Write(Uint8 level, bool sub, CCStr fmt, ...)
 {
-    if ((m_ConsoleLevels & level) || (m_LogFileLevels & level))
+    // Is this level even allowed?
+    if (IsEnabled(level))
     {
         // Initialize the variable argument list
         va_list args;
@@ -469,10 +935,48 @@ void Logger::Debug(CCStr fmt, va_list args)
     HSQUIRRELVM vm = DefaultVM::Get();
     // Used to acquire
     SQStackInfos si;
+    // Are traceback dumps limited?
+    if (m_TracebackLimit)
+    {
+        const std::time_t now = std::time(nullptr);
+        // Did we move to another second? Report the skipped dumps before the message is formatted,
+        // since the report uses the same buffer and can't be folded into the error record
+        if (now != m_TracebackTime)
+        {
+            ReportSkippedTracebacks();
+            // Start counting again
+            m_TracebackTime = now;
+            m_TracebackCount = 0;
+        }
+    }
     // Write the message to the buffer
     Int32 ret = m_Buffer.WriteF(0, fmt, args);
     // Obtain information about the current stack level
-    if (SQ_SUCCEEDED(sq_stackinfos(vm, 1, &si)))
+    const bool located = SQ_SUCCEEDED(sq_stackinfos(vm, 1, &si));
+    // Was this error reported recently from the same location?
+    if (m_RepeatWindow && SuppressRepeat(located ? si.source : nullptr, located ? si.line : 0, ret))
+    {
+        return;
+    }
+    // Should the traceback be included in the structured log record?
+    m_Folding = (m_Writing && m_LogFileFormat == LOGF_JSON && (m_LogFileLevels & LOGL_ERR));
+    // Generate the traceback of the structured log record
+    if (m_Folding)
+    {
+        m_Traceback.assign("[");
+        // Traceback the function call
+        for (Int32 level = 1; SQ_SUCCEEDED(sq_stackinfos(vm, level, &si)); ++level)
+        {
+            m_Traceback.append(level > 1 ? ",{\"source\":" : "{\"source\":");
+            AppendJSONString(m_Traceback, si.source ? si.source : _SC("unknown"));
+            m_Traceback.append(ToStrF(",\"line\":%d,\"function\":", static_cast< int >(si.line)));
+            AppendJSONString(m_Traceback, si.funcname ? si.funcname : _SC("unknown"));
+            m_Traceback.push_back('}');
+        }
+        m_Traceback.push_back(']');
+    }
+    // Obtain information about the current stack level
+    if (located && SQ_SUCCEEDED(sq_stackinfos(vm, 1, &si)))
     {
         // Whether we should fall back to normal message
         bool fall_back = true;
@@ -503,6 +1007,16 @@ void Logger::Debug(CCStr fmt, va_list args)
     }
     // Process the message in the buffer
     Proccess(LOGL_ERR, true);
+    // The traceback is not used if the record was consumed by a callback
+    m_Traceback.clear();
+    // Did we exceed the limit of traceback dumps for this second?
+    if (m_TracebackLimit && ++m_TracebackCount > m_TracebackLimit)
+    {
+        ++m_TracebackSkipped;
+        // Only the error message is shown
+        FlushRecord();
+        return;
+    }
     // Begin the traceback process
     ret = m_Buffer.WriteF(0, "Traceback:\n[\n");
     // Traceback the function call
@@ -655,6 +1169,126 @@ void Logger::Debug(CCStr fmt, va_list args)
     m_Buffer.WriteF(ret, "]");
     // Process the message in the buffer
     Proccess(LOGL_INF, true);
+    // The structured record carries the locals as a single field
+    if (m_Folding && !m_Record.empty())
+    {
+        m_Record.append(",\"locals\":");
+        AppendJSONString(m_Record, m_Buffer.Get());
+    }
+    // The structured error record is complete
+    FlushRecord();
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Logger::SuppressRepeat(CSStr source, SQInteger line, Int32 length)
+{
+    // Generate the key from the location and message
+    std::string key(ToStrF("%s:%d: ", source ? source : _SC("unknown"), static_cast< int >(line)));
+    key.append(m_Buffer.Data(), static_cast< size_t >(length));
+    // Obtain the current time
+    const std::time_t now = std::time(nullptr);
+    // Was this error reported before?
+    Repeats::iterator itr = m_Repeats.find(key);
+    // Is this the first time?
+    if (itr == m_Repeats.end())
+    {
+        // Don't let the tracked errors grow indefinitely
+        if (m_Repeats.size() >= 1024)
+        {
+            ProcessSuppressed();
+            // Are all of them still within their repeat window?
+            if (m_Repeats.size() >= 1024)
+            {
+                return false; // Report it without tracking it
+            }
+        }
+        // Start tracking this error
+        m_Repeats.emplace(std::move(key), Repeat{now, 0});
+        // Allow it to be reported
+        return false;
+    }
+    // Are we still within the repeat window?
+    else if ((now - itr->second.mTime) < static_cast< std::time_t >(m_RepeatWindow))
+    {
+        ++(itr->second.mCount);
+        // Suppress this error
+        return true;
+    }
+    // Were there any repetitions suppressed in the previous window?
+    else if (itr->second.mCount)
+    {
+        Write(LOGL_WRN, false, "Suppressed %u repetitions of error: %s", itr->second.mCount, itr->first.c_str());
+        // Restore the message that was overwritten by the summary
+        m_Buffer.WriteF(0, "%s", itr->first.c_str() + (itr->first.size() - static_cast< size_t >(length)));
+    }
+    // Start a new window
+    itr->second.mTime = now;
+    itr->second.mCount = 0;
+    // Allow it to be reported
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::SetRepeatWindow(Uint32 seconds)
+{
+    m_RepeatWindow = seconds;
+    // Report whatever was suppressed until now
+    if (!seconds)
+    {
+        m_SuppressTime = 0;
+        ProcessSuppressed();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::ReportSkippedTracebacks()
+{
+    // Were there any traceback dumps skipped?
+    if (m_TracebackSkipped)
+    {
+        Write(LOGL_WRN, false, "Skipped %u traceback dumps (limit of %u per second)", m_TracebackSkipped, m_TracebackLimit);
+        // Start counting again
+        m_TracebackSkipped = 0;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::ProcessSuppressed()
+{
+    // Is there anything to report?
+    if (m_Repeats.empty() && !m_TracebackSkipped)
+    {
+        return;
+    }
+    const std::time_t now = std::time(nullptr);
+    // Don't bother more than once a second
+    if (now == m_SuppressTime)
+    {
+        return;
+    }
+    m_SuppressTime = now;
+    // Report skipped traceback dumps from previous seconds
+    if (m_TracebackSkipped && now != m_TracebackTime)
+    {
+        ReportSkippedTracebacks();
+    }
+    // Report errors whose window has expired
+    for (Repeats::iterator itr = m_Repeats.begin(); itr != m_Repeats.end();)
+    {
+        // Is this error still within the repeat window?
+        if (m_RepeatWindow && (now - itr->second.mTime) < static_cast< std::time_t >(m_RepeatWindow))
+        {
+            ++itr;
+            continue;
+        }
+        // Were there any repetitions suppressed?
+        else if (itr->second.mCount)
+        {
+            Write(LOGL_WRN, false, "Suppressed %u repetitions of error: %s", itr->second.mCount, itr->first.c_str());
+        }
+        // Stop tracking this error
+        itr = m_Repeats.erase(itr);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -729,6 +1363,11 @@ template < Uint8 L, bool S > static SQInteger LogBasicMessage(HSQUIRRELVM vm)
     {
         return sq_throwerror(vm, "Missing message value");
     }
+    // Don't bother generating the message if it would be discarded anyway
+    else if (!Logger::Get().IsEnabled(L))
+    {
+        return 0;
+    }
     // Attempt to generate the string value
     StackStrF val(vm, 2);
     // Have we failed to retrieve the string?
@@ -742,6 +1381,81 @@ template < Uint8 L, bool S > static SQInteger LogBasicMessage(HSQUIRRELVM vm)
     return 0;
 }
 
+// ------------------------------------------------------------------------------------------------
+template < bool S > static SQInteger LogLazyMessage(HSQUIRRELVM vm)
+{
+    const Int32 top = sq_gettop(vm);
+    // Was the message value specified?
+    if (top <= 2)
+    {
+        return sq_throwerror(vm, "Missing message value");
+    }
+    // Attempt to retrieve the log level
+    SQInteger level = 0;
+    if (SQ_FAILED(sq_getinteger(vm, 2, &level)))
+    {
+        return sq_throwerror(vm, "Invalid log level");
+    }
+    // Only a single level is accepted, not a mask of them
+    else if (level < 0 || level > 0xFF || GetLevelIdx(static_cast< Uint8 >(level)) > 6)
+    {
+        return sq_throwerror(vm, "Invalid log level");
+    }
+    const Uint8 lvl = static_cast< Uint8 >(level);
+    // Don't bother generating the message if it would be discarded anyway
+    if (!Logger::Get().IsEnabled(lvl))
+    {
+        return 0;
+    }
+    // Is the message generated by a function?
+    const SQObjectType type = sq_gettype(vm, 3);
+    if (type == OT_CLOSURE || type == OT_NATIVECLOSURE)
+    {
+        // Push the function and the environment
+        sq_push(vm, 3);
+        sq_pushroottable(vm);
+        // Forward the remaining arguments
+        for (Int32 idx = 4; idx <= top; ++idx)
+        {
+            sq_push(vm, idx);
+        }
+        // Invoke the function and keep the returned message
+        if (SQ_FAILED(sq_call(vm, top - 2, SQTrue, ErrorHandling::IsEnabled())))
+        {
+            return SQ_ERROR; // Propagate the error!
+        }
+        // Attempt to generate the string value from the returned message
+        StackStrF val(vm, -1);
+        // Have we failed to retrieve the string?
+        if (SQ_FAILED(val.Proc(false)))
+        {
+            return val.mRes; // Propagate the error!
+        }
+        // Forward the resulted string value to the logger
+        Logger::Get().Write(lvl, S, "%s", val.mPtr);
+    }
+    else
+    {
+        // Attempt to generate the string value
+        StackStrF val(vm, 3);
+        // Have we failed to retrieve the string?
+        if (SQ_FAILED(val.Proc(true)))
+        {
+            return val.mRes; // Propagate the error!
+        }
+        // Forward the resulted string value to the logger
+        Logger::Get().Write(lvl, S, "%s", val.mPtr);
+    }
+    // This function does not return a value
+    return 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+static bool SqLogIsEnabled(SQInteger level)
+{
+    return Logger::Get().IsEnabled(ConvTo< Uint8 >::From(level));
+}
+
 // ------------------------------------------------------------------------------------------------
 template < Uint8 L > static void BindLogCallback(Object & env, Function & func)
 {
@@ -845,7 +1559,7 @@ static void SqLogToggleLogFileLevel(SQInteger level, bool toggle)
 }
 
 // ------------------------------------------------------------------------------------------------
-static const String & SqLogGetLogFilename()
+static String SqLogGetLogFilename()
 {
     return Logger::Get().GetLogFilename();
 }
@@ -868,6 +1582,138 @@ static void SqLogSetStringTruncate(SQInteger nc)
     Logger::Get().SetStringTruncate(ConvTo< Uint32 >::From(nc));
 }
 
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqLogGetLogFileFormat()
+{
+    return static_cast< SQInteger >(Logger::Get().GetLogFileFormat());
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetLogFileFormat(SQInteger fmt)
+{
+    Logger::Get().SetLogFileFormat(ConvTo< Uint8 >::From(fmt));
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqLogGetRotateSize()
+{
+    return static_cast< SQInteger >(Logger::Get().GetRotateSize());
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetRotateSize(SQInteger size)
+{
+    Logger::Get().SetRotateSize(ConvTo< Uint32 >::From(size));
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqLogGetRotateInterval()
+{
+    return static_cast< SQInteger >(Logger::Get().GetRotateInterval());
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetRotateInterval(SQInteger seconds)
+{
+    Logger::Get().SetRotateInterval(ConvTo< Uint32 >::From(seconds));
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogRotate()
+{
+    Logger::Get().Rotate();
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqLogGetRepeatWindow()
+{
+    return static_cast< SQInteger >(Logger::Get().GetRepeatWindow());
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetRepeatWindow(SQInteger seconds)
+{
+    Logger::Get().SetRepeatWindow(ConvTo< Uint32 >::From(seconds));
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqLogGetTracebackLimit()
+{
+    return static_cast< SQInteger >(Logger::Get().GetTracebackLimit());
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetTracebackLimit(SQInteger limit)
+{
+    Logger::Get().SetTracebackLimit(ConvTo< Uint32 >::From(limit));
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqLogGetRingSize()
+{
+    return static_cast< SQInteger >(Logger::Get().GetRingSize());
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetRingSize(SQInteger size)
+{
+    Logger::Get().SetRingSize(ConvTo< Uint32 >::From(size));
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqLogGetRingLevels()
+{
+    return static_cast< SQInteger >(Logger::Get().GetRingLevels());
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetRingLevels(SQInteger levels)
+{
+    Logger::Get().SetRingLevels(ConvTo< Uint8 >::From(levels));
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogEnableRingLevel(SQInteger level)
+{
+    Logger::Get().EnableRingLevel(ConvTo< Uint8 >::From(level));
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogDisableRingLevel(SQInteger level)
+{
+    Logger::Get().DisableRingLevel(ConvTo< Uint8 >::From(level));
+}
+
+// ------------------------------------------------------------------------------------------------
+static String SqLogGetRingDumpFile()
+{
+    return Logger::Get().GetRingDumpFile();
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetRingDumpFile(CSStr filename)
+{
+    Logger::Get().SetRingDumpFile(filename);
+}
+
+// ------------------------------------------------------------------------------------------------
+static String SqLogGetRing()
+{
+    return Logger::Get().GetRing();
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogClearRing()
+{
+    Logger::Get().ClearRing();
+}
+
+// ------------------------------------------------------------------------------------------------
+static bool SqLogDumpRing(CSStr filename)
+{
+    return Logger::Get().DumpRing(filename);
+}
+
 // ================================================================================================
 void Register_Log(HSQUIRRELVM vm)
 {
@@ -887,6 +1733,9 @@ void Register_Log(HSQUIRRELVM vm)
         .SquirrelFunc(_SC("SWrn"), &LogBasicMessage< LOGL_WRN, true >)
         .SquirrelFunc(_SC("SErr"), &LogBasicMessage< LOGL_ERR, true >)
         .SquirrelFunc(_SC("SFtl"), &LogBasicMessage< LOGL_FTL, true >)
+        .SquirrelFunc(_SC("Lazy"), &LogLazyMessage< false >)
+        .SquirrelFunc(_SC("SLazy"), &LogLazyMessage< true >)
+        .Func(_SC("IsEnabled"), &SqLogIsEnabled)
         .Func(_SC("BindDbg"), &BindLogCallback< LOGL_DBG >)
         .Func(_SC("BindUsr"), &BindLogCallback< LOGL_USR >)
         .Func(_SC("BindScs"), &BindLogCallback< LOGL_SCS >)
@@ -914,6 +1763,44 @@ void Register_Log(HSQUIRRELVM vm)
         .Func(_SC("SetLogFilename"), &SqLogSetLogFilename)
         .Func(_SC("GetStringTruncate"), &SqLogGetStringTruncate)
         .Func(_SC("SetStringTruncate"), &SqLogSetStringTruncate)
+        .Func(_SC("GetLogFileFormat"), &SqLogGetLogFileFormat)
+        .Func(_SC("SetLogFileFormat"), &SqLogSetLogFileFormat)
+        .Func(_SC("GetRotateSize"), &SqLogGetRotateSize)
+        .Func(_SC("SetRotateSize"), &SqLogSetRotateSize)
+        .Func(_SC("GetRotateInterval"), &SqLogGetRotateInterval)
+        .Func(_SC("SetRotateInterval"), &SqLogSetRotateInterval)
+        .Func(_SC("Rotate"), &SqLogRotate)
+        .Func(_SC("GetRepeatWindow"), &SqLogGetRepeatWindow)
+        .Func(_SC("SetRepeatWindow"), &SqLogSetRepeatWindow)
+        .Func(_SC("GetTracebackLimit"), &SqLogGetTracebackLimit)
+        .Func(_SC("SetTracebackLimit"), &SqLogSetTracebackLimit)
+        .Func(_SC("GetRingSize"), &SqLogGetRingSize)
+        .Func(_SC("SetRingSize"), &SqLogSetRingSize)
+        .Func(_SC("GetRingLevels"), &SqLogGetRingLevels)
+        .Func(_SC("SetRingLevels"), &SqLogSetRingLevels)
+        .Func(_SC("EnableRingLevel"), &SqLogEnableRingLevel)
+        .Func(_SC("DisableRingLevel"), &SqLogDisableRingLevel)
+        .Func(_SC("GetRingDumpFile"), &SqLogGetRingDumpFile)
+        .Func(_SC("SetRingDumpFile"), &SqLogSetRingDumpFile)
+        .Func(_SC("GetRing"), &SqLogGetRing)
+        .Func(_SC("ClearRing"), &SqLogClearRing)
+        .Func(_SC("DumpRing"), &SqLogDumpRing)
+    );
+
+    ConstTable(vm).Enum(_SC("SqLogLevel"), Enumeration(vm)
+        .Const(_SC("Dbg"),      LOGL_DBG)
+        .Const(_SC("Usr"),      LOGL_USR)
+        .Const(_SC("Scs"),      LOGL_SCS)
+        .Const(_SC("Inf"),      LOGL_INF)
+        .Const(_SC("Wrn"),      LOGL_WRN)
+        .Const(_SC("Err"),      LOGL_ERR)
+        .Const(_SC("Ftl"),      LOGL_FTL)
+        .Const(_SC("Any"),      LOGL_ANY)
+    );
+
+    ConstTable(vm).Enum(_SC("SqLogFormat"), Enumeration(vm)
+        .Const(_SC("Text"),     LOGF_TEXT)
+        .Const(_SC("JSON"),     LOGF_JSON)
     );
 }
 
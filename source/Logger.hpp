@@ -7,7 +7,13 @@
 
 // ------------------------------------------------------------------------------------------------
 #include <cstdio>
+#include <ctime>
 #include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 
 // ------------------------------------------------------------------------------------------------
 #include <sqrat/sqratFunction.h>
@@ -31,6 +37,15 @@ enum LogLvl
     LOGL_ANY = 0xFF
 };
 
+/* ------------------------------------------------------------------------------------------------
+ * Supported formats of the log file records.
+*/
+enum LogFmt
+{
+    LOGF_TEXT = 0,
+    LOGF_JSON
+};
+
 /* ------------------------------------------------------------------------------------------------
  * Class responsible for logging output.
 */
@@ -91,6 +106,58 @@ private:
     // --------------------------------------------------------------------------------------------
     std::FILE*  m_File; // Handle to the file where the logs should be saved.
     std::string m_Filename; // The name of the file where the logs are saved.
+    std::string m_FilePattern; // The pattern used to generate the name of the log file.
+
+    // --------------------------------------------------------------------------------------------
+    Uint8       m_LogFileFormat; // The format of the records written to the log file.
+    Uint32      m_RotateSize; // The number of bytes after which the log file is rotated.
+    Uint32      m_RotateInterval; // The number of seconds after which the log file is rotated.
+    Uint64      m_FileSize; // The number of bytes written to the current log file.
+    std::time_t m_FileTime; // The time when the current log file was opened.
+
+    // --------------------------------------------------------------------------------------------
+    std::string m_Pending; // Records waiting to be written to the log file.
+    std::thread m_Writer; // The thread responsible for writing and rotating the log file.
+    std::mutex  m_Mutex; // Mutex used to synchronize access to the pending records and file.
+    std::condition_variable m_Condition; // Used to wake up the writer thread.
+    std::condition_variable m_Flushed; // Signaled when the writer thread wrote a batch of records.
+    Uint32      m_Taken; // Number of batches of records taken by the writer thread.
+    Uint32      m_Written; // Number of batches of records written by the writer thread.
+    bool        m_Writing; // Whether the writer thread should keep running.
+    bool        m_RotateNow; // Whether the log file should be rotated as soon as possible.
+
+    // --------------------------------------------------------------------------------------------
+    std::string m_Traceback; // Script traceback attached to the next structured record.
+    std::string m_Record; // Structured error record waiting for the blocks of its traceback.
+    bool        m_Folding; // Whether traceback blocks are folded into the structured error record.
+
+    /* --------------------------------------------------------------------------------------------
+     * Information about an error that is being deduplicated.
+    */
+    struct Repeat
+    {
+        std::time_t mTime; // The time when the error was last reported.
+        Uint32      mCount; // The number of suppressed repetitions since then.
+    };
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::unordered_map< std::string, Repeat > Repeats;
+
+    // --------------------------------------------------------------------------------------------
+    Repeats     m_Repeats; // Errors reported within the repeat window.
+    Uint32      m_RepeatWindow; // The number of seconds during which identical errors are suppressed.
+    Uint32      m_TracebackLimit; // The maximum number of traceback dumps per second.
+    Uint32      m_TracebackCount; // The number of traceback dumps during the current second.
+    Uint32      m_TracebackSkipped; // The number of traceback dumps skipped during the current second.
+    std::time_t m_TracebackTime; // The second in which the traceback dumps are being counted.
+    std::time_t m_SuppressTime; // The last time the suppressed errors were processed.
+
+    // --------------------------------------------------------------------------------------------
+    std::vector< char > m_Ring; // Memory where the most recent messages are recorded.
+    Uint32      m_RingPos; // The position in the ring where the next message is written.
+    bool        m_RingFull; // Whether the ring wrapped around at least once.
+    Uint8       m_RingLevels; // The levels allowed to be recorded in the ring.
+    std::string m_RingDumpFile; // The file where the ring is dumped when a fatal error occurs.
 
     // --------------------------------------------------------------------------------------------
 	Function m_LogCb[7]; //Callback to receive debug information instead of console.
@@ -102,6 +169,51 @@ protected:
     */
     void Proccess(Uint8 level, bool sub);
 
+    /* --------------------------------------------------------------------------------------------
+     * Append the message in the internal buffer to the pending log file records.
+    */
+    void Enqueue(Uint8 level, bool sub, CCStr tms);
+
+    /* --------------------------------------------------------------------------------------------
+     * Terminate the structured error record and append it to the pending log file records.
+    */
+    void FlushRecord();
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether an error at the specified location should be suppressed.
+    */
+    bool SuppressRepeat(CSStr source, SQInteger line, Int32 length);
+
+    /* --------------------------------------------------------------------------------------------
+     * Report the skipped traceback dumps, if any.
+    */
+    void ReportSkippedTracebacks();
+
+    /* --------------------------------------------------------------------------------------------
+     * Record the message in the internal buffer into the in-memory ring.
+    */
+    void RecordRing(Uint8 level, bool sub);
+
+    /* --------------------------------------------------------------------------------------------
+     * Append raw data to the in-memory ring, overwriting the oldest data if necessary.
+    */
+    void AppendRing(CCStr data, Uint32 size);
+
+    /* --------------------------------------------------------------------------------------------
+     * Write pending records to the log file and rotate it when necessary. (writer thread)
+    */
+    void WriterLoop();
+
+    /* --------------------------------------------------------------------------------------------
+     * Close the current log file and open a new one. (writer thread, mutex locked)
+    */
+    void RotateFile(std::time_t now);
+
+    /* --------------------------------------------------------------------------------------------
+     * Open the log file with the specified name.
+    */
+    bool OpenFile(const std::string & filename);
+
 public:
 
     /* --------------------------------------------------------------------------------------------
@@ -196,6 +308,14 @@ public:
         return m_LogFileLevels;
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * See whether messages of a certain level would be outputted at all.
+    */
+    bool IsEnabled(Uint8 level) const
+    {
+        return ((m_ConsoleLevels | m_LogFileLevels | GetActiveRingLevels()) & level) != 0;
+    }
+
     /* --------------------------------------------------------------------------------------------
      * Enable a certain console logging level.
     */
@@ -281,11 +401,208 @@ public:
     /* --------------------------------------------------------------------------------------------
      * Retrieve the log file name.
     */
-    const std::string & GetLogFilename() const
+    std::string GetLogFilename()
     {
+        std::lock_guard< std::mutex > lg(m_Mutex);
+        // The writer thread may change the name when rotating
         return m_Filename;
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the format of the log file records.
+    */
+    Uint8 GetLogFileFormat() const
+    {
+        return m_LogFileFormat;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the format of the log file records.
+    */
+    void SetLogFileFormat(Uint8 fmt)
+    {
+        m_LogFileFormat = (fmt == LOGF_JSON) ? LOGF_JSON : LOGF_TEXT;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of bytes after which the log file is rotated.
+    */
+    Uint32 GetRotateSize() const
+    {
+        return m_RotateSize;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the number of bytes after which the log file is rotated. (0 to disable)
+    */
+    void SetRotateSize(Uint32 size)
+    {
+        std::lock_guard< std::mutex > lg(m_Mutex);
+        // The writer thread reads this value
+        m_RotateSize = size;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of seconds after which the log file is rotated.
+    */
+    Uint32 GetRotateInterval() const
+    {
+        return m_RotateInterval;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the number of seconds after which the log file is rotated. (0 to disable)
+    */
+    void SetRotateInterval(Uint32 seconds)
+    {
+        std::lock_guard< std::mutex > lg(m_Mutex);
+        // The writer thread reads this value
+        m_RotateInterval = seconds;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Request the log file to be rotated by the writer thread.
+    */
+    void Rotate();
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of seconds during which identical errors are suppressed.
+    */
+    Uint32 GetRepeatWindow() const
+    {
+        return m_RepeatWindow;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the number of seconds during which identical errors are suppressed. (0 to disable)
+    */
+    void SetRepeatWindow(Uint32 seconds);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of traceback dumps per second.
+    */
+    Uint32 GetTracebackLimit() const
+    {
+        return m_TracebackLimit;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of traceback dumps per second. (0 to disable)
+    */
+    void SetTracebackLimit(Uint32 limit)
+    {
+        m_TracebackLimit = limit;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the size of the in-memory ring.
+    */
+    Uint32 GetRingSize() const
+    {
+        return static_cast< Uint32 >(m_Ring.size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the size of the in-memory ring. (0 to disable) Recorded messages are discarded.
+    */
+    void SetRingSize(Uint32 size);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the levels allowed to be recorded in the in-memory ring.
+    */
+    Uint8 GetRingLevels() const
+    {
+        return m_RingLevels;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the levels allowed to be recorded in the in-memory ring.
+    */
+    void SetRingLevels(Uint8 levels)
+    {
+        m_RingLevels = levels;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the levels actually recorded in the in-memory ring.
+    */
+    Uint8 GetActiveRingLevels() const
+    {
+        return m_Ring.empty() ? 0 : m_RingLevels;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Enable a certain in-memory ring logging level.
+    */
+    void EnableRingLevel(Uint8 level)
+    {
+        m_RingLevels |= level;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Disable a certain in-memory ring logging level.
+    */
+    void DisableRingLevel(Uint8 level)
+    {
+        m_RingLevels |= level;
+        m_RingLevels ^= level;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Toggle a certain in-memory ring logging level.
+    */
+    void ToggleRingLevel(Uint8 level, bool toggle)
+    {
+        if (toggle)
+        {
+            EnableRingLevel(level);
+        }
+        else
+        {
+            DisableRingLevel(level);
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the file where the in-memory ring is dumped when a fatal error occurs.
+    */
+    const std::string & GetRingDumpFile() const
+    {
+        return m_RingDumpFile;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the file where the in-memory ring is dumped when a fatal error occurs.
+    */
+    void SetRingDumpFile(CCStr filename)
+    {
+        m_RingDumpFile.assign(filename ? filename : _SC(""));
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the contents of the in-memory ring, from the oldest to the newest message.
+    */
+    std::string GetRing() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Clear the contents of the in-memory ring.
+    */
+    void ClearRing()
+    {
+        m_RingPos = 0;
+        m_RingFull = false;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Dump the contents of the in-memory ring to a file or to the console if no file is specified.
+    */
+    bool DumpRing(CCStr filename) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Report suppressed errors whose repeat window has expired.
+    */
+    void ProcessSuppressed();
+
     /* --------------------------------------------------------------------------------------------
      * Modify the log file name.
     */
@@ -79,6 +79,12 @@ void DoReload()
 // --------------------------------------------------------------------------------------------
 #define SQMOD_RELOAD_CHECK(exp) if (exp) DoReload();
 
+// ------------------------------------------------------------------------------------------------
+#define SQMOD_TIME_CALLBACK(ev) /*
+*/ static Histogram & ev##_histogram = Core::Get().GetMetrics().Callback(#ev); /*
+*/ const Metrics::Timer ev##_timer(Core::Get().GetMetrics(), ev##_histogram); /*
+*/
+
 // ------------------------------------------------------------------------------------------------
 static uint8_t OnServerInitialise(void)
 {
@@ -137,6 +143,8 @@ static void OnServerShutdown(void)
         Core::Get().EmitServerShutdown();
         // Deallocate and release everything obtained at startup
         Core::Get().Terminate(true);
+        // Write the pending log records and stop the log writer
+        Logger::Get().Close();
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnServerShutdown")
     }
     SQMOD_CATCH_EVENT_EXCEPTION(OnServerShutdown)
@@ -147,17 +155,31 @@ static void OnServerShutdown(void)
 // ------------------------------------------------------------------------------------------------
 static void OnServerFrame(float elapsed_time)
 {
+    Metrics & metrics = Core::Get().GetMetrics();
+    // Remember when the frame started
+    const Int64 frame_start = Metrics::Now();
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnServerFrame)
         //SQMOD_SV_EV_TRACEBACK("[TRACE<] OnServerFrame")
         Core::Get().EmitServerFrame(elapsed_time);
         //SQMOD_SV_EV_TRACEBACK("[TRACE>] OnServerFrame")
     }
     SQMOD_CATCH_EVENT_EXCEPTION(OnServerFrame)
     // Process routines and tasks, if any
+    Int64 mark = Metrics::Now();
     ProcessRoutines();
+    mark = metrics.Phase(Metrics::FP_ROUTINES, mark);
     ProcessTasks();
+    mark = metrics.Phase(Metrics::FP_TASKS, mark);
+    // Collect garbage if there's enough reason and time left in the frame
+    Core::Get().GetCollector().Frame(DefaultVM::Get(), mark - frame_start);
+    metrics.Phase(Metrics::FP_COLLECTOR, mark);
+    // Record the time spent on the frame
+    metrics.Frame();
+    // Report errors that were suppressed by the logger
+    Logger::Get().ProcessSuppressed();
     // See if a reload was requested
     SQMOD_RELOAD_CHECK(g_Reload)
 }
@@ -170,6 +192,7 @@ static uint8_t OnPluginCommand(uint32_t command_identifier, CCStr message)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPluginCommand)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPluginCommand")
         Core::Get().EmitPluginCommand(command_identifier, message);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPluginCommand")
@@ -190,6 +213,7 @@ static uint8_t OnIncomingConnection(CStr player_name, size_t name_buffer_size,
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnIncomingConnection)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnIncomingConnection")
         Core::Get().EmitIncomingConnection(player_name, name_buffer_size, user_password, ip_address);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnIncomingConnection")
@@ -207,6 +231,7 @@ static void OnClientScriptData(int32_t player_id, const uint8_t * data, size_t s
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnClientScriptData)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnClientScriptData")
         Core::Get().EmitClientScriptData(player_id, data, size);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnClientScriptData")
@@ -222,6 +247,7 @@ static void OnPlayerConnect(int32_t player_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerConnect)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerConnect")
         Core::Get().ConnectPlayer(player_id, SQMOD_CREATE_AUTOMATIC, NullLightObj());
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerConnect")
@@ -237,6 +263,7 @@ static void OnPlayerDisconnect(int32_t player_id, vcmpDisconnectReason reason)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerDisconnect)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerDisconnect")
         if (reason == vcmpDisconnectReasonKick)
         {
@@ -262,6 +289,7 @@ static uint8_t OnPlayerRequestClass(int32_t player_id, int32_t offset)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerRequestClass)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerRequestClass")
         Core::Get().EmitPlayerRequestClass(player_id, offset);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerRequestClass")
@@ -281,6 +309,7 @@ static uint8_t OnPlayerRequestSpawn(int32_t player_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerRequestSpawn)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerRequestSpawn")
         Core::Get().EmitPlayerRequestSpawn(player_id);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerRequestSpawn")
@@ -298,6 +327,7 @@ static void OnPlayerSpawn(int32_t player_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerSpawn)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerSpawn")
         Core::Get().EmitPlayerSpawn(player_id);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerSpawn")
@@ -313,6 +343,7 @@ static void OnPlayerDeath(int32_t player_id, int32_t killer_id, int32_t reason,
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerDeath)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerDeath")
         if (_Func->IsPlayerConnected(killer_id))
         {
@@ -337,6 +368,7 @@ static void OnPlayerUpdate(int32_t player_id, vcmpPlayerUpdate update_type)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerUpdate)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerUpdate")
         Core::Get().EmitPlayerUpdate(player_id, update_type);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerUpdate")
@@ -354,6 +386,7 @@ static uint8_t OnPlayerRequestEnterVehicle(int32_t player_id, int32_t vehicle_id
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerRequestEnterVehicle)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerRequestEnterVehicle")
         Core::Get().EmitPlayerEmbarking(player_id, vehicle_id, slot_index);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerRequestEnterVehicle")
@@ -371,6 +404,7 @@ static void OnPlayerEnterVehicle(int32_t player_id, int32_t vehicle_id, int32_t
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerEnterVehicle)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerEnterVehicle")
         Core::Get().EmitPlayerEmbarked(player_id, vehicle_id, slot_index);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerEnterVehicle")
@@ -386,6 +420,7 @@ static void OnPlayerExitVehicle(int32_t player_id, int32_t vehicle_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerExitVehicle)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerExitVehicle")
         Core::Get().EmitPlayerDisembark(player_id, vehicle_id);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerExitVehicle")
@@ -401,6 +436,7 @@ static void OnPlayerNameChange(int32_t player_id, CCStr old_name, CCStr new_name
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerNameChange)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerNameChange")
         Core::Get().EmitPlayerRename(player_id, old_name, new_name);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerNameChange")
@@ -416,6 +452,7 @@ static void OnPlayerStateChange(int32_t player_id, vcmpPlayerState old_state, vc
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerStateChange)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerStateChange")
         Core::Get().EmitPlayerState(player_id, old_state, new_state);
         // Identify the current state and trigger the listeners specific to that
@@ -463,6 +500,7 @@ static void OnPlayerActionChange(int32_t player_id, int32_t old_action, int32_t
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerActionChange)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerActionChange")
         Core::Get().EmitPlayerAction(player_id, old_action, new_action);
         // Identify the current action and trigger the listeners specific to that
@@ -521,6 +559,7 @@ static void OnPlayerOnFireChange(int32_t player_id, uint8_t is_on_fire)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerOnFireChange)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerOnFireChange")
         Core::Get().EmitPlayerBurning(player_id, is_on_fire);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerOnFireChange")
@@ -536,6 +575,7 @@ static void OnPlayerCrouchChange(int32_t player_id, uint8_t is_crouching)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerCrouchChange)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerCrouchChange")
         Core::Get().EmitPlayerCrouching(player_id, is_crouching);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerCrouchChange")
@@ -551,6 +591,7 @@ static void OnPlayerGameKeysChange(int32_t player_id, uint32_t old_keys, uint32_
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerGameKeysChange)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerGameKeysChange")
         Core::Get().EmitPlayerGameKeys(player_id, old_keys, new_keys);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerGameKeysChange")
@@ -566,6 +607,7 @@ static void OnPlayerBeginTyping(int32_t player_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerBeginTyping)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerBeginTyping")
         Core::Get().EmitPlayerStartTyping(player_id);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerBeginTyping")
@@ -581,6 +623,7 @@ static void OnPlayerEndTyping(int32_t player_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerEndTyping)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerEndTyping")
         Core::Get().EmitPlayerStopTyping(player_id);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerEndTyping")
@@ -596,6 +639,7 @@ static void OnPlayerAwayChange(int32_t player_id, uint8_t is_away)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerAwayChange)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerAwayChange")
         Core::Get().EmitPlayerAway(player_id, is_away);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerAwayChange")
@@ -613,6 +657,7 @@ static uint8_t OnPlayerMessage(int32_t player_id, CCStr message)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerMessage)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerMessage")
         Core::Get().EmitPlayerMessage(player_id, message);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerMessage")
@@ -632,6 +677,7 @@ static uint8_t OnPlayerCommand(int32_t player_id, CCStr message)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerCommand)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerCommand")
         Core::Get().EmitPlayerCommand(player_id, message);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerCommand")
@@ -651,6 +697,7 @@ static uint8_t OnPlayerPrivateMessage(int32_t player_id, int32_t target_player_i
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerPrivateMessage)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerPrivateMessage")
         Core::Get().EmitPlayerPrivateMessage(player_id, target_player_id, message);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerPrivateMessage")
@@ -668,6 +715,7 @@ static void OnPlayerKeyBindDown(int32_t player_id, int32_t bind_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerKeyBindDown)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerKeyBindDown")
         Core::Get().EmitPlayerKeyPress(player_id, bind_id);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerKeyBindDown")
@@ -683,6 +731,7 @@ static void OnPlayerKeyBindUp(int32_t player_id, int32_t bind_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerKeyBindUp)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerKeyBindUp")
         Core::Get().EmitPlayerKeyRelease(player_id, bind_id);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerKeyBindUp")
@@ -698,6 +747,7 @@ static void OnPlayerSpectate(int32_t player_id, int32_t target_player_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerSpectate)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerSpectate")
         if (target_player_id < 0)
         {
@@ -720,6 +770,7 @@ static void OnPlayerCrashReport(int32_t player_id, CCStr report)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerCrashReport)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerCrashReport")
         Core::Get().EmitPlayerCrashreport(player_id, report);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerCrashReport")
@@ -734,6 +785,7 @@ static void OnPlayerModuleList(int32_t player_id, const char * list)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPlayerModuleList)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPlayerModuleList")
         Core::Get().EmitPlayerModuleList(player_id, list);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPlayerModuleList")
@@ -749,6 +801,7 @@ static void OnVehicleUpdate(int32_t vehicle_id, vcmpVehicleUpdate update_type)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnVehicleUpdate)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnVehicleUpdate")
         Core::Get().EmitVehicleUpdate(vehicle_id, update_type);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnVehicleUpdate")
@@ -764,6 +817,7 @@ static void OnVehicleExplode(int32_t vehicle_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnVehicleExplode)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnVehicleExplode")
         Core::Get().EmitVehicleExplode(vehicle_id);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnVehicleExplode")
@@ -779,6 +833,7 @@ static void OnVehicleRespawn(int32_t vehicle_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnVehicleRespawn)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnVehicleRespawn")
         Core::Get().EmitVehicleRespawn(vehicle_id);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnVehicleRespawn")
@@ -794,6 +849,7 @@ static void OnObjectShot(int32_t object_id, int32_t player_id, int32_t weapon_id
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnObjectShot)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnObjectShot")
         Core::Get().EmitObjectShot(object_id, player_id, weapon_id);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnObjectShot")
@@ -809,6 +865,7 @@ static void OnObjectTouched(int32_t object_id, int32_t player_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnObjectTouched)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnObjectTouched")
         Core::Get().EmitObjectTouched(object_id, player_id);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnObjectTouched")
@@ -826,6 +883,7 @@ static uint8_t OnPickupPickAttempt(int32_t pickup_id, int32_t player_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPickupPickAttempt)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPickupPickAttempt")
         Core::Get().EmitPickupClaimed(pickup_id, player_id);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPickupPickAttempt")
@@ -843,6 +901,7 @@ static void OnPickupPicked(int32_t pickup_id, int32_t player_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPickupPicked)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPickupPicked")
         Core::Get().EmitPickupCollected(pickup_id, player_id);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPickupPicked")
@@ -858,6 +917,7 @@ static void OnPickupRespawn(int32_t pickup_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnPickupRespawn)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnPickupRespawn")
         Core::Get().EmitPickupRespawn(pickup_id);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnPickupRespawn")
@@ -873,6 +933,7 @@ static void OnCheckpointEntered(int32_t checkpoint_id, int32_t player_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnCheckpointEntered)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnCheckpointEntered")
         Core::Get().EmitCheckpointEntered(checkpoint_id, player_id);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnCheckpointEntered")
@@ -888,6 +949,7 @@ static void OnCheckpointExited(int32_t checkpoint_id, int32_t player_id)
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnCheckpointExited)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnCheckpointExited")
         Core::Get().EmitCheckpointExited(checkpoint_id, player_id);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnCheckpointExited")
@@ -903,6 +965,7 @@ static void OnEntityPoolChange(vcmpEntityPool entity_type, int32_t entity_id, ui
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnEntityPoolChange)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnEntityPoolChange")
         Core::Get().EmitEntityPool(entity_type, entity_id, is_deleted);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnEntityPoolChange")
@@ -918,6 +981,7 @@ static void OnEntityStreamingChange(int32_t player_id, int32_t entity_id, vcmpEn
     // Attempt to forward the event
     try
     {
+        SQMOD_TIME_CALLBACK(OnEntityStreamingChange)
         SQMOD_SV_EV_TRACEBACK("[TRACE<] OnEntityStreamingChange")
         Core::Get().EmitEntityStreaming(player_id, entity_id, entity_type, is_deleted);
         SQMOD_SV_EV_TRACEBACK("[TRACE>] OnEntityStreamingChange")
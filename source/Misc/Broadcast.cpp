@@ -3,11 +3,19 @@
 #include "Base/Shared.hpp"
 #include "Base/Color3.hpp"
 #include "Base/Color4.hpp"
+#include "Entity/Checkpoint.hpp"
+#include "Entity/Object.hpp"
+#include "Entity/Pickup.hpp"
 #include "Entity/Player.hpp"
+#include "Entity/Vehicle.hpp"
+#include "Library/Utils/Buffer.hpp"
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
 
+// ------------------------------------------------------------------------------------------------
+static const String g_EmptyAffix; // Used when a message has no affix at a certain position.
+
 // ------------------------------------------------------------------------------------------------
 static inline bool SqCanBeInteger(HSQUIRRELVM vm, Int32 idx)
 {
@@ -230,6 +238,217 @@ SQRESULT SqGrabPlayerMessageColor(HSQUIRRELVM vm, Int32 idx, Uint32 & color, Int
     return SQ_OK;
 }
 
+/* ------------------------------------------------------------------------------------------------
+ * Criteria used to select the players that receive a filtered broadcast.
+*/
+enum BroadcastFilter
+{
+    BCF_ALL = 0,
+    BCF_WORLD,
+    BCF_TEAM,
+    BCF_ADMIN,
+    BCF_MASK,
+    BCF_STREAMED,
+    BCF_MAX
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Selects the players that receive a filtered broadcast.
+*/
+struct BroadcastPredicate
+{
+    Int32   mFilter; // The criteria used to select the players.
+    Int32   mValue; // The value that the players are compared against.
+    Int32   mPool; // The entity pool of the streamed entity, if any.
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    BroadcastPredicate()
+        : mFilter(BCF_ALL), mValue(0), mPool(0)
+    {
+        /* ... */
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the specified player should receive the broadcast.
+    */
+    bool operator () (Int32 id, const CPlayer & player) const
+    {
+        switch (mFilter)
+        {
+            case BCF_WORLD:     return (_Func->GetPlayerWorld(id) == mValue);
+            case BCF_TEAM:      return (_Func->GetPlayerTeam(id) == mValue);
+            case BCF_ADMIN:     return ((_Func->IsPlayerAdmin(id) != 0) == (mValue != 0));
+            case BCF_MASK:      return ((player.mBroadcastMask & static_cast< Uint32 >(mValue)) != 0);
+            case BCF_STREAMED:
+            {
+                switch (mPool)
+                {
+                    case vcmpEntityPoolPlayer:      return _Func->IsPlayerStreamedForPlayer(mValue, id) != 0;
+                    case vcmpEntityPoolVehicle:     return _Func->IsVehicleStreamedForPlayer(mValue, id) != 0;
+                    case vcmpEntityPoolObject:      return _Func->IsObjectStreamedForPlayer(mValue, id) != 0;
+                    case vcmpEntityPoolPickup:      return _Func->IsPickupStreamedForPlayer(mValue, id) != 0;
+                    case vcmpEntityPoolCheckPoint:  return _Func->IsCheckPointStreamedForPlayer(mValue, id) != 0;
+                    default: return false;
+                }
+            }
+            default: return true;
+        }
+    }
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Attempt to extract the identifier and pool of the entity at the specified stack index.
+*/
+template < typename T > static bool SqGrabStreamedEntity(HSQUIRRELVM vm, Int32 idx, Int32 pool,
+                                                            BroadcastPredicate & pred)
+{
+    const T * ent = nullptr;
+    // Attempt to extract an instance of this type
+    try
+    {
+        ent = Var< const T * >(vm, idx).value;
+    }
+    catch (...)
+    {
+        return false;
+    }
+    // Is this a valid entity?
+    if (ent == nullptr || !ent->IsActive())
+    {
+        STHROWF("Invalid entity reference for streamed broadcast");
+    }
+    // Remember the entity
+    pred.mValue = ent->GetID();
+    pred.mPool = pool;
+    // We found the entity
+    return true;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Attempt to extract the broadcast filter and its value starting at the specified stack index.
+ * The index of the first argument after the filter is stored in the specified output.
+*/
+static SQRESULT SqGrabBroadcastFilter(HSQUIRRELVM vm, Int32 idx, BroadcastPredicate & pred, Int32 & next)
+{
+    // Attempt to extract the filter
+    pred.mFilter = ConvTo< Int32 >::From(PopStackInteger(vm, idx));
+    // Is this a known filter?
+    if (pred.mFilter < BCF_ALL || pred.mFilter >= BCF_MAX)
+    {
+        return sq_throwerror(vm, ToStrF("Unknown broadcast filter: %d", pred.mFilter));
+    }
+    // Selecting everyone doesn't take a value
+    else if (pred.mFilter == BCF_ALL)
+    {
+        next = idx + 1;
+        // The filter was extracted
+        return SQ_OK;
+    }
+    // Was the filter value specified?
+    else if (sq_gettop(vm) <= idx)
+    {
+        return sq_throwerror(vm, "Missing broadcast filter value");
+    }
+    // The value follows the filter
+    next = idx + 2;
+    // The streamed filter needs an entity
+    if (pred.mFilter != BCF_STREAMED)
+    {
+        pred.mValue = ConvTo< Int32 >::From(PopStackInteger(vm, idx + 1));
+        // The filter was extracted
+        return SQ_OK;
+    }
+    // Attempt to identify the streamed entity
+    try
+    {
+        if (SqGrabStreamedEntity< CPlayer >(vm, idx + 1, vcmpEntityPoolPlayer, pred) ||
+            SqGrabStreamedEntity< CVehicle >(vm, idx + 1, vcmpEntityPoolVehicle, pred) ||
+            SqGrabStreamedEntity< CObject >(vm, idx + 1, vcmpEntityPoolObject, pred) ||
+            SqGrabStreamedEntity< CPickup >(vm, idx + 1, vcmpEntityPoolPickup, pred) ||
+            SqGrabStreamedEntity< CCheckpoint >(vm, idx + 1, vcmpEntityPoolCheckPoint, pred))
+        {
+            return SQ_OK;
+        }
+    }
+    catch (const Sqrat::Exception & e)
+    {
+        return sq_throwerror(vm, e.what());
+    }
+    // We don't know what to do with this value
+    return sq_throwerror(vm, "Streamed broadcast requires a player, vehicle, object, pickup or checkpoint");
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Retrieve the message with the specified affixes. The message is returned as is when there are no
+ * affixes, otherwise the specified string is used to join them and avoid formatting on every send.
+*/
+static inline CSStr SqAffixMessage(String & out, const String & prefix, const String & infix,
+                                    const StackStrF & val, const String & postfix)
+{
+    // Can we send the message as is?
+    if (prefix.empty() && infix.empty() && postfix.empty())
+    {
+        return val.mPtr;
+    }
+    // Join the message with the affixes
+    out.assign(prefix).append(infix).append(val.mPtr, static_cast< size_t >(val.mLen)).append(postfix);
+    // Return the resulted message
+    return out.c_str();
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Retrieve the message with the specified affixes.
+*/
+static inline CSStr SqAffixMessage(String & out, const String & prefix, const StackStrF & val,
+                                    const String & postfix)
+{
+    // Can we send the message as is?
+    if (prefix.empty() && postfix.empty())
+    {
+        return val.mPtr;
+    }
+    // Join the message with the affixes
+    out.assign(prefix).append(val.mPtr, static_cast< size_t >(val.mLen)).append(postfix);
+    // Return the resulted message
+    return out.c_str();
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Invoke the specified function for every active player selected by the specified predicate.
+*/
+template < typename F > static SQInteger SqBroadcastEach(HSQUIRRELVM vm, const BroadcastPredicate & pred, F fn)
+{
+    // The number of players that the message was sent to
+    Uint32 count = 0;
+    // Obtain the player instances
+    const Core::Players & players = Core::Get().GetPlayers();
+    // Process each connected player
+    for (const Int32 id : Core::Get().GetActivePlayers())
+    {
+        // Grab the player instance
+        CPlayer * player = players[id].mInst;
+        // Is this player instance valid and selected by the filter?
+        if (player != nullptr && pred(id, *player))
+        {
+            // Send the message to this player
+            const SQRESULT res = fn(id, *player);
+            // Did we fail?
+            if (SQ_FAILED(res))
+            {
+                return res; // Propagate the error!
+            }
+            // Add this player to the count
+            ++count;
+        }
+    }
+    // Push the count count on the stack
+    sq_pushinteger(vm, count);
+    // Specify that this function returned a value
+    return 1;
+}
+
 // ------------------------------------------------------------------------------------------------
 static SQInteger SqBroadcastMsg(HSQUIRRELVM vm)
 {
@@ -266,28 +485,26 @@ static SQInteger SqBroadcastMsg(HSQUIRRELVM vm)
         return val.mRes; // Propagate the error!
     }
 
-    // Obtain the ends of the entity pool
-    Core::Players::const_iterator itr = Core::Get().GetPlayers().cbegin();
-    Core::Players::const_iterator end = Core::Get().GetPlayers().cend();
+    // Obtain the player instances
+    const Core::Players & players = Core::Get().GetPlayers();
     // The number of players that the message was sent to
     Uint32 count = 0;
     // Currently processed player
     CPlayer * player = nullptr;
+    // Storage for messages with affixes
+    String msg;
 
-    // Process each entity in the pool
-    for (; itr != end; ++itr)
+    // Process each connected player
+    for (const Int32 id : Core::Get().GetActivePlayers())
     {
         // Grab the player instance
-        player = itr->mInst;
+        player = players[id].mInst;
         // Is this player instance valid?
-        if (VALID_ENTITYEX(itr->mID, SQMOD_PLAYER_POOL) && player != nullptr)
+        if (player != nullptr)
         {
             // Send the resulted message string
-            const vcmpError result = _Func->SendClientMessage(itr->mID, color,
-                                                        "%s%s%s",
-                                                        player->mMessagePrefix.c_str(),
-                                                        val.mPtr,
-                                                        player->mMessagePostfix.c_str());
+            const vcmpError result = _Func->SendClientMessage(id, color, "%s",
+                                SqAffixMessage(msg, player->mMessagePrefix, val, player->mMessagePostfix));
             // Check the result
             if (result == vcmpErrorTooLargeInput)
             {
@@ -347,34 +564,34 @@ static SQInteger SqBroadcastMsgP(HSQUIRRELVM vm)
     }
 
     vcmpError result = vcmpErrorNone;
-    // Obtain the ends of the entity pool
-    Core::Players::const_iterator itr = Core::Get().GetPlayers().cbegin();
-    Core::Players::const_iterator end = Core::Get().GetPlayers().cend();
+    // Obtain the player instances
+    const Core::Players & players = Core::Get().GetPlayers();
     // The number of players that the message was sent to
     Uint32 count = 0;
     // Currently processed player
     CPlayer * player = nullptr;
+    // Storage for messages with affixes
+    String msg;
 
-    // Process each entity in the pool
-    for (; itr != end; ++itr)
+    // Process each connected player
+    for (const Int32 id : Core::Get().GetActivePlayers())
     {
         // Grab the player instance
-        player = itr->mInst;
+        player = players[id].mInst;
         // Is this player instance valid?
-        if (VALID_ENTITYEX(itr->mID, SQMOD_PLAYER_POOL) && player != nullptr)
+        if (player != nullptr)
         {
             // Send the resulted message string
             if (player->mLimitPrefixPostfixMessage)
             {
-                result = _Func->SendClientMessage(itr->mID, player->mMessageColor, "%s%s",
-                                                    player->mMessagePrefixes[index].c_str(), val.mPtr);
+                result = _Func->SendClientMessage(id, player->mMessageColor, "%s",
+                                    SqAffixMessage(msg, player->mMessagePrefixes[index], val, g_EmptyAffix));
             }
             else
             {
-                result = _Func->SendClientMessage(itr->mID, player->mMessageColor, "%s%s%s%s",
-                                                    player->mMessagePrefix.c_str(),
-                                                    player->mMessagePrefixes[index].c_str(), val.mPtr,
-                                                    player->mMessagePostfix.c_str());
+                result = _Func->SendClientMessage(id, player->mMessageColor, "%s",
+                                    SqAffixMessage(msg, player->mMessagePrefix, player->mMessagePrefixes[index],
+                                                    val, player->mMessagePostfix));
             }
             // Check the result
             if (result == vcmpErrorTooLargeInput)
@@ -452,34 +669,34 @@ static SQInteger SqBroadcastMsgEx(HSQUIRRELVM vm)
     }
 
     vcmpError result = vcmpErrorNone;
-    // Obtain the ends of the entity pool
-    Core::Players::const_iterator itr = Core::Get().GetPlayers().cbegin();
-    Core::Players::const_iterator end = Core::Get().GetPlayers().cend();
+    // Obtain the player instances
+    const Core::Players & players = Core::Get().GetPlayers();
     // The number of players that the message was sent to
     Uint32 count = 0;
     // Currently processed player
     CPlayer * player = nullptr;
+    // Storage for messages with affixes
+    String msg;
 
-    // Process each entity in the pool
-    for (; itr != end; ++itr)
+    // Process each connected player
+    for (const Int32 id : Core::Get().GetActivePlayers())
     {
         // Grab the player instance
-        player = itr->mInst;
+        player = players[id].mInst;
         // Is this player instance valid?
-        if (VALID_ENTITYEX(itr->mID, SQMOD_PLAYER_POOL) && player != nullptr)
+        if (player != nullptr)
         {
             // Send the resulted message string
             if (player->mLimitPrefixPostfixMessage)
             {
-                result = _Func->SendClientMessage(itr->mID, color, "%s%s",
-                                                    player->mMessagePrefixes[index].c_str(), val.mPtr);
+                result = _Func->SendClientMessage(id, color, "%s",
+                                    SqAffixMessage(msg, player->mMessagePrefixes[index], val, g_EmptyAffix));
             }
             else
             {
-                result = _Func->SendClientMessage(itr->mID, color, "%s%s%s%s",
-                                                    player->mMessagePrefix.c_str(),
-                                                    player->mMessagePrefixes[index].c_str(), val.mPtr,
-                                                    player->mMessagePostfix.c_str());
+                result = _Func->SendClientMessage(id, color, "%s",
+                                    SqAffixMessage(msg, player->mMessagePrefix, player->mMessagePrefixes[index],
+                                                    val, player->mMessagePostfix));
             }
             // Check the result
             if (result == vcmpErrorTooLargeInput)
@@ -515,28 +732,26 @@ static SQInteger SqBroadcastMessage(HSQUIRRELVM vm)
         return val.mRes; // Propagate the error!
     }
 
-    // Obtain the ends of the entity pool
-    Core::Players::const_iterator itr = Core::Get().GetPlayers().cbegin();
-    Core::Players::const_iterator end = Core::Get().GetPlayers().cend();
+    // Obtain the player instances
+    const Core::Players & players = Core::Get().GetPlayers();
     // The number of players that the message was sent to
     Uint32 count = 0;
     // Currently processed player
     CPlayer * player = nullptr;
+    // Storage for messages with affixes
+    String msg;
 
-    // Process each entity in the pool
-    for (; itr != end; ++itr)
+    // Process each connected player
+    for (const Int32 id : Core::Get().GetActivePlayers())
     {
         // Grab the player instance
-        player = itr->mInst;
+        player = players[id].mInst;
         // Is this player instance valid?
-        if (VALID_ENTITYEX(itr->mID, SQMOD_PLAYER_POOL) && player != nullptr)
+        if (player != nullptr)
         {
             // Send the resulted message string
-            const vcmpError result = _Func->SendClientMessage(itr->mID, player->mMessageColor,
-                                                                "%s%s%s",
-                                                                player->mMessagePrefix.c_str(),
-                                                                val.mPtr,
-                                                                player->mMessagePostfix.c_str());
+            const vcmpError result = _Func->SendClientMessage(id, player->mMessageColor, "%s",
+                                SqAffixMessage(msg, player->mMessagePrefix, val, player->mMessagePostfix));
             // Check the result
             if (result == vcmpErrorTooLargeInput)
             {
@@ -571,28 +786,26 @@ static SQInteger SqBroadcastAnnounce(HSQUIRRELVM vm)
         return val.mRes; // Propagate the error!
     }
 
-    // Obtain the ends of the entity pool
-    Core::Players::const_iterator itr = Core::Get().GetPlayers().cbegin();
-    Core::Players::const_iterator end = Core::Get().GetPlayers().cend();
+    // Obtain the player instances
+    const Core::Players & players = Core::Get().GetPlayers();
     // The number of players that the message was sent to
     Uint32 count = 0;
     // Currently processed player
     CPlayer * player = nullptr;
+    // Storage for messages with affixes
+    String msg;
 
-    // Process each entity in the pool
-    for (; itr != end; ++itr)
+    // Process each connected player
+    for (const Int32 id : Core::Get().GetActivePlayers())
     {
         // Grab the player instance
-        player = itr->mInst;
+        player = players[id].mInst;
         // Is this player instance valid?
-        if (VALID_ENTITYEX(itr->mID, SQMOD_PLAYER_POOL) && player != nullptr)
+        if (player != nullptr)
         {
             // Send the resulted announcement string
-            const vcmpError result = _Func->SendGameMessage(itr->mID, player->mAnnounceStyle,
-                                                            "%s%s%s",
-                                                            player->mAnnouncePrefix.c_str(),
-                                                            val.mPtr,
-                                                            player->mAnnouncePostfix.c_str());
+            const vcmpError result = _Func->SendGameMessage(id, player->mAnnounceStyle, "%s",
+                                SqAffixMessage(msg, player->mAnnouncePrefix, val, player->mAnnouncePostfix));
             // Validate the result
             if (result == vcmpErrorArgumentOutOfBounds)
             {
@@ -648,28 +861,26 @@ static SQInteger SqBroadcastAnnounceEx(HSQUIRRELVM vm)
         return val.mRes; // Propagate the error!
     }
 
-    // Obtain the ends of the entity pool
-    Core::Players::const_iterator itr = Core::Get().GetPlayers().cbegin();
-    Core::Players::const_iterator end = Core::Get().GetPlayers().cend();
+    // Obtain the player instances
+    const Core::Players & players = Core::Get().GetPlayers();
     // The number of players that the message was sent to
     Uint32 count = 0;
     // Currently processed player
     CPlayer * player = nullptr;
+    // Storage for messages with affixes
+    String msg;
 
-    // Process each entity in the pool
-    for (; itr != end; ++itr)
+    // Process each connected player
+    for (const Int32 id : Core::Get().GetActivePlayers())
     {
         // Grab the player instance
-        player = itr->mInst;
+        player = players[id].mInst;
         // Is this player instance valid?
-        if (VALID_ENTITYEX(itr->mID, SQMOD_PLAYER_POOL) && player != nullptr)
+        if (player != nullptr)
         {
             // Send the resulted announcement string
-            const vcmpError result = _Func->SendGameMessage(itr->mID, style,
-                                                            "%s%s%s",
-                                                            player->mAnnouncePrefix.c_str(),
-                                                            val.mPtr,
-                                                            player->mAnnouncePostfix.c_str());
+            const vcmpError result = _Func->SendGameMessage(id, style, "%s",
+                                SqAffixMessage(msg, player->mAnnouncePrefix, val, player->mAnnouncePostfix));
             // Validate the result
             if (result == vcmpErrorArgumentOutOfBounds)
             {
@@ -691,6 +902,383 @@ static SQInteger SqBroadcastAnnounceEx(HSQUIRRELVM vm)
     return 1;
 }
 
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBroadcastMsgTo(HSQUIRRELVM vm)
+{
+    const Int32 top = sq_gettop(vm);
+    // Was the broadcast filter specified?
+    if (top <= 1)
+    {
+        return sq_throwerror(vm, "Missing broadcast filter");
+    }
+
+    // The players that should receive the message
+    BroadcastPredicate pred;
+    // The index where the color should start
+    Int32 coloridx = 0;
+    // Attempt to extract the broadcast filter
+    SQRESULT res = SqGrabBroadcastFilter(vm, 2, pred, coloridx);
+    // Did we fail to identify the filter?
+    if (SQ_FAILED(res))
+    {
+        return res; // Propagate the error!
+    }
+    // Was the message color specified?
+    else if (top < coloridx)
+    {
+        return sq_throwerror(vm, "Missing message color");
+    }
+    // Was the message value specified?
+    else if (top <= coloridx)
+    {
+        return sq_throwerror(vm, "Missing message value");
+    }
+
+    // The index where the message should start
+    Int32 msgidx = coloridx;
+    // The message color
+    Uint32 color = 0;
+    // Attempt to identify and extract the color
+    res = SqGrabPlayerMessageColor(vm, coloridx, color, msgidx);
+    // Did we fail to identify a color?
+    if (SQ_FAILED(res))
+    {
+        return res; // Propagate the error!
+    }
+
+    // Attempt to generate the string value
+    StackStrF val(vm, msgidx);
+    // Have we failed to retrieve the string?
+    if (SQ_FAILED(val.Proc(true)))
+    {
+        return val.mRes; // Propagate the error!
+    }
+
+    // Storage for messages with affixes
+    String msg;
+    // Send the message to the selected players
+    return SqBroadcastEach(vm, pred, [&](Int32 id, const CPlayer & player) -> SQRESULT {
+        // Send the resulted message string
+        const vcmpError result = _Func->SendClientMessage(id, color, "%s",
+                                    SqAffixMessage(msg, player.mMessagePrefix, val, player.mMessagePostfix));
+        // Check the result
+        if (result == vcmpErrorTooLargeInput)
+        {
+            return sq_throwerror(vm, ToStrF("Client message too big [%s]", player.GetTag().c_str()));
+        }
+        // The message was sent
+        return SQ_OK;
+    });
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBroadcastMessageTo(HSQUIRRELVM vm)
+{
+    const Int32 top = sq_gettop(vm);
+    // Was the broadcast filter specified?
+    if (top <= 1)
+    {
+        return sq_throwerror(vm, "Missing broadcast filter");
+    }
+
+    // The players that should receive the message
+    BroadcastPredicate pred;
+    // The index where the message should start
+    Int32 msgidx = 0;
+    // Attempt to extract the broadcast filter
+    const SQRESULT res = SqGrabBroadcastFilter(vm, 2, pred, msgidx);
+    // Did we fail to identify the filter?
+    if (SQ_FAILED(res))
+    {
+        return res; // Propagate the error!
+    }
+    // Was the message value specified?
+    else if (top < msgidx)
+    {
+        return sq_throwerror(vm, "Missing message value");
+    }
+
+    // Attempt to generate the string value
+    StackStrF val(vm, msgidx);
+    // Have we failed to retrieve the string?
+    if (SQ_FAILED(val.Proc(true)))
+    {
+        return val.mRes; // Propagate the error!
+    }
+
+    // Storage for messages with affixes
+    String msg;
+    // Send the message to the selected players
+    return SqBroadcastEach(vm, pred, [&](Int32 id, const CPlayer & player) -> SQRESULT {
+        // Send the resulted message string
+        const vcmpError result = _Func->SendClientMessage(id, player.mMessageColor, "%s",
+                                    SqAffixMessage(msg, player.mMessagePrefix, val, player.mMessagePostfix));
+        // Check the result
+        if (result == vcmpErrorTooLargeInput)
+        {
+            return sq_throwerror(vm, ToStrF("Client message too big [%s]", player.GetTag().c_str()));
+        }
+        // The message was sent
+        return SQ_OK;
+    });
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBroadcastAnnounceTo(HSQUIRRELVM vm)
+{
+    const Int32 top = sq_gettop(vm);
+    // Was the broadcast filter specified?
+    if (top <= 1)
+    {
+        return sq_throwerror(vm, "Missing broadcast filter");
+    }
+
+    // The players that should receive the announcement
+    BroadcastPredicate pred;
+    // The index where the announcement should start
+    Int32 msgidx = 0;
+    // Attempt to extract the broadcast filter
+    const SQRESULT res = SqGrabBroadcastFilter(vm, 2, pred, msgidx);
+    // Did we fail to identify the filter?
+    if (SQ_FAILED(res))
+    {
+        return res; // Propagate the error!
+    }
+    // Was the announcement value specified?
+    else if (top < msgidx)
+    {
+        return sq_throwerror(vm, "Missing announcement value");
+    }
+
+    // Attempt to generate the string value
+    StackStrF val(vm, msgidx);
+    // Have we failed to retrieve the string?
+    if (SQ_FAILED(val.Proc(true)))
+    {
+        return val.mRes; // Propagate the error!
+    }
+
+    // Storage for announcements with affixes
+    String msg;
+    // Send the announcement to the selected players
+    return SqBroadcastEach(vm, pred, [&](Int32 id, const CPlayer & player) -> SQRESULT {
+        // Send the resulted announcement string
+        const vcmpError result = _Func->SendGameMessage(id, player.mAnnounceStyle, "%s",
+                                    SqAffixMessage(msg, player.mAnnouncePrefix, val, player.mAnnouncePostfix));
+        // Validate the result
+        if (result == vcmpErrorArgumentOutOfBounds)
+        {
+            return sq_throwerror(vm, ToStrF("Invalid announcement style %d [%s]",
+                                            player.mAnnounceStyle, player.GetTag().c_str()));
+        }
+        else if (result == vcmpErrorTooLargeInput)
+        {
+            return sq_throwerror(vm, ToStrF("Game message too big [%s]", player.GetTag().c_str()));
+        }
+        // The announcement was sent
+        return SQ_OK;
+    });
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Attempt to extract the client script data from the buffer at the specified stack index. The data
+ * is wrapped into a block only once, when enabled, so that every player receives the same payload.
+*/
+static SQRESULT SqGrabBroadcastData(HSQUIRRELVM vm, Int32 idx, Buffer & block, CCStr & data, Uint32 & size)
+{
+    const SqBuffer * buffer = nullptr;
+    // Attempt to extract the buffer instance
+    try
+    {
+        buffer = Var< const SqBuffer * >(vm, idx).value;
+        // Is there a buffer to send?
+        if (buffer == nullptr)
+        {
+            return sq_throwerror(vm, "Invalid stream buffer");
+        }
+        // Validate the specified buffer
+        buffer->ValidateDeeper();
+    }
+    catch (const Sqrat::Exception & e)
+    {
+        return sq_throwerror(vm, e.what());
+    }
+    // Validate the buffer cursor
+    if (!buffer->GetRef()->Position())
+    {
+        return sq_throwerror(vm, "Cannot send empty stream buffer");
+    }
+    // Should the data be sent as is?
+    else if (!Core::Get().CompressSends())
+    {
+        data = buffer->GetRef()->Data();
+        size = buffer->GetRef()->Position();
+    }
+    else
+    {
+        // Wrap the data into a block once for all players
+        CompressBlock(block, buffer->GetRef()->Data(), buffer->GetRef()->Position(),
+                        Core::Get().CompressThreshold());
+        data = block.Data();
+        size = block.Position();
+    }
+    // At this point we've extracted the data
+    return SQ_OK;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Send client script data to the specified player.
+*/
+static inline SQRESULT SqSendBroadcastData(HSQUIRRELVM vm, Int32 id, CCStr data, Uint32 size)
+{
+    // Attempt to send the stream buffer contents
+    const vcmpError result = _Func->SendClientScriptData(id, data, size);
+    // Check for errors
+    if (result == vcmpErrorTooLargeInput)
+    {
+        return sq_throwerror(vm, "Stream buffer is too big");
+    }
+    // The data was sent
+    return SQ_OK;
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBroadcastData(HSQUIRRELVM vm)
+{
+    const Int32 top = sq_gettop(vm);
+    // Was the stream buffer specified?
+    if (top <= 1)
+    {
+        return sq_throwerror(vm, "Missing stream buffer");
+    }
+    // Was the broadcast filter specified?
+    else if (top <= 2)
+    {
+        return sq_throwerror(vm, "Missing broadcast filter");
+    }
+
+    // The data that should be sent
+    Buffer block;
+    CCStr data = nullptr;
+    Uint32 size = 0;
+    // Attempt to extract the data
+    SQRESULT res = SqGrabBroadcastData(vm, 2, block, data, size);
+    // Did we fail to extract the data?
+    if (SQ_FAILED(res))
+    {
+        return res; // Propagate the error!
+    }
+
+    // The players that should receive the data
+    BroadcastPredicate pred;
+    // The index after the filter isn't used by anything
+    Int32 next = 0;
+    // Attempt to extract the broadcast filter
+    res = SqGrabBroadcastFilter(vm, 3, pred, next);
+    // Did we fail to identify the filter?
+    if (SQ_FAILED(res))
+    {
+        return res; // Propagate the error!
+    }
+
+    // Send the data to the selected players
+    return SqBroadcastEach(vm, pred, [&](Int32 id, const CPlayer & /*player*/) -> SQRESULT {
+        return SqSendBroadcastData(vm, id, data, size);
+    });
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBroadcastDataTo(HSQUIRRELVM vm)
+{
+    const Int32 top = sq_gettop(vm);
+    // Was the stream buffer specified?
+    if (top <= 1)
+    {
+        return sq_throwerror(vm, "Missing stream buffer");
+    }
+    // Was the list of players specified?
+    else if (top <= 2)
+    {
+        return sq_throwerror(vm, "Missing player list");
+    }
+    // Is the list of players an array?
+    else if (sq_gettype(vm, 3) != OT_ARRAY)
+    {
+        return sq_throwerror(vm, "Player list must be an array of players or player identifiers");
+    }
+
+    // The data that should be sent
+    Buffer block;
+    CCStr data = nullptr;
+    Uint32 size = 0;
+    // Attempt to extract the data
+    const SQRESULT res = SqGrabBroadcastData(vm, 2, block, data, size);
+    // Did we fail to extract the data?
+    if (SQ_FAILED(res))
+    {
+        return res; // Propagate the error!
+    }
+
+    // Grab the player instances
+    const Core::Players & players = Core::Get().GetPlayers();
+    // The number of players that the data was sent to
+    Uint32 count = 0;
+    // Push a null iterator on the stack
+    sq_pushnull(vm);
+    // Process each element in the array
+    while (SQ_SUCCEEDED(sq_next(vm, 3)))
+    {
+        Int32 id = -1;
+        // Is this a player identifier?
+        if (sq_gettype(vm, -1) == OT_INTEGER)
+        {
+            id = ConvTo< Int32 >::From(PopStackInteger(vm, -1));
+        }
+        // Is this something other than a player instance?
+        else if (sq_gettype(vm, -1) != OT_INSTANCE)
+        {
+            return sq_throwerror(vm, "Player list must contain only players or player identifiers");
+        }
+        // Attempt to treat it as a player instance
+        else
+        {
+            try
+            {
+                const CPlayer * player = Var< const CPlayer * >(vm, -1).value;
+                // Is this a valid player instance?
+                if (player != nullptr)
+                {
+                    id = player->GetID();
+                }
+            }
+            catch (const Sqrat::Exception & e)
+            {
+                return sq_throwerror(vm, e.what());
+            }
+        }
+        // Pop the key and value from the stack
+        sq_pop(vm, 2);
+        // Players that are not connected are skipped
+        if (id < 0 || static_cast< size_t >(id) >= players.size() || players[id].mInst == nullptr)
+        {
+            continue;
+        }
+        // Attempt to send the data to this player
+        else if (SQ_FAILED(SqSendBroadcastData(vm, id, data, size)))
+        {
+            return SQ_ERROR; // Propagate the error!
+        }
+        // Add this player to the count
+        ++count;
+    }
+    // Pop the iterator from the stack
+    sq_settop(vm, top);
+    // Push the count count on the stack
+    sq_pushinteger(vm, count);
+    // Specify that this function returned a value
+    return 1;
+}
+
 // ================================================================================================
 void Register_Broadcast(HSQUIRRELVM vm)
 {
@@ -704,9 +1292,24 @@ void Register_Broadcast(HSQUIRRELVM vm)
     .SquirrelFunc(_SC("Announce"), &SqBroadcastAnnounce)
     .SquirrelFunc(_SC("AnnounceEx"), &SqBroadcastAnnounceEx)
     .SquirrelFunc(_SC("Text"), &SqBroadcastAnnounce)
-    .SquirrelFunc(_SC("TextEx"), &SqBroadcastAnnounceEx);
+    .SquirrelFunc(_SC("TextEx"), &SqBroadcastAnnounceEx)
+    .SquirrelFunc(_SC("MsgTo"), &SqBroadcastMsgTo)
+    .SquirrelFunc(_SC("MessageTo"), &SqBroadcastMessageTo)
+    .SquirrelFunc(_SC("AnnounceTo"), &SqBroadcastAnnounceTo)
+    .SquirrelFunc(_SC("TextTo"), &SqBroadcastAnnounceTo)
+    .SquirrelFunc(_SC("Data"), &SqBroadcastData)
+    .SquirrelFunc(_SC("DataTo"), &SqBroadcastDataTo);
 
     RootTable(vm).Bind(_SC("SqBroadcast"), bns);
+
+    ConstTable(vm).Enum(_SC("SqBroadcastFilter"), Enumeration(vm)
+        .Const(_SC("All"),          BCF_ALL)
+        .Const(_SC("World"),        BCF_WORLD)
+        .Const(_SC("Team"),         BCF_TEAM)
+        .Const(_SC("Admin"),        BCF_ADMIN)
+        .Const(_SC("Mask"),         BCF_MASK)
+        .Const(_SC("Streamed"),     BCF_STREAMED)
+    );
 }
 
 } // Namespace:: SqMod
@@ -207,6 +207,7 @@ static const EnumElement g_EventEnum[] = {
     {_SC("ServerOption"),               EVT_SERVEROPTION},
     {_SC("ScriptReload"),               EVT_SCRIPTRELOAD},
     {_SC("ScriptLoaded"),               EVT_SCRIPTLOADED},
+    {_SC("ScriptReloaded"),             EVT_SCRIPTRELOADED},
     {_SC("Max"),                        EVT_MAX}
 };
 
@@ -1,6 +1,7 @@
 // ------------------------------------------------------------------------------------------------
 #include "Misc/Player.hpp"
 #include "Base/Color3.hpp"
+#include "Base/StrCache.hpp"
 #include "Core.hpp"
 
 // ------------------------------------------------------------------------------------------------
@@ -95,18 +96,30 @@ static String CS_Skin_Names[] = {
     /* 160 */ ""
 };
 
+// ------------------------------------------------------------------------------------------------
+static StrCache CS_Skin_Name_Cache(161); // Script strings of the skin names.
+
 // ------------------------------------------------------------------------------------------------
 CCStr GetSkinName(Uint32 id)
 {
     return (id > 159) ? _SC("") : CS_Skin_Names[id].c_str();
 }
 
+// ------------------------------------------------------------------------------------------------
+const LightObj & GetSkinNameObj(Uint32 id)
+{
+    // All unknown skins share the empty name
+    return CS_Skin_Name_Cache.Get(std::min(id, 160u), GetSkinName(id));
+}
+
 // ------------------------------------------------------------------------------------------------
 void SetSkinName(Uint32 id, StackStrF & name)
 {
     if (id <= 159)
     {
         CS_Skin_Names[id].assign(name.mPtr);
+        // The script string of the previous name is no longer valid
+        CS_Skin_Name_Cache.Forget(id);
     }
 }
 
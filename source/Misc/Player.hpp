@@ -12,6 +12,11 @@ namespace SqMod {
 */
 CCStr GetSkinName(Uint32 id);
 
+/* ------------------------------------------------------------------------------------------------
+ * Retrieve the name associated with a skin model identifier as a script string.
+*/
+const LightObj & GetSkinNameObj(Uint32 id);
+
 /* ------------------------------------------------------------------------------------------------
  * Modify the name associated with a skin model identifier.
 */
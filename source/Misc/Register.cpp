@@ -23,6 +23,7 @@ extern SQInteger Player_ExistsAuto(HSQUIRRELVM vm);
 
 // ------------------------------------------------------------------------------------------------
 extern void Register_Broadcast(HSQUIRRELVM vm);
+extern void Register_Replicated(HSQUIRRELVM vm);
 
 // ================================================================================================
 void Register_Misc(HSQUIRRELVM vm)
@@ -134,16 +135,16 @@ void Register_Misc(HSQUIRRELVM vm)
     .FmtFunc(_SC("SetModelName"), &SetModelName)
     .Func(_SC("IsModelWeapon"), &IsModelWeapon)
     .Func(_SC("IsModelActuallyWeapon"), &IsModelActuallyWeapon)
-    .Func(_SC("GetSkinName"), &GetSkinName)
+    .Func(_SC("GetSkinName"), &GetSkinNameObj)
     .FmtFunc(_SC("SetSkinName"), &SetSkinName)
     .FmtFunc(_SC("GetSkinID"), &GetSkinID)
     .Func(_SC("IsSkinValid"), &IsSkinValid)
-    .Func(_SC("GetAutomobileName"), &GetAutomobileName)
+    .Func(_SC("GetAutomobileName"), &GetAutomobileNameObj)
     .FmtFunc(_SC("SetAutomobileName"), &SetAutomobileName)
     .FmtFunc(_SC("GetAutomobileID"), &GetAutomobileID)
     .Func(_SC("IsAutomobileValid"), &IsAutomobileValid)
     .Func(_SC("GetWeaponSlot"), &GetWeaponSlot)
-    .Func(_SC("GetWeaponName"), &GetWeaponName)
+    .Func(_SC("GetWeaponName"), &GetWeaponNameObj)
     .FmtFunc(_SC("SetWeaponName"), &SetWeaponName)
     .Func(_SC("GetCustomWeaponNamePoolSize"), &GetCustomWeaponNamePoolSize)
     .Func(_SC("ClearCustomWeaponNamePool"), &ClearCustomWeaponNamePool)
@@ -158,6 +159,7 @@ void Register_Misc(HSQUIRRELVM vm)
     .Func(_SC("CreateExplosionEx"), &CreateExplosionEx);
 
     Register_Broadcast(vm);
+    Register_Replicated(vm);
 }
 
 } // Namespace:: SqMod
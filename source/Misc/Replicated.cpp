@@ -0,0 +1,356 @@
+// ------------------------------------------------------------------------------------------------
+#include "Misc/Replicated.hpp"
+#include "Library/Utils/Buffer.hpp"
+#include "Entity/Player.hpp"
+#include "Core.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstring>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+SQMODE_DECL_TYPENAME(Typename, _SC("SqReplicatedState"))
+
+// ------------------------------------------------------------------------------------------------
+SqReplicatedState::Instances SqReplicatedState::s_Instances;
+
+// ------------------------------------------------------------------------------------------------
+void CleanupReplicated(Int32 id)
+{
+    SqReplicatedState::ForgetPlayer(id);
+}
+
+// ------------------------------------------------------------------------------------------------
+SqReplicatedState::SqReplicatedState(SQInteger header, CSStr layout)
+    : m_Layout(*SqBufferLayout::Acquire(layout))
+    , m_Fields(static_cast< size_t >(m_Layout.GetCount()), Field{String(), 0})
+    , m_Stamps()
+    , m_Generation(0)
+    , m_Header(ConvTo< Uint32 >::From(header))
+    , m_Buffer(64)
+    , m_Encoded(0)
+{
+    // Nothing was sent to anyone yet
+    std::fill(m_Stamps, m_Stamps + SQMOD_PLAYER_POOL, 0);
+    // Make sure we find out when players disconnect
+    s_Instances.push_back(this);
+}
+
+// ------------------------------------------------------------------------------------------------
+SqReplicatedState::~SqReplicatedState()
+{
+    s_Instances.erase(std::remove(s_Instances.begin(), s_Instances.end(), this), s_Instances.end());
+}
+
+// ------------------------------------------------------------------------------------------------
+void SqReplicatedState::ForgetPlayer(Int32 id)
+{
+    // Is the identifier valid?
+    if (INVALID_ENTITYEX(id, SQMOD_PLAYER_POOL))
+    {
+        return;
+    }
+    // The next player with this identifier must receive everything
+    for (auto * inst : s_Instances)
+    {
+        inst->m_Stamps[id] = 0;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+SqReplicatedState::SzType SqReplicatedState::GetField(HSQUIRRELVM vm, SQInteger idx) const
+{
+    SQInteger field = -1;
+    // Is the field specified by name?
+    if (sq_gettype(vm, idx) == OT_STRING)
+    {
+        CSStr name = nullptr;
+        // Retrieve the name of the field
+        sq_getstring(vm, idx, &name);
+        // Look for a field with this name
+        field = m_Layout.FieldIndex(name);
+        // Was there such field?
+        if (field < 0)
+        {
+            STHROWF("Unknown replicated field (%s)", name);
+        }
+    }
+    else
+    {
+        field = PopStackInteger(vm, idx);
+        // Is the index within range?
+        if (field < 0 || field >= m_Layout.GetCount())
+        {
+            STHROWF("Replicated field index (%lld) is out of range", static_cast< Int64 >(field));
+        }
+    }
+    // Return the index of the field
+    return static_cast< SzType >(field);
+}
+
+// ------------------------------------------------------------------------------------------------
+void SqReplicatedState::Encode(Uint32 stamp)
+{
+    // Was the message for this generation already encoded?
+    if (m_Encoded == stamp && m_Buffer.Position())
+    {
+        return;
+    }
+    // Count the fields which changed after the specified generation
+    Uint32 count = 0;
+    for (const auto & f : m_Fields)
+    {
+        if (f.mStamp > stamp)
+        {
+            ++count;
+        }
+    }
+    // Start a new message
+    m_Buffer.Move(0);
+    EncodeVarUint(m_Buffer, m_Header);
+    EncodeVarUint(m_Buffer, count);
+    // Write the fields which changed
+    for (Fields::const_iterator itr = m_Fields.cbegin(); itr != m_Fields.cend(); ++itr)
+    {
+        if (itr->mStamp > stamp)
+        {
+            EncodeVarUint(m_Buffer, static_cast< Uint64 >(itr - m_Fields.cbegin()));
+            m_Buffer.Append(itr->mData.data(), static_cast< SzType >(itr->mData.size()));
+        }
+    }
+    // Remember which message is in the buffer
+    m_Encoded = stamp;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool SqReplicatedState::Send(Int32 id)
+{
+    const Uint32 stamp = m_Stamps[id];
+    // Is the player up to date?
+    if (stamp >= m_Generation)
+    {
+        return false;
+    }
+    // Encode the changes since the last time
+    Encode(stamp);
+    // Attempt to send the message
+    const vcmpError result = CPlayer::SendClientData(id, m_Buffer.Data(), m_Buffer.Position());
+    // Check for errors
+    if (result == vcmpErrorTooLargeInput)
+    {
+        STHROWF("Replicated state changes are too big");
+    }
+    // Was the message not delivered? (ex: the player disconnected)
+    else if (result != vcmpErrorNone)
+    {
+        return false; // Try again on the next sync
+    }
+    // The player is now up to date
+    m_Stamps[id] = m_Generation;
+    // Something was sent
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger SqReplicatedState::SetField(HSQUIRRELVM vm)
+{
+    const Int32 top = sq_gettop(vm);
+    // Was the field specified?
+    if (top <= 1)
+    {
+        return sq_throwerror(vm, "Missing replicated field");
+    }
+    // Was the value specified?
+    else if (top <= 2)
+    {
+        return sq_throwerror(vm, "Missing replicated field value");
+    }
+    // Attempt to change the value
+    try
+    {
+        SqReplicatedState * inst = Var< SqReplicatedState * >(vm, 1).value;
+        // Do we have a valid instance?
+        if (!inst)
+        {
+            return sq_throwerror(vm, "Invalid replicated state instance");
+        }
+        // Identify the field
+        const SzType idx = inst->GetField(vm, 2);
+        // Encode the new value
+        Buffer & b = inst->m_Buffer;
+        b.Move(0);
+        inst->m_Layout.PackAt(vm, 3, idx, b);
+        // The buffer no longer holds a message
+        inst->m_Encoded = 0;
+        // Did the value change?
+        Field & f = inst->m_Fields[idx];
+        const bool changed = !f.mStamp || f.mData.size() != b.Position() ||
+                                std::memcmp(f.mData.data(), b.Data(), b.Position()) != 0;
+        // Store the new value and stamp it
+        if (changed)
+        {
+            f.mData.assign(b.Data(), b.Position());
+            f.mStamp = ++(inst->m_Generation);
+        }
+        // Discard the encoded value
+        b.Move(0);
+        // Let the script know whether the value changed
+        sq_pushbool(vm, changed);
+    }
+    catch (const Sqrat::Exception & e)
+    {
+        return sq_throwerror(vm, e.what());
+    }
+    catch (const std::exception & e)
+    {
+        return sq_throwerror(vm, e.what());
+    }
+    // Specify that we have a value on the stack
+    return 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger SqReplicatedState::GetFieldValue(HSQUIRRELVM vm)
+{
+    // Was the field specified?
+    if (sq_gettop(vm) <= 1)
+    {
+        return sq_throwerror(vm, "Missing replicated field");
+    }
+    // Attempt to retrieve the value
+    try
+    {
+        const SqReplicatedState * inst = Var< const SqReplicatedState * >(vm, 1).value;
+        // Do we have a valid instance?
+        if (!inst)
+        {
+            return sq_throwerror(vm, "Invalid replicated state instance");
+        }
+        // Identify the field
+        const SzType idx = inst->GetField(vm, 2);
+        const Field & f = inst->m_Fields[idx];
+        // Was the value ever set?
+        if (!f.mStamp)
+        {
+            sq_pushnull(vm);
+        }
+        else
+        {
+            SzType cur = 0;
+            // Decode the value
+            inst->m_Layout.UnpackAt(vm, idx, f.mData.data(), static_cast< SzType >(f.mData.size()), cur);
+        }
+    }
+    catch (const Sqrat::Exception & e)
+    {
+        return sq_throwerror(vm, e.what());
+    }
+    catch (const std::exception & e)
+    {
+        return sq_throwerror(vm, e.what());
+    }
+    // Specify that we have a value on the stack
+    return 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger SqReplicatedState::GetPending(CPlayer & player) const
+{
+    // Is the specified player even valid?
+    if (!player.IsActive())
+    {
+        STHROWF("Invalid player argument: null");
+    }
+    // Grab the generation last sent to this player
+    const Uint32 stamp = m_Stamps[player.GetID()];
+    // Count the fields which changed since then
+    SQInteger count = 0;
+    for (const auto & f : m_Fields)
+    {
+        if (f.mStamp > stamp)
+        {
+            ++count;
+        }
+    }
+    // Return the requested information
+    return count;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool SqReplicatedState::Sync(CPlayer & player)
+{
+    // Is the specified player even valid?
+    if (!player.IsActive())
+    {
+        STHROWF("Invalid player argument: null");
+    }
+    // Send the changes, if any
+    return Send(player.GetID());
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger SqReplicatedState::SyncAll()
+{
+    // The number of players that received the changes
+    SQInteger count = 0;
+    // Process each connected player
+    for (const Int32 id : Core::Get().GetActivePlayers())
+    {
+        // Did this player receive anything?
+        if (Send(id))
+        {
+            ++count;
+        }
+    }
+    // Return the number of players that received the changes
+    return count;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SqReplicatedState::Invalidate(CPlayer & player)
+{
+    // Is the specified player even valid?
+    if (!player.IsActive())
+    {
+        STHROWF("Invalid player argument: null");
+    }
+    // Send everything on the next sync
+    m_Stamps[player.GetID()] = 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SqReplicatedState::InvalidateAll()
+{
+    std::fill(m_Stamps, m_Stamps + SQMOD_PLAYER_POOL, 0);
+}
+
+// ================================================================================================
+void Register_Replicated(HSQUIRRELVM vm)
+{
+    RootTable(vm).Bind(Typename::Str,
+        Class< SqReplicatedState, NoCopy< SqReplicatedState > >(vm, Typename::Str)
+        // Constructors
+        .Ctor< SQInteger, CSStr >()
+        // Core Meta-methods
+        .SquirrelFunc(_SC("_typename"), &Typename::Fn)
+        .Func(_SC("_tostring"), &SqReplicatedState::ToString)
+        // Properties
+        .Prop(_SC("Header"), &SqReplicatedState::GetHeader)
+        .Prop(_SC("Layout"), &SqReplicatedState::GetLayout)
+        .Prop(_SC("Count"), &SqReplicatedState::GetCount)
+        .Prop(_SC("Generation"), &SqReplicatedState::GetGeneration)
+        // Member Methods
+        .Func(_SC("Pending"), &SqReplicatedState::GetPending)
+        .Func(_SC("Sync"), &SqReplicatedState::Sync)
+        .Func(_SC("SyncAll"), &SqReplicatedState::SyncAll)
+        .Func(_SC("Invalidate"), &SqReplicatedState::Invalidate)
+        .Func(_SC("InvalidateAll"), &SqReplicatedState::InvalidateAll)
+        .SquirrelFunc(_SC("Set"), &SqReplicatedState::SetField)
+        .SquirrelFunc(_SC("Get"), &SqReplicatedState::GetFieldValue)
+    );
+}
+
+} // Namespace:: SqMod
@@ -0,0 +1,189 @@
+#ifndef _MISC_REPLICATED_HPP_
+#define _MISC_REPLICATED_HPP_
+
+// ------------------------------------------------------------------------------------------------
+#include "Base/Shared.hpp"
+#include "Library/Utils/Layout.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <vector>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Set of values described by a buffer layout which is replicated to players through client script
+ * data. Every change is stamped with a generation number and each player remembers the generation
+ * it last received, so only the fields that changed since then are sent. Players that are at the
+ * same generation receive the same message, which is encoded only once.
+ *
+ * Message format: the header as a variable length integer, the number of fields that follow as a
+ * variable length integer and then, for each field, its index as a variable length integer and its
+ * value as described by the layout.
+*/
+class SqReplicatedState
+{
+public:
+
+    // --------------------------------------------------------------------------------------------
+    typedef SqBufferLayout::SzType  SzType; // The type used to represent size in general.
+
+private:
+
+    /* --------------------------------------------------------------------------------------------
+     * Current value of a single field.
+    */
+    struct Field
+    {
+        String      mData; // The encoded value of the field.
+        Uint32      mStamp; // The generation when the value last changed. (0 if never set)
+    };
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::vector< Field > Fields; // List of field values.
+    typedef std::vector< SqReplicatedState * > Instances; // List of existing instances.
+
+    // --------------------------------------------------------------------------------------------
+    static Instances    s_Instances; // All existing instances, used to forget disconnected players.
+
+    // --------------------------------------------------------------------------------------------
+    SqBufferLayout      m_Layout; // The layout which describes the fields.
+    Fields              m_Fields; // The current values of the fields.
+    Uint32              m_Stamps[SQMOD_PLAYER_POOL]; // The generation last sent to each player.
+    Uint32              m_Generation; // The generation of the most recent change.
+    Uint32              m_Header; // Value written at the beginning of each message.
+    Buffer              m_Buffer; // Buffer used to encode values and messages.
+    Uint32              m_Encoded; // The generation that the message in the buffer starts from.
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the index of the field specified at the given stack index, by index or name.
+    */
+    SzType GetField(HSQUIRRELVM vm, SQInteger idx) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Encode the fields which changed after the specified generation into the internal buffer.
+    */
+    void Encode(Uint32 stamp);
+
+    /* --------------------------------------------------------------------------------------------
+     * Send the changes to the specified player, if any. Returns whether anything was sent. The
+     * player is only considered up to date if the server accepted the message.
+    */
+    bool Send(Int32 id);
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Forget what was sent to the specified player. Used when the player disconnects.
+    */
+    static void ForgetPlayer(Int32 id);
+
+    /* --------------------------------------------------------------------------------------------
+     * Script function which changes the value of a field. Returns whether the value changed.
+    */
+    static SQInteger SetField(HSQUIRRELVM vm);
+
+    /* --------------------------------------------------------------------------------------------
+     * Script function which retrieves the value of a field or null if it was never set.
+    */
+    static SQInteger GetFieldValue(HSQUIRRELVM vm);
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor.
+    */
+    SqReplicatedState(SQInteger header, CSStr layout);
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor. (disabled)
+    */
+    SqReplicatedState(const SqReplicatedState & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move constructor. (disabled)
+    */
+    SqReplicatedState(SqReplicatedState && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Destructor.
+    */
+    ~SqReplicatedState();
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator. (disabled)
+    */
+    SqReplicatedState & operator = (const SqReplicatedState & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move assignment operator. (disabled)
+    */
+    SqReplicatedState & operator = (SqReplicatedState && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Used by the script engine to convert an instance of this type to a string.
+    */
+    const String & ToString() const
+    {
+        return m_Layout.GetLayout();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the value written at the beginning of each message.
+    */
+    SQInteger GetHeader() const
+    {
+        return static_cast< SQInteger >(m_Header);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the description of the layout which describes the fields.
+    */
+    const String & GetLayout() const
+    {
+        return m_Layout.GetLayout();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of fields.
+    */
+    SQInteger GetCount() const
+    {
+        return m_Layout.GetCount();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the generation of the most recent change.
+    */
+    SQInteger GetGeneration() const
+    {
+        return static_cast< SQInteger >(m_Generation);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of fields that changed since the last time they were sent to a player.
+    */
+    SQInteger GetPending(CPlayer & player) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Send the changes to the specified player. Returns whether anything was sent.
+    */
+    bool Sync(CPlayer & player);
+
+    /* --------------------------------------------------------------------------------------------
+     * Send the changes to every connected player. Returns the number of players that received them.
+    */
+    SQInteger SyncAll();
+
+    /* --------------------------------------------------------------------------------------------
+     * Make sure every field that was set is sent again to the specified player on the next sync.
+    */
+    void Invalidate(CPlayer & player);
+
+    /* --------------------------------------------------------------------------------------------
+     * Make sure every field that was set is sent again to every player on the next sync.
+    */
+    void InvalidateAll();
+};
+
+} // Namespace:: SqMod
+
+#endif // _MISC_REPLICATED_HPP_
@@ -731,6 +731,20 @@ public:
         const AutoAssign< Scope * > aa(m_Scope, scope.mParent, &scope);
         // Grab the default virtual machine
         HSQUIRRELVM vm = DefaultVM::Get();
+        // Remove the converted parameters from the stack when done
+        const StackGuard sg(vm);
+        // Make room for the parameters and what each slot pushes on top of them
+        sq_reservestack(vm, 2 + 2 * sizeof...(Args));
+        // Convert the given parameters only once and keep them on the stack
+        PushParameters(args...);
+        // Objects of the converted parameters (one extra to avoid an empty array)
+        HSQOBJECT params[sizeof...(Args) + 1];
+        // Retrieve the parameter objects so they can be pushed again for each slot
+        const SQInteger base = sq_gettop(vm) - static_cast< SQInteger >(sizeof...(Args)) + 1;
+        for (std::size_t n = 0; n < sizeof...(Args); ++n)
+        {
+            sq_getstackobj(vm, base + static_cast< SQInteger >(n), &params[n]);
+        }
         // Process the slots from this scope
         while (scope.mItr != scope.mEnd)
         {
@@ -747,8 +761,11 @@ public:
             {
                 sq_pushobject(vm, slot.mThisRef);
             }
-            // Push the given parameters on the stack
-            PushParameters(args...);
+            // Push the converted parameters on the stack
+            for (std::size_t n = 0; n < sizeof...(Args); ++n)
+            {
+                sq_pushobject(vm, params[n]);
+            }
             // Make the function call and store the result
             const SQRESULT res = sq_call(vm, 1 + sizeof...(Args), false, ErrorHandling::IsEnabled());
             // Pop the callback object from the stack
@@ -1,6 +1,7 @@
 // ------------------------------------------------------------------------------------------------
 #include "Misc/Vehicle.hpp"
 #include "Base/Shared.hpp"
+#include "Base/StrCache.hpp"
 
 // ------------------------------------------------------------------------------------------------
 #include <cstring>
@@ -82,6 +83,17 @@ struct InitCustomVehicleNames
     }
 } g_InitCustomVehicleNames{};
 
+// ------------------------------------------------------------------------------------------------
+static StrCache CS_Vehicle_Name_Cache(207); // Script strings of the standard and custom names.
+
+/* ------------------------------------------------------------------------------------------------
+ * Retrieve the position of a valid vehicle model identifier in the cache of names.
+*/
+static inline Uint32 VehicleNameSlot(Uint32 id)
+{
+    return (id < 237) ? (id - 130) : (id - 6400 + 107);
+}
+
 // ------------------------------------------------------------------------------------------------
 String GetAutomobileName(Uint32 id)
 {
@@ -101,6 +113,15 @@ String GetAutomobileName(Uint32 id)
     return NullString();
 }
 
+// ------------------------------------------------------------------------------------------------
+const LightObj & GetAutomobileNameObj(Uint32 id)
+{
+    // Validate the identifier before it's used to find the cached name
+    const String & name = GetAutomobileName(id);
+    // Retrieve the cached name or create it
+    return CS_Vehicle_Name_Cache.Get(VehicleNameSlot(id), name.c_str(), static_cast< SQInteger >(name.size()));
+}
+
 // ------------------------------------------------------------------------------------------------
 void SetAutomobileName(Uint32 id, StackStrF & name)
 {
@@ -116,6 +137,8 @@ void SetAutomobileName(Uint32 id, StackStrF & name)
     {
         STHROWF("Vehicle identifier breaks these demands (%u > 129 and %u < 237) or (%u > 6399 and %u < 6500)", id, id, id, id);
     }
+    // The script string of the previous name is no longer valid
+    CS_Vehicle_Name_Cache.Forget(VehicleNameSlot(id));
 }
 
 // ------------------------------------------------------------------------------------------------
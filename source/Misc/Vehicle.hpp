@@ -12,6 +12,11 @@ namespace SqMod {
 */
 String GetAutomobileName(Uint32 id);
 
+/* ------------------------------------------------------------------------------------------------
+ * Retrieve the name associated with a vehicle model identifier as a script string.
+*/
+const LightObj & GetAutomobileNameObj(Uint32 id);
+
 /* ------------------------------------------------------------------------------------------------
  * Modify the name associated with a vehicle model identifier.
 */
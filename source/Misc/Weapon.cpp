@@ -1,6 +1,7 @@
 // ------------------------------------------------------------------------------------------------
 #include "Misc/Weapon.hpp"
 #include "Base/Shared.hpp"
+#include "Base/StrCache.hpp"
 
 // ------------------------------------------------------------------------------------------------
 #include <cstring>
@@ -52,6 +53,9 @@ static String CS_Weapon_Names[] = {
 /// Fall back for custom weapon names.
 static std::unordered_map<Uint32, String> CS_Custom_Weapon_Names{};
 
+// ------------------------------------------------------------------------------------------------
+static StrCache CS_Weapon_Name_Cache(256); // Script strings of the weapon names.
+
 // ------------------------------------------------------------------------------------------------
 static inline bool IsCustomWeapon(Uint32 id)
 {
@@ -131,6 +135,12 @@ CCStr GetWeaponName(Uint32 id)
     return _SC("");
 }
 
+// ------------------------------------------------------------------------------------------------
+const LightObj & GetWeaponNameObj(Uint32 id)
+{
+    return CS_Weapon_Name_Cache.Get(id, GetWeaponName(id));
+}
+
 // ------------------------------------------------------------------------------------------------
 void SetWeaponName(Uint32 id, StackStrF & name)
 {
@@ -145,6 +155,8 @@ void SetWeaponName(Uint32 id, StackStrF & name)
 		// Attempt to insert or update the name into the standard weapon table
         CS_Weapon_Names[id].assign(name.mPtr);
 	}
+    // The script string of the previous name is no longer valid
+    CS_Weapon_Name_Cache.Forget(id);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -157,6 +169,8 @@ Uint32 GetCustomWeaponNamePoolSize()
 void ClearCustomWeaponNamePool()
 {
 	CS_Custom_Weapon_Names.clear();
+    // The script strings of the custom names are no longer valid
+    CS_Weapon_Name_Cache.Clear();
 }
 
 // ------------------------------------------------------------------------------------------------
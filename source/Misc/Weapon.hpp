@@ -17,6 +17,11 @@ Uint32 GetWeaponSlot(Uint32 id);
 */
 CSStr GetWeaponName(Uint32 id);
 
+/* ------------------------------------------------------------------------------------------------
+ * Retrieve the name associated with a weapon identifier as a script string.
+*/
+const LightObj & GetWeaponNameObj(Uint32 id);
+
 /* ------------------------------------------------------------------------------------------------
  * Modify the name associated with a weapon identifier.
 */
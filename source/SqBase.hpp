@@ -421,6 +421,7 @@ enum EventType
     EVT_SERVEROPTION,
     EVT_SCRIPTRELOAD,
     EVT_SCRIPTLOADED,
+    EVT_SCRIPTRELOADED,
     EVT_MAX
 };
 